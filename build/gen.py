@@ -632,6 +632,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/action_values.cc',
         'src/gn/analyzer.cc',
         'src/gn/args.cc',
+        'src/gn/args_index.cc',
         'src/gn/binary_target_generator.cc',
         'src/gn/build_settings.cc',
         'src/gn/builder.cc',
@@ -672,6 +673,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/err.cc',
         'src/gn/escape.cc',
         'src/gn/exec_process.cc',
+        'src/gn/exec_script_runner.cc',
         'src/gn/filesystem_utils.cc',
         'src/gn/file_writer.cc',
         'src/gn/frameworks_utils.cc',
@@ -707,6 +709,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/json_project_writer.cc',
         'src/gn/label.cc',
         'src/gn/label_pattern.cc',
+        'src/gn/label_pattern_set.cc',
         'src/gn/lib_file.cc',
         'src/gn/loader.cc',
         'src/gn/location.cc',
@@ -730,6 +733,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/ninja_utils.cc',
         'src/gn/ninja_writer.cc',
         'src/gn/operators.cc',
+        'src/gn/output_manifest.cc',
         'src/gn/output_conversion.cc',
         'src/gn/output_file.cc',
         'src/gn/parse_node_value_adapter.cc',
@@ -739,6 +743,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/pattern.cc',
         'src/gn/pool.cc',
         'src/gn/qt_creator_writer.cc',
+        'src/gn/resolved_flag_sets.cc',
         'src/gn/resolved_target_data.cc',
         'src/gn/runtime_deps.cc',
         'src/gn/rust_substitution_type.cc',
@@ -751,9 +756,11 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/scope_per_file_provider.cc',
         'src/gn/settings.cc',
         'src/gn/setup.cc',
+        'src/gn/simple_json_writer.cc',
         'src/gn/source_dir.cc',
         'src/gn/source_file.cc',
         'src/gn/standard_out.cc',
+        'src/gn/streaming_file_writer.cc',
         'src/gn/string_atom.cc',
         'src/gn/string_output_buffer.cc',
         'src/gn/string_utils.cc',
@@ -767,6 +774,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/switches.cc',
         'src/gn/target.cc',
         'src/gn/target_generator.cc',
+        'src/gn/target_graph.cc',
         'src/gn/template.cc',
         'src/gn/token.cc',
         'src/gn/tokenizer.cc',
@@ -799,6 +807,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
       'gn_unittests': { 'sources': [
         'src/gn/action_target_generator_unittest.cc',
         'src/gn/analyzer_unittest.cc',
+        'src/gn/args_index_unittest.cc',
         'src/gn/args_unittest.cc',
         'src/gn/builder_record_map_unittest.cc',
         'src/gn/builder_unittest.cc',
@@ -811,6 +820,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/config_values_extractors_unittest.cc',
         'src/gn/escape_unittest.cc',
         'src/gn/exec_process_unittest.cc',
+        'src/gn/exec_script_runner_unittest.cc',
         'src/gn/filesystem_utils_unittest.cc',
         'src/gn/file_writer_unittest.cc',
         'src/gn/frameworks_utils_unittest.cc',
@@ -832,10 +842,12 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/functions_unittest.cc',
         'src/gn/hash_table_base_unittest.cc',
         'src/gn/header_checker_unittest.cc',
+        'src/gn/id_table_unittest.cc',
         'src/gn/input_conversion_unittest.cc',
         'src/gn/json_project_writer_unittest.cc',
         'src/gn/rust_project_writer_unittest.cc',
         'src/gn/rust_project_writer_helpers_unittest.cc',
+        'src/gn/label_pattern_set_unittest.cc',
         'src/gn/label_pattern_unittest.cc',
         'src/gn/label_unittest.cc',
         'src/gn/loader_unittest.cc',
@@ -856,25 +868,30 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/ninja_target_writer_unittest.cc',
         'src/gn/ninja_toolchain_writer_unittest.cc',
         'src/gn/operators_unittest.cc',
+        'src/gn/output_manifest_unittest.cc',
         'src/gn/output_conversion_unittest.cc',
         'src/gn/parse_tree_unittest.cc',
         'src/gn/parser_unittest.cc',
         'src/gn/path_output_unittest.cc',
         'src/gn/pattern_unittest.cc',
         'src/gn/pointer_set_unittest.cc',
+        'src/gn/resolved_flag_sets_unittest.cc',
         'src/gn/resolved_target_data_unittest.cc',
         'src/gn/resolved_target_deps_unittest.cc',
         'src/gn/runtime_deps_unittest.cc',
         'src/gn/scope_per_file_provider_unittest.cc',
         'src/gn/scope_unittest.cc',
         'src/gn/setup_unittest.cc',
+        'src/gn/simple_json_writer_unittest.cc',
         'src/gn/source_dir_unittest.cc',
         'src/gn/source_file_unittest.cc',
+        'src/gn/streaming_file_writer_unittest.cc',
         'src/gn/string_atom_unittest.cc',
         'src/gn/string_output_buffer_unittest.cc',
         'src/gn/string_utils_unittest.cc',
         'src/gn/substitution_pattern_unittest.cc',
         'src/gn/substitution_writer_unittest.cc',
+        'src/gn/target_graph_unittest.cc',
         'src/gn/target_public_pair_unittest.cc',
         'src/gn/target_unittest.cc',
         'src/gn/template_unittest.cc',
@@ -892,6 +909,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/xml_element_writer_unittest.cc',
         'src/util/atomic_write_unittest.cc',
         'src/util/test/gn_test.cc',
+        'src/util/worker_pool_unittest.cc',
       ], 'libs': []},
   }
 
@@ -118,19 +118,17 @@ bool EscapeJSONStringImpl(const S& str, bool put_in_quotes, std::string* dest) {
   // Most input strings are ASCII only and do not need UTF-8 parsing or
   // even escaping at all.
   if (IsAscii(str)) {
-    size_t escapes_size = 0;
-    for (auto ch : str)
-      escapes_size += ComputeAsciiEscapedSize(ch);
-
-    if (escapes_size == 0) {
-      dest->append(str.begin(), str.end());
-    } else {
-      dest->reserve(dest->size() + str.size() + escapes_size);
-      for (auto ch : str) {
-        if (!EscapeSpecialCodePoint(ch, dest))
-          dest->push_back(ch);
-      }
+    // Copy the runs of characters that need no escaping in one go.
+    auto run_begin = str.begin();
+    for (auto it = str.begin(); it != str.end(); ++it) {
+      if (ComputeAsciiEscapedSize(*it) == 0)
+        continue;
+      dest->append(run_begin, it);
+      if (!EscapeSpecialCodePoint(*it, dest))
+        dest->push_back(*it);
+      run_begin = it + 1;
     }
+    dest->append(run_begin, str.end());
   } else {
     // Casting is necessary because ICU uses int32_t. Try and do so safely.
     CHECK_LE(str.length(),
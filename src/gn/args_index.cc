@@ -0,0 +1,293 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/args_index.h"
+
+#include <memory>
+#include <string_view>
+#include <utility>
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/values.h"
+#include "gn/filesystem_utils.h"
+#include "gn/input_file.h"
+#include "gn/input_file_manager.h"
+#include "gn/parse_tree.h"
+#include "gn/scheduler.h"
+#include "gn/tokenizer.h"
+#include "gn/vector_utils.h"
+#include "util/atomic_write.h"
+#include "util/exe_path.h"
+
+namespace {
+
+// Changing the format of the index must change this so that older indices are
+// ignored.
+const int kVersion = 1;
+
+bool DoesLineBeginWithComment(std::string_view line) {
+  // Skip whitespace.
+  size_t i = 0;
+  while (i < line.size() && base::IsAsciiWhitespace(line[i]))
+    i++;
+
+  return i < line.size() && line[i] == '#';
+}
+
+// Returns the offset of the beginning of the line identified by |offset|.
+size_t BackUpToLineBegin(const std::string& data, size_t offset) {
+  // Degenerate case of an empty line. Below we'll try to return the
+  // character after the newline, but that will be incorrect in this case.
+  if (offset == 0 || Tokenizer::IsNewline(data, offset))
+    return offset;
+
+  size_t cur = offset;
+  do {
+    cur--;
+    if (Tokenizer::IsNewline(data, cur))
+      return cur + 1;  // Want the first character *after* the newline.
+  } while (cur > 0);
+  return 0;
+}
+
+// Fills |origin| with the location where |value| was set and, if
+// |comment_lines| is not null, the comment before it.
+void GetContextForValue(const Value& value,
+                        ListedArg::Origin* origin,
+                        std::vector<std::string>* comment_lines) {
+  if (!value.origin())
+    return;
+  origin->is_set = true;
+
+  Location location = value.origin()->GetRange().begin();
+  const InputFile* file = location.file();
+  if (!file)
+    return;
+
+  origin->file = file->name().value();
+  origin->line = location.line_number();
+  if (!comment_lines)
+    return;
+
+  const std::string& data = file->contents();
+  size_t line_off =
+      Tokenizer::ByteOffsetOfNthLine(data, location.line_number());
+
+  while (line_off > 1) {
+    line_off -= 2;  // Back up to end of previous line.
+    size_t previous_line_offset = BackUpToLineBegin(data, line_off);
+
+    std::string_view line(&data[previous_line_offset],
+                          line_off - previous_line_offset + 1);
+    if (!DoesLineBeginWithComment(line))
+      break;
+
+    comment_lines->insert(comment_lines->begin(),
+                          std::string(line.substr(line.find('#') + 1)));
+    line_off = previous_line_offset;
+  }
+}
+
+// Returns the size and modification time of |file|, or "-" if it doesn't
+// exist.
+std::string GetFileState(const base::FilePath& file) {
+  base::File::Info info;
+  if (!base::GetFileInfo(file, &info))
+    return "-";
+  return base::NumberToString(static_cast<long long>(info.size)) + " " +
+         base::NumberToString(
+             static_cast<unsigned long long>(info.last_modified));
+}
+
+base::Value OriginToValue(const ListedArg::Origin& origin) {
+  base::Value result(base::Value::Type::LIST);
+  if (origin.is_set) {
+    result.GetList().emplace_back(origin.file);
+    result.GetList().emplace_back(origin.line);
+  }
+  return result;
+}
+
+bool OriginFromValue(const base::Value* value, ListedArg::Origin* origin) {
+  if (!value || !value->is_list())
+    return false;
+  const auto& list = value->GetList();
+  if (list.empty())
+    return true;
+  if (list.size() != 2 || !list[0].is_string() || !list[1].is_int())
+    return false;
+  origin->is_set = true;
+  origin->file = list[0].GetString();
+  origin->line = list[1].GetInt();
+  return true;
+}
+
+bool GetString(const base::Value& dict,
+               std::string_view key,
+               std::string* result) {
+  const base::Value* value = dict.FindKeyOfType(key, base::Value::Type::STRING);
+  if (!value)
+    return false;
+  *result = value->GetString();
+  return true;
+}
+
+bool ArgFromValue(const base::Value& value, ListedArg* arg) {
+  if (!value.is_dict() || !GetString(value, "name", &arg->name) ||
+      !GetString(value, "default", &arg->default_value) ||
+      !OriginFromValue(value.FindKey("default_origin"), &arg->default_origin))
+    return false;
+
+  const base::Value* comment =
+      value.FindKeyOfType("comment", base::Value::Type::LIST);
+  if (!comment)
+    return false;
+  for (const base::Value& line : comment->GetList()) {
+    if (!line.is_string())
+      return false;
+    arg->comment_lines.push_back(line.GetString());
+  }
+
+  if (value.FindKey("override")) {
+    arg->has_override = true;
+    if (!GetString(value, "override", &arg->override_value) ||
+        !OriginFromValue(value.FindKey("override_origin"),
+                         &arg->override_origin))
+      return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+const char ArgsIndex::kFileName[] = ".gn_args_index";
+
+// static
+std::vector<ListedArg> ArgsIndex::GetListedArgs(const Args& args) {
+  std::vector<ListedArg> result;
+  for (const auto& [name, value] : args.GetAllArguments()) {
+    ListedArg& arg = result.emplace_back();
+    arg.name = std::string(name);
+    arg.default_value = value.default_value.ToString(true);
+    GetContextForValue(value.default_value, &arg.default_origin,
+                       &arg.comment_lines);
+    if (value.has_override) {
+      arg.has_override = true;
+      arg.override_value = value.override_value.ToString(true);
+      GetContextForValue(value.override_value, &arg.override_origin, nullptr);
+    }
+  }
+  return result;
+}
+
+// static
+std::vector<base::FilePath> ArgsIndex::GetLoadInputs(
+    const base::FilePath& args_file) {
+  const InputFileManager* input_file_manager =
+      g_scheduler->input_file_manager();
+  std::vector<base::FilePath> other_files = g_scheduler->GetGenDependencies();
+
+  VectorSetSorter<base::FilePath> sorter(
+      input_file_manager->GetInputFileCount() + other_files.size() + 2);
+  input_file_manager->AddAllPhysicalInputFileNamesToVectorSetSorter(&sorter);
+  sorter.Add(other_files.begin(), other_files.end());
+  sorter.Add(args_file);
+
+  // The declarations of the built-in arguments depend on GN itself.
+  base::FilePath exe_path = GetExePath();
+  if (!exe_path.empty())
+    sorter.Add(exe_path);
+
+  return sorter.AsVector();
+}
+
+// static
+bool ArgsIndex::Save(const base::FilePath& index_file,
+                     const std::vector<base::FilePath>& inputs,
+                     const std::vector<ListedArg>& args) {
+  base::Value index(base::Value::Type::DICTIONARY);
+  index.SetKey("version", base::Value(kVersion));
+
+  // The state of the inputs is kept as "<size> <last modified>" strings since
+  // they don't fit in the integers of base::Value.
+  base::Value input_list(base::Value::Type::LIST);
+  for (const base::FilePath& input : inputs) {
+    base::Value entry(base::Value::Type::LIST);
+    entry.GetList().emplace_back(FilePathToUTF8(input));
+    entry.GetList().emplace_back(GetFileState(input));
+    input_list.GetList().push_back(std::move(entry));
+  }
+  index.SetKey("inputs", std::move(input_list));
+
+  base::Value arg_list(base::Value::Type::LIST);
+  for (const ListedArg& arg : args) {
+    base::Value dict(base::Value::Type::DICTIONARY);
+    dict.SetKey("name", base::Value(arg.name));
+    dict.SetKey("default", base::Value(arg.default_value));
+    dict.SetKey("default_origin", OriginToValue(arg.default_origin));
+    base::Value comment(base::Value::Type::LIST);
+    for (const std::string& line : arg.comment_lines)
+      comment.GetList().emplace_back(line);
+    dict.SetKey("comment", std::move(comment));
+    if (arg.has_override) {
+      dict.SetKey("override", base::Value(arg.override_value));
+      dict.SetKey("override_origin", OriginToValue(arg.override_origin));
+    }
+    arg_list.GetList().push_back(std::move(dict));
+  }
+  index.SetKey("args", std::move(arg_list));
+
+  std::string contents;
+  if (!base::JSONWriter::Write(index, &contents))
+    return false;
+  return util::WriteFileAtomically(index_file, contents.data(),
+                                   static_cast<int>(contents.size())) ==
+         static_cast<int>(contents.size());
+}
+
+// static
+bool ArgsIndex::Load(const base::FilePath& index_file,
+                     std::vector<ListedArg>* args) {
+  std::string contents;
+  if (!base::ReadFileToString(index_file, &contents))
+    return false;
+
+  std::unique_ptr<base::Value> index = base::JSONReader::Read(contents);
+  if (!index || !index->is_dict())
+    return false;
+  const base::Value* version =
+      index->FindKeyOfType("version", base::Value::Type::INTEGER);
+  if (!version || version->GetInt() != kVersion)
+    return false;
+
+  const base::Value* inputs =
+      index->FindKeyOfType("inputs", base::Value::Type::LIST);
+  if (!inputs)
+    return false;
+  for (const base::Value& input : inputs->GetList()) {
+    if (!input.is_list() || input.GetList().size() != 2 ||
+        !input.GetList()[0].is_string() || !input.GetList()[1].is_string())
+      return false;
+    if (GetFileState(UTF8ToFilePath(input.GetList()[0].GetString())) !=
+        input.GetList()[1].GetString())
+      return false;
+  }
+
+  const base::Value* arg_list =
+      index->FindKeyOfType("args", base::Value::Type::LIST);
+  if (!arg_list)
+    return false;
+  std::vector<ListedArg> result;
+  for (const base::Value& value : arg_list->GetList()) {
+    if (!ArgFromValue(value, &result.emplace_back()))
+      return false;
+  }
+  *args = std::move(result);
+  return true;
+}
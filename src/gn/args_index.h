@@ -0,0 +1,75 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_ARGS_INDEX_H_
+#define TOOLS_GN_ARGS_INDEX_H_
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "gn/args.h"
+
+// What "gn args --list" prints about one build argument. Unlike the Values in
+// Args, this doesn't refer to the input files so it can be persisted.
+struct ListedArg {
+  // Where a value was set.
+  struct Origin {
+    // False for values set internally by GN, which have no origin.
+    bool is_set = false;
+    std::string file;
+    int line = 0;
+  };
+
+  std::string name;
+
+  std::string default_value;
+  Origin default_origin;
+
+  // The lines of the comment before the declaration of the default value,
+  // without the text up to and including their '#'.
+  std::vector<std::string> comment_lines;
+
+  bool has_override = false;
+  std::string override_value;
+  Origin override_origin;
+};
+
+// Persists the arguments declared by a full load of the build, and the files
+// that load read, in the build directory.
+//
+// Listing the arguments requires loading every build file, since any of them
+// may declare some. The declarations only depend on the files read by the
+// load though, so as long as none of them changed since the arguments were
+// indexed, they can be listed from the index after only reading the dotfile
+// and the build arguments. Otherwise, the build is loaded again and the index
+// rewritten.
+class ArgsIndex {
+ public:
+  // Name of the index file in the root build directory.
+  static const char kFileName[];
+
+  // Returns the arguments declared in |args|, sorted by name.
+  static std::vector<ListedArg> GetListedArgs(const Args& args);
+
+  // Returns the files read by the current load: the files read by the input
+  // file manager and the other dependencies of the generation, which include
+  // the dotfile. |args_file| is always included, to notice if it is created
+  // later.
+  static std::vector<base::FilePath> GetLoadInputs(
+      const base::FilePath& args_file);
+
+  // Writes |args| and the current state of |inputs| to |index_file|.
+  static bool Save(const base::FilePath& index_file,
+                   const std::vector<base::FilePath>& inputs,
+                   const std::vector<ListedArg>& args);
+
+  // Reads the arguments written to |index_file| by Save(). Returns false if
+  // it is missing, unreadable, written by another version of GN, or if any of
+  // the inputs changed since it was written.
+  static bool Load(const base::FilePath& index_file,
+                   std::vector<ListedArg>* args);
+};
+
+#endif  // TOOLS_GN_ARGS_INDEX_H_
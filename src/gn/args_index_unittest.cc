@@ -0,0 +1,125 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/args_index.h"
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "gn/test_with_scope.h"
+#include "util/test/test.h"
+
+namespace {
+
+void ExpectSameArgs(const std::vector<ListedArg>& expected,
+                    const std::vector<ListedArg>& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    const ListedArg& a = expected[i];
+    const ListedArg& b = actual[i];
+    EXPECT_EQ(a.name, b.name);
+    EXPECT_EQ(a.default_value, b.default_value);
+    EXPECT_EQ(a.default_origin.is_set, b.default_origin.is_set);
+    EXPECT_EQ(a.default_origin.file, b.default_origin.file);
+    EXPECT_EQ(a.default_origin.line, b.default_origin.line);
+    EXPECT_EQ(a.comment_lines, b.comment_lines);
+    EXPECT_EQ(a.has_override, b.has_override);
+    EXPECT_EQ(a.override_value, b.override_value);
+    EXPECT_EQ(a.override_origin.is_set, b.override_origin.is_set);
+    EXPECT_EQ(a.override_origin.file, b.override_origin.file);
+    EXPECT_EQ(a.override_origin.line, b.override_origin.line);
+  }
+}
+
+bool WriteFile(const base::FilePath& file, const std::string& contents) {
+  return base::WriteFile(file, contents.data(),
+                         static_cast<int>(contents.size())) ==
+         static_cast<int>(contents.size());
+}
+
+}  // namespace
+
+TEST(ArgsIndex, GetListedArgs) {
+  TestWithScope setup;
+  Args& args = setup.build_settings()->build_args();
+  args.AddArgOverride("b", Value(nullptr, "over"));
+
+  TestParseInput input(
+      "declare_args() {\n"
+      "  # The first.\n"
+      "  #  Indented.\n"
+      "  a = 1\n"
+      "\n"
+      "  b = \"x\"\n"
+      "}\n");
+  ASSERT_FALSE(input.has_error());
+  Err err;
+  input.parsed()->Execute(setup.scope(), &err);
+  ASSERT_FALSE(err.has_error()) << err.message();
+
+  std::vector<ListedArg> listed = ArgsIndex::GetListedArgs(args);
+  ASSERT_EQ(2u, listed.size());
+
+  EXPECT_EQ("a", listed[0].name);
+  EXPECT_EQ("1", listed[0].default_value);
+  EXPECT_TRUE(listed[0].default_origin.is_set);
+  EXPECT_EQ("//test", listed[0].default_origin.file);
+  EXPECT_EQ(4, listed[0].default_origin.line);
+  std::vector<std::string> comment = {" The first.", "  Indented."};
+  EXPECT_EQ(comment, listed[0].comment_lines);
+  EXPECT_FALSE(listed[0].has_override);
+
+  EXPECT_EQ("b", listed[1].name);
+  EXPECT_EQ("\"x\"", listed[1].default_value);
+  EXPECT_EQ(6, listed[1].default_origin.line);
+  EXPECT_TRUE(listed[1].comment_lines.empty());
+  EXPECT_TRUE(listed[1].has_override);
+  EXPECT_EQ("\"over\"", listed[1].override_value);
+  EXPECT_FALSE(listed[1].override_origin.is_set);
+}
+
+TEST(ArgsIndex, SaveAndLoad) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath index_file = temp_dir.GetPath().AppendASCII("index");
+  base::FilePath build_file = temp_dir.GetPath().AppendASCII("BUILD.gn");
+  base::FilePath args_file = temp_dir.GetPath().AppendASCII("args.gn");
+  ASSERT_TRUE(WriteFile(build_file, "declare_args() {}\n"));
+  std::vector<base::FilePath> inputs = {build_file, args_file};
+
+  std::vector<ListedArg> args(2);
+  args[0].name = "a";
+  args[0].default_value = "[ \"x\", \"y\" ]";
+  args[0].default_origin.is_set = true;
+  args[0].default_origin.file = "//BUILD.gn";
+  args[0].default_origin.line = 3;
+  args[0].comment_lines = {" Some \"quoted\" text.", ""};
+  args[0].has_override = true;
+  args[0].override_value = "[]";
+  args[0].override_origin.is_set = true;
+  args[0].override_origin.file = "//out/args.gn";
+  args[0].override_origin.line = 1;
+  args[1].name = "target_os";
+  args[1].default_value = "\"\"";
+
+  ASSERT_TRUE(ArgsIndex::Save(index_file, inputs, args));
+  std::vector<ListedArg> loaded;
+  ASSERT_TRUE(ArgsIndex::Load(index_file, &loaded));
+  ExpectSameArgs(args, loaded);
+
+  // Changing an input makes the index stale.
+  ASSERT_TRUE(WriteFile(build_file, "declare_args() { a = 1 }\n"));
+  EXPECT_FALSE(ArgsIndex::Load(index_file, &loaded));
+
+  // So does creating a missing one.
+  ASSERT_TRUE(ArgsIndex::Save(index_file, inputs, args));
+  ASSERT_TRUE(ArgsIndex::Load(index_file, &loaded));
+  ASSERT_TRUE(WriteFile(args_file, "a = []\n"));
+  EXPECT_FALSE(ArgsIndex::Load(index_file, &loaded));
+
+  // Missing or invalid indices can't be used.
+  EXPECT_FALSE(ArgsIndex::Load(temp_dir.GetPath().AppendASCII("missing"),
+                               &loaded));
+  ASSERT_TRUE(WriteFile(index_file, "{\"version\": 1"));
+  EXPECT_FALSE(ArgsIndex::Load(index_file, &loaded));
+}
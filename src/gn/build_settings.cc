@@ -28,7 +28,7 @@ void BuildSettings::SetRootTargetLabel(const Label& r) {
 }
 
 void BuildSettings::SetRootPatterns(std::vector<LabelPattern>&& patterns) {
-  root_patterns_ = std::move(patterns);
+  root_patterns_ = LabelPatternSet(std::move(patterns));
 }
 
 void BuildSettings::SetRootPath(const base::FilePath& r) {
@@ -73,10 +73,10 @@ base::FilePath BuildSettings::GetFullPathSecondary(const std::string& path,
       .NormalizePathSeparatorsTo('/');
 }
 
-void BuildSettings::ItemDefined(std::unique_ptr<Item> item) const {
-  DCHECK(item);
-  if (item_defined_callback_)
-    item_defined_callback_(std::move(item));
+void BuildSettings::ItemsDefined(
+    std::vector<std::unique_ptr<Item>> items) const {
+  if (items_defined_callback_ && !items.empty())
+    items_defined_callback_(std::move(items));
 }
 
 const BuildSettings::PrintCallback BuildSettings::swap_print_callback(
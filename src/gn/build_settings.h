@@ -10,11 +10,13 @@
 #include <memory>
 #include <set>
 #include <utility>
+#include <vector>
 
 #include "base/files/file_path.h"
 #include "gn/args.h"
 #include "gn/label.h"
 #include "gn/label_pattern.h"
+#include "gn/label_pattern_set.h"
 #include "gn/scope.h"
 #include "gn/source_dir.h"
 #include "gn/source_file.h"
@@ -26,7 +28,8 @@ class Item;
 // may be multiple Settings objects that refer to this, one for each toolchain.
 class BuildSettings {
  public:
-  using ItemDefinedCallback = std::function<void(std::unique_ptr<Item>)>;
+  using ItemsDefinedCallback =
+      std::function<void(std::vector<std::unique_ptr<Item>>)>;
   using PrintCallback = std::function<void(const std::string&)>;
 
   BuildSettings();
@@ -38,8 +41,9 @@ class BuildSettings {
 
   // Root target label patterns.
   const std::vector<LabelPattern>& root_patterns() const {
-    return root_patterns_;
+    return root_patterns_.patterns();
   }
+  const LabelPatternSet& root_pattern_set() const { return root_patterns_; }
   void SetRootPatterns(std::vector<LabelPattern>&& root_patterns);
 
   // Absolute path of the source root on the local system. Everything is
@@ -77,6 +81,14 @@ class BuildSettings {
     no_stamp_files_ = no_stamp_files;
   }
 
+  // The 'shared_ninja_flags' boolean flag can be set to write each distinct
+  // set of compiler flags once per toolchain as a Ninja variable, which the
+  // target .ninja files then refer to.
+  bool shared_ninja_flags() const { return shared_ninja_flags_; }
+  void set_shared_ninja_flags(bool shared_ninja_flags) {
+    shared_ninja_flags_ = shared_ninja_flags;
+  }
+
   const SourceFile& build_config_file() const { return build_config_file_; }
   void set_build_config_file(const SourceFile& f) { build_config_file_ = f; }
 
@@ -118,10 +130,10 @@ class BuildSettings {
   base::FilePath GetFullPathSecondary(const std::string& path,
                                       bool as_file) const;
 
-  // Called when an item is defined from a background thread.
-  void ItemDefined(std::unique_ptr<Item> item) const;
-  void set_item_defined_callback(ItemDefinedCallback cb) {
-    item_defined_callback_ = cb;
+  // Called from a background thread with the items defined by a file.
+  void ItemsDefined(std::vector<std::unique_ptr<Item>> items) const;
+  void set_items_defined_callback(ItemsDefinedCallback cb) {
+    items_defined_callback_ = cb;
   }
 
   // Defines a callback that will be used to override the behavior of the
@@ -143,7 +155,7 @@ class BuildSettings {
 
  private:
   Label root_target_label_;
-  std::vector<LabelPattern> root_patterns_;
+  LabelPatternSet root_patterns_;
   base::FilePath dotfile_name_;
   base::FilePath root_path_;
   std::string root_path_utf8_;
@@ -153,13 +165,14 @@ class BuildSettings {
   // See 40045b9 for the reason behind using 1.7.2 as the default version.
   Version ninja_required_version_{1, 7, 2};
   bool no_stamp_files_ = true;
+  bool shared_ninja_flags_ = false;
 
   SourceFile build_config_file_;
   SourceFile arg_file_template_path_;
   SourceDir build_dir_;
   Args build_args_;
 
-  ItemDefinedCallback item_defined_callback_;
+  ItemsDefinedCallback items_defined_callback_;
   PrintCallback print_callback_;
 
   std::unique_ptr<SourceFileSet> exec_script_whitelist_;
@@ -55,7 +55,9 @@ bool RecursiveFindCycle(const BuilderRecord* search_in,
 
 }  // namespace
 
-Builder::Builder(Loader* loader) : loader_(loader) {}
+Builder::Builder(Loader* loader)
+    : loader_(loader),
+      assert_no_deps_cache_(std::make_unique<AssertNoDepsCache>()) {}
 
 Builder::~Builder() = default;
 
@@ -117,6 +119,14 @@ void Builder::ItemDefined(std::unique_ptr<Item> item) {
   }
 }
 
+void Builder::ItemsDefined(std::vector<std::unique_ptr<Item>> items) {
+  // Each item gets a record, unless one was already created when it was
+  // referenced by an item defined earlier.
+  records_.reserve(records_.size() + items.size());
+  for (auto& item : items)
+    ItemDefined(std::move(item));
+}
+
 const Item* Builder::GetItem(const Label& label) const {
   const BuilderRecord* record = GetRecord(label);
   if (!record)
@@ -519,7 +529,11 @@ bool Builder::ResolveItem(BuilderRecord* record, Err* err) {
 
   record->set_resolved(true);
 
-  if (!record->item()->OnResolved(err))
+  bool resolved = record->type() == BuilderRecord::ITEM_TARGET
+                      ? record->item()->AsTarget()->OnResolved(
+                            assert_no_deps_cache_.get(), err)
+                      : record->item()->OnResolved(err);
+  if (!resolved)
     return false;
   if (record->should_generate() && resolved_and_generated_callback_)
     resolved_and_generated_callback_(record);
@@ -8,6 +8,7 @@
 #include <functional>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "gn/builder_record.h"
 #include "gn/builder_record_map.h"
@@ -16,6 +17,7 @@
 #include "gn/unique_vector.h"
 
 class ActionValues;
+class AssertNoDepsCache;
 class Err;
 class Loader;
 class ParseNode;
@@ -40,6 +42,10 @@ class Builder {
 
   void ItemDefined(std::unique_ptr<Item> item);
 
+  // Same as calling ItemDefined() for each item in order. Used for all the
+  // items defined by a build file, which are passed to the builder at once.
+  void ItemsDefined(std::vector<std::unique_ptr<Item>> items);
+
   // Returns NULL if there is not a thing with the corresponding label.
   const Item* GetItem(const Label& label) const;
   const Toolchain* GetToolchain(const Label& label) const;
@@ -144,6 +150,9 @@ class Builder {
 
   ResolvedGeneratedCallback resolved_and_generated_callback_;
 
+  // Shared by the targets resolved by this builder.
+  std::unique_ptr<AssertNoDepsCache> assert_no_deps_cache_;
+
   Builder(const Builder&) = delete;
   Builder& operator=(const Builder&) = delete;
 };
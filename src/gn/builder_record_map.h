@@ -57,6 +57,10 @@ class BuilderRecordMap : public HashTableBase<BuilderRecordNode> {
     return {true, record};
   }
 
+  // Make room for |count| records, to avoid resizing the table several
+  // times when many records are created at once.
+  void reserve(size_t count) { NodeReserve(count); }
+
   // Iteration support
   struct const_iterator : public NodeIterator {
     const BuilderRecord& operator*() const { return *node_->record; }
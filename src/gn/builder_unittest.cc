@@ -186,6 +186,33 @@ TEST_F(BuilderTest, BasicDeps) {
   EXPECT_TRUE(c_record->waiting_on_resolution().empty());
 }
 
+// The items of a file are defined at once, in order, and may depend on each
+// other.
+TEST_F(BuilderTest, ItemsDefined) {
+  SourceDir toolchain_dir = settings_.toolchain_label().dir();
+  std::string toolchain_name = settings_.toolchain_label().name();
+  DefineToolchain();
+
+  Label a_label(SourceDir("//a/"), "a", toolchain_dir, toolchain_name);
+  Label b_label(SourceDir("//a/"), "b", toolchain_dir, toolchain_name);
+
+  std::vector<std::unique_ptr<Item>> items;
+  auto a = std::make_unique<Target>(&settings_, a_label);
+  a->public_deps().push_back(LabelTargetPair(b_label));
+  a->set_output_type(Target::EXECUTABLE);
+  items.push_back(std::move(a));
+  auto b = std::make_unique<Target>(&settings_, b_label);
+  b->set_output_type(Target::STATIC_LIBRARY);
+  items.push_back(std::move(b));
+  builder_.ItemsDefined(std::move(items));
+
+  // Only the file of A and B is requested (again), which the loader ignores.
+  EXPECT_TRUE(loader_->HasLoadedOne(SourceFile("//a/BUILD.gn")));
+  EXPECT_TRUE(builder_.GetRecord(a_label)->resolved());
+  EXPECT_TRUE(builder_.GetRecord(b_label)->resolved());
+  EXPECT_EQ(3u, builder_.GetAllRecords().size());
+}
+
 TEST_F(BuilderTest, SortedUnresolvedDeps) {
   SourceDir toolchain_dir = settings_.toolchain_label().dir();
   std::string toolchain_name = settings_.toolchain_label().name();
@@ -7,7 +7,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
 #include <map>
+#include <utility>
+#include <vector>
 
 #include "base/command_line.h"
 #include "base/environment.h"
@@ -15,13 +18,12 @@
 #include "base/json/json_writer.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "gn/args_index.h"
 #include "gn/commands.h"
 #include "gn/filesystem_utils.h"
-#include "gn/input_file.h"
-#include "gn/parse_tree.h"
 #include "gn/setup.h"
 #include "gn/standard_out.h"
-#include "gn/tokenizer.h"
+#include "gn/switches.h"
 #include "gn/trace.h"
 #include "util/build_config.h"
 
@@ -40,78 +42,28 @@ const char kSwitchShort[] = "short";
 const char kSwitchOverridesOnly[] = "overrides-only";
 const char kSwitchJson[] = "json";
 
-bool DoesLineBeginWithComment(std::string_view line) {
-  // Skip whitespace.
-  size_t i = 0;
-  while (i < line.size() && base::IsAsciiWhitespace(line[i]))
-    i++;
-
-  return i < line.size() && line[i] == '#';
-}
-
-// Returns the offset of the beginning of the line identified by |offset|.
-size_t BackUpToLineBegin(const std::string& data, size_t offset) {
-  // Degenerate case of an empty line. Below we'll try to return the
-  // character after the newline, but that will be incorrect in this case.
-  if (offset == 0 || Tokenizer::IsNewline(data, offset))
-    return offset;
-
-  size_t cur = offset;
-  do {
-    cur--;
-    if (Tokenizer::IsNewline(data, cur))
-      return cur + 1;  // Want the first character *after* the newline.
-  } while (cur > 0);
-  return 0;
-}
-
-// Assumes DoesLineBeginWithComment(), this strips the # character from the
-// beginning and normalizes preceding whitespace.
-std::string StripHashFromLine(std::string_view line, bool pad) {
-  // Replace the # sign and everything before it with 3 spaces, so that a
-  // normal comment that has a space after the # will be indented 4 spaces
-  // (which makes our formatting come out nicely). If the comment is indented
-  // from there, we want to preserve that indenting.
-  std::string line_stripped(line.substr(line.find('#') + 1));
-  if (pad)
-    return "   " + line_stripped;
-
-  // If not padding, strip the leading space if present.
-  if (!line_stripped.empty() && line_stripped[0] == ' ')
-    return line_stripped.substr(1);
-  return line_stripped;
+// Returns the comment made of |lines| (see ListedArg::comment_lines). The #
+// character of each line is replaced by 3 spaces if |pad| is set, so that a
+// normal comment that has a space after the # will be indented 4 spaces (which
+// makes our formatting come out nicely). If the comment is indented from
+// there, we want to preserve that indenting. If not padding, the leading space
+// is stripped if present.
+std::string GetComment(const std::vector<std::string>& lines, bool pad) {
+  std::string comment;
+  for (const std::string& line : lines) {
+    if (pad)
+      comment.append("   ");
+    if (!pad && !line.empty() && line[0] == ' ')
+      comment.append(line, 1);
+    else
+      comment.append(line);
+    comment.push_back('\n');
+  }
+  return comment;
 }
 
-// Tries to find the comment before the setting of the given value.
-void GetContextForValue(const Value& value,
-                        std::string* location_str,
-                        int* line_no,
-                        std::string* comment,
-                        bool pad_comment = true) {
-  Location location = value.origin()->GetRange().begin();
-  const InputFile* file = location.file();
-  if (!file)
-    return;
-
-  *location_str = file->name().value();
-  *line_no = location.line_number();
-
-  const std::string& data = file->contents();
-  size_t line_off =
-      Tokenizer::ByteOffsetOfNthLine(data, location.line_number());
-
-  while (line_off > 1) {
-    line_off -= 2;  // Back up to end of previous line.
-    size_t previous_line_offset = BackUpToLineBegin(data, line_off);
-
-    std::string_view line(&data[previous_line_offset],
-                          line_off - previous_line_offset + 1);
-    if (!DoesLineBeginWithComment(line))
-      break;
-
-    comment->insert(0, StripHashFromLine(line, pad_comment) + "\n");
-    line_off = previous_line_offset;
-  }
+std::string OriginToString(const ListedArg::Origin& origin) {
+  return origin.file + ":" + base::IntToString(origin.line);
 }
 
 // Prints the value and origin for a default value. Default values always list
@@ -120,102 +72,109 @@ void GetContextForValue(const Value& value,
 // is a bit different.
 //
 // The default value also contains the docstring.
-void PrintDefaultValueInfo(std::string_view name, const Value& value) {
-  OutputString(value.ToString(true) + "\n");
-  if (value.origin()) {
-    int line_no;
-    std::string location, comment;
-    GetContextForValue(value, &location, &line_no, &comment);
-    OutputString("      From " + location + ":" + base::IntToString(line_no) +
-                 "\n");
-    if (!comment.empty())
-      OutputString("\n" + comment);
+void PrintDefaultValueInfo(const ListedArg& arg) {
+  OutputString(arg.default_value + "\n");
+  if (arg.default_origin.is_set) {
+    OutputString("      From " + OriginToString(arg.default_origin) + "\n");
+    if (!arg.comment_lines.empty())
+      OutputString("\n" + GetComment(arg.comment_lines, true));
   } else {
-    OutputString("      (Internally set; try `gn help " + std::string(name) +
-                 "`.)\n");
+    OutputString("      (Internally set; try `gn help " + arg.name + "`.)\n");
   }
 }
 
-// Override value is null if there is no override.
-void PrintArgHelp(std::string_view name, const Args::ValueWithOverride& val) {
-  OutputString(std::string(name), DECORATION_YELLOW);
+void PrintArgHelp(const ListedArg& arg) {
+  OutputString(arg.name, DECORATION_YELLOW);
   OutputString("\n");
 
-  if (val.has_override) {
+  if (arg.has_override) {
     // Override present, print both it and the default.
-    OutputString("    Current value = " + val.override_value.ToString(true) +
-                 "\n");
-    if (val.override_value.origin()) {
-      int line_no;
-      std::string location, comment;
-      GetContextForValue(val.override_value, &location, &line_no, &comment);
-      OutputString("      From " + location + ":" + base::IntToString(line_no) +
+    OutputString("    Current value = " + arg.override_value + "\n");
+    if (arg.override_origin.is_set) {
+      OutputString("      From " + OriginToString(arg.override_origin) +
                    "\n");
     }
     OutputString("    Overridden from the default = ");
-    PrintDefaultValueInfo(name, val.default_value);
+    PrintDefaultValueInfo(arg);
   } else {
     // No override.
     OutputString("    Current value (from the default) = ");
-    PrintDefaultValueInfo(name, val.default_value);
+    PrintDefaultValueInfo(arg);
   }
 }
 
-void BuildArgJson(base::Value& dict,
-                  std::string_view name,
-                  const Args::ValueWithOverride& arg,
-                  bool short_only) {
+void BuildArgJson(base::Value& dict, const ListedArg& arg, bool short_only) {
   assert(dict.is_dict());
 
   // Fetch argument name.
-  dict.SetKey("name", base::Value(name));
+  dict.SetKey("name", base::Value(arg.name));
 
   // Fetch overridden value information (if present).
   if (arg.has_override) {
     base::DictionaryValue override_dict;
-    override_dict.SetKey("value",
-                         base::Value(arg.override_value.ToString(true)));
-    if (arg.override_value.origin() && !short_only) {
-      int line_no;
-      std::string location, comment;
-      GetContextForValue(arg.override_value, &location, &line_no, &comment,
-                         /*pad_comment=*/false);
-      override_dict.SetKey("file", base::Value(location));
-      override_dict.SetKey("line", base::Value(line_no));
+    override_dict.SetKey("value", base::Value(arg.override_value));
+    if (arg.override_origin.is_set && !short_only) {
+      override_dict.SetKey("file", base::Value(arg.override_origin.file));
+      override_dict.SetKey("line", base::Value(arg.override_origin.line));
     }
     dict.SetKey("current", std::move(override_dict));
   }
 
   // Fetch default value information, and comment (if present).
   base::DictionaryValue default_dict;
-  std::string comment;
-  default_dict.SetKey("value", base::Value(arg.default_value.ToString(true)));
-  if (arg.default_value.origin() && !short_only) {
-    int line_no;
-    std::string location;
-    GetContextForValue(arg.default_value, &location, &line_no, &comment,
-                       /*pad_comment=*/false);
-    default_dict.SetKey("file", base::Value(location));
-    default_dict.SetKey("line", base::Value(line_no));
+  default_dict.SetKey("value", base::Value(arg.default_value));
+  if (arg.default_origin.is_set && !short_only) {
+    default_dict.SetKey("file", base::Value(arg.default_origin.file));
+    default_dict.SetKey("line", base::Value(arg.default_origin.line));
   }
   dict.SetKey("default", std::move(default_dict));
-  if (!comment.empty() && !short_only)
-    dict.SetKey("comment", base::Value(comment));
+  if (!arg.comment_lines.empty() && !short_only)
+    dict.SetKey("comment", base::Value(GetComment(arg.comment_lines, false)));
 }
 
-int ListArgs(const std::string& build_dir) {
+// Returns the arguments of the build in |build_dir|, from the index if it is
+// up to date, otherwise by loading the build and updating the index.
+bool GetListedArgs(const std::string& build_dir, std::vector<ListedArg>* args) {
   // Deliberately leaked to avoid expensive process teardown.
   Setup* setup = new Setup;
-  if (!setup->DoSetup(build_dir, false) || !setup->Run())
+  if (!setup->DoSetup(build_dir, false))
+    return false;
+
+  // Arguments given with --args replace the ones of the build directory, so
+  // the index doesn't apply.
+  const base::CommandLine* cmdline = base::CommandLine::ForCurrentProcess();
+  bool use_index = !cmdline->HasSwitch(switches::kArgs);
+  const BuildSettings& build_settings = setup->build_settings();
+  base::FilePath index_file = build_settings.GetFullPath(
+      SourceFile(build_settings.build_dir().value() + ArgsIndex::kFileName));
+  if (use_index && ArgsIndex::Load(index_file, args))
+    return true;
+
+  if (!setup->Run())
+    return false;
+  *args = ArgsIndex::GetListedArgs(build_settings.build_args());
+  if (use_index) {
+    // Failing to write the index only makes the next listing slower.
+    ArgsIndex::Save(index_file,
+                    ArgsIndex::GetLoadInputs(
+                        build_settings.GetFullPath(setup->GetBuildArgFile())),
+                    *args);
+  }
+  return true;
+}
+
+int ListArgs(const std::string& build_dir) {
+  std::vector<ListedArg> args;
+  if (!GetListedArgs(build_dir, &args))
     return 1;
 
-  Args::ValueWithOverrideMap args =
-      setup->build_settings().build_args().GetAllArguments();
   std::string list_value =
       base::CommandLine::ForCurrentProcess()->GetSwitchValueString(kSwitchList);
   if (!list_value.empty()) {
     // List just the one specified as the parameter to --list.
-    auto found = args.find(list_value);
+    auto found = std::find_if(
+        args.begin(), args.end(),
+        [&list_value](const ListedArg& arg) { return arg.name == list_value; });
     if (found == args.end()) {
       Err(Location(), "Unknown build argument.",
           "You asked for \"" + list_value +
@@ -225,10 +184,10 @@ int ListArgs(const std::string& build_dir) {
       return 1;
     }
 
-    // Delete everything from the map except the one requested.
-    Args::ValueWithOverrideMap::value_type preserved = *found;
+    // Delete everything from the list except the one requested.
+    ListedArg preserved = std::move(*found);
     args.clear();
-    args.insert(preserved);
+    args.push_back(std::move(preserved));
   }
 
   // Cache this to avoid looking it up for each |arg| in the loops below.
@@ -241,10 +200,10 @@ int ListArgs(const std::string& build_dir) {
     // Convert all args to JSON, serialize and print them
     auto list = std::make_unique<base::ListValue>();
     for (const auto& arg : args) {
-      if (overrides_only && !arg.second.has_override)
+      if (overrides_only && !arg.has_override)
         continue;
       list->GetList().emplace_back(base::DictionaryValue());
-      BuildArgJson(list->GetList().back(), arg.first, arg.second, short_only);
+      BuildArgJson(list->GetList().back(), arg, short_only);
     }
     std::string s;
     base::JSONWriter::WriteWithOptions(
@@ -256,14 +215,14 @@ int ListArgs(const std::string& build_dir) {
   if (short_only) {
     // Short <key>=<current_value> output.
     for (const auto& arg : args) {
-      if (overrides_only && !arg.second.has_override)
+      if (overrides_only && !arg.has_override)
         continue;
-      OutputString(std::string(arg.first));
+      OutputString(arg.name);
       OutputString(" = ");
-      if (arg.second.has_override)
-        OutputString(arg.second.override_value.ToString(true));
+      if (arg.has_override)
+        OutputString(arg.override_value);
       else
-        OutputString(arg.second.default_value.ToString(true));
+        OutputString(arg.default_value);
       OutputString("\n");
     }
     return 0;
@@ -271,9 +230,9 @@ int ListArgs(const std::string& build_dir) {
 
   // Long output.
   for (const auto& arg : args) {
-    if (overrides_only && !arg.second.has_override)
+    if (overrides_only && !arg.has_override)
       continue;
-    PrintArgHelp(arg.first, arg.second);
+    PrintArgHelp(arg);
     OutputString("\n");
   }
 
@@ -450,6 +409,12 @@ Usage
       arguments that have been overridden (i.e. non-default arguments) will
       be printed. Overrides come from the <out_dir>/args.gn file and //.gn
 
+      Listing the arguments requires loading the whole build, after which
+      they are recorded in <out_dir>/.gn_args_index along with the files that
+      were read. Later listings use this index instead, as long as none of
+      these files changed (like Ninja does to decide whether to run "gn gen"
+      again) and --args is not given.
+
       If --json is specified, the output will be emitted in json format.
       JSON schema for output:
       [
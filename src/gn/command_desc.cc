@@ -8,6 +8,8 @@
 #include <memory>
 #include <set>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include "base/command_line.h"
 #include "base/json/json_writer.h"
@@ -18,7 +20,9 @@
 #include "gn/desc_builder.h"
 #include "gn/rust_variables.h"
 #include "gn/setup.h"
+#include "gn/simple_json_writer.h"
 #include "gn/standard_out.h"
+#include "gn/string_output_buffer.h"
 #include "gn/swift_variables.h"
 #include "gn/switches.h"
 #include "gn/target.h"
@@ -33,6 +37,9 @@ const char kBlame[] = "blame";
 const char kTree[] = "tree";
 const char kAll[] = "all";
 
+// Size of the JSON output buffered before writing it to stdout.
+constexpr size_t kJSONFlushSize = 1 << 20;
+
 void PrintDictValue(const base::Value* value,
                     int indentLevel,
                     bool use_first_indent) {
@@ -694,28 +701,58 @@ int RunDesc(const std::vector<std::string>& args) {
   }
 
   if (json) {
-    // Convert all targets/configs to JSON, serialize and print them
-    auto res = std::make_unique<base::DictionaryValue>();
+    // Convert all targets/configs to JSON, serialize and print them. Each
+    // description is serialized as soon as it is built, in the order of the
+    // keys of the dictionary base::JSONWriter would have written, so the
+    // descriptions and their output never all exist at once.
+    std::vector<std::pair<std::string, const Item*>> items;
     if (!target_matches.empty()) {
       for (const auto* target : target_matches) {
-        res->SetWithoutPathExpansion(
-            target->label().GetUserVisibleName(
-                target->settings()->default_toolchain_label()),
-            DescBuilder::DescriptionForTarget(
-                target, what_to_print, cmdline->HasSwitch(kAll),
-                cmdline->HasSwitch(kTree), cmdline->HasSwitch(kBlame)));
+        items.emplace_back(target->label().GetUserVisibleName(
+                               target->settings()->default_toolchain_label()),
+                           target);
       }
     } else if (!config_matches.empty()) {
       for (const auto* config : config_matches) {
-        res->SetWithoutPathExpansion(
-            config->label().GetUserVisibleName(false),
-            DescBuilder::DescriptionForConfig(config, what_to_print));
+        items.emplace_back(config->label().GetUserVisibleName(false), config);
+      }
+    }
+    std::stable_sort(items.begin(), items.end(),
+                     [](const auto& a, const auto& b) {
+                       return a.first < b.first;
+                     });
+
+    StringOutputBuffer out;
+    {
+      SimpleJSONWriter json_writer(out);
+      std::string json_dict;
+      for (size_t i = 0; i < items.size(); i++) {
+        // Like a dictionary, keep the last item set for a key.
+        if (i + 1 < items.size() && items[i + 1].first == items[i].first)
+          continue;
+
+        const Item* item = items[i].second;
+        std::unique_ptr<base::DictionaryValue> description;
+        if (const Target* target = item->AsTarget()) {
+          description = DescBuilder::DescriptionForTarget(
+              target, what_to_print, cmdline->HasSwitch(kAll),
+              cmdline->HasSwitch(kTree), cmdline->HasSwitch(kBlame));
+        } else {
+          description = DescBuilder::DescriptionForConfig(item->AsConfig(),
+                                                          what_to_print);
+        }
+        base::JSONWriter::WriteWithOptions(
+            *description, base::JSONWriter::OPTIONS_PRETTY_PRINT, &json_dict);
+        json_writer.AddJSONDict(items[i].first, json_dict);
+
+        // Flush large outputs as they are produced.
+        if (out.size() >= kJSONFlushSize) {
+          OutputString(out.str());
+          out = StringOutputBuffer();
+        }
       }
     }
-    std::string s;
-    base::JSONWriter::WriteWithOptions(
-        *res.get(), base::JSONWriter::OPTIONS_PRETTY_PRINT, &s);
-    OutputString(s);
+    OutputString(out.str());
   } else {
     // Regular (non-json) formatted output
     bool multiple_outputs = (target_matches.size() + config_matches.size()) > 1;
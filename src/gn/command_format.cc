@@ -6,9 +6,13 @@
 
 #include <stddef.h>
 
+#include <algorithm>
+#include <memory>
 #include <sstream>
+#include <string_view>
 
 #include "base/command_line.h"
+#include "base/files/file_enumerator.h"
 #include "base/files/file_util.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
@@ -25,6 +29,7 @@
 #include "gn/switches.h"
 #include "gn/tokenizer.h"
 #include "util/build_config.h"
+#include "util/worker_pool.h"
 
 #if defined(OS_WIN)
 #include <fcntl.h>
@@ -47,6 +52,9 @@ const char kFormat_Help[] =
 
   Formats .gn file to a standard format.
 
+  Directories are searched recursively for .gn and .gni files to format.
+  Files are formatted in parallel.
+
   The contents of some lists ('sources', 'deps', etc.) will be sorted to a
   canonical order. To suppress this, you can add a comment of the form "#
   NOSORT" immediately preceding the assignment. e.g.
@@ -61,7 +69,8 @@ Arguments
 
   --dry-run
       Prints the list of files that would be reformatted but does not write
-      anything to disk. This is useful for presubmit/lint-type checks.
+      anything to disk. This is useful for presubmit/lint-type checks. The
+      formatting of a file stops at its first difference.
       - Exit code 0: successful format, matches on disk.
       - Exit code 1: general failure (parse error, etc.)
       - Exit code 2: successful format, but differs from on disk.
@@ -84,6 +93,7 @@ Examples
   gn format //some/BUILD.gn //some/other/BUILD.gn //and/another/BUILD.gn
   gn format some\\BUILD.gn
   gn format /abspath/some/BUILD.gn
+  gn format --dry-run //some/dir
   gn format --stdin
   gn format --read-tree=json //rewritten/BUILD.gn
 )";
@@ -123,7 +133,16 @@ class Printer {
 
   void Block(const ParseNode* file);
 
-  std::string String() const { return output_; }
+  const std::string& String() const { return output_; }
+
+  // Makes Block() stop as soon as the output can't be |expected| anymore, to
+  // check whether a file is formatted without formatting all of it. The
+  // output is incomplete when differs() is true.
+  void set_expected(std::string_view expected) {
+    expected_ = expected;
+    check_expected_ = true;
+  }
+  bool differs() const { return differs_; }
 
  private:
   // Format a list of values using the given style.
@@ -140,6 +159,10 @@ class Printer {
     bool multiline;
   };
 
+  // Compares the lines completed since the last call with |expected_|, and
+  // returns false if they differ.
+  bool CheckExpected();
+
   // Add to output.
   void Print(std::string_view str);
 
@@ -231,6 +254,12 @@ class Printer {
 
   std::string output_;           // Output buffer.
   std::vector<Token> comments_;  // Pending end-of-line comments.
+
+  // See set_expected().
+  std::string_view expected_;
+  bool check_expected_ = false;
+  bool differs_ = false;
+  size_t checked_size_ = 0;  // Size of the output that matches |expected_|.
   int margin() const { return stack_.back().margin; }
 
   int penalty_depth_;
@@ -288,6 +317,24 @@ Printer::Printer() : penalty_depth_(0) {
 
 Printer::~Printer() = default;
 
+bool Printer::CheckExpected() {
+  // Output is only ever appended, except for the trailing spaces of the
+  // current line, so everything up to the last newline is final.
+  size_t checked_size = output_.rfind('\n');
+  if (checked_size == std::string::npos)
+    return true;
+  checked_size++;
+  if (checked_size > expected_.size() ||
+      std::string_view(output_).substr(checked_size_,
+                                       checked_size - checked_size_) !=
+          expected_.substr(checked_size_, checked_size - checked_size_)) {
+    differs_ = true;
+    return false;
+  }
+  checked_size_ = checked_size;
+  return true;
+}
+
 void Printer::Print(std::string_view str) {
   output_.append(str);
 }
@@ -653,6 +700,8 @@ void Printer::Block(const ParseNode* root) {
 
   size_t i = 0;
   for (const auto& stmt : block->statements()) {
+    if (check_expected_ && !CheckExpected())
+      return;
     Expr(stmt.get(), kPrecedenceLowest, std::string());
     Newline();
     if (stmt->comments()) {
@@ -1255,6 +1304,124 @@ void DoFormat(const ParseNode* root,
   *output = pr.String();
 }
 
+// Returns true if formatting |root| gives |expected|.
+bool FormatMatches(const ParseNode* root, std::string_view expected) {
+  Printer pr;
+  pr.set_expected(expected);
+  pr.Block(root);
+  return !pr.differs() && pr.String() == expected;
+}
+
+// Tokenizes and parses |file| for formatting. Errors refer to |file|.
+std::unique_ptr<ParseNode> ParseForFormat(const InputFile& file,
+                                          std::vector<Token>* tokens,
+                                          Err* err) {
+  *tokens =
+      Tokenizer::Tokenize(&file, err, WhitespaceTransform::kInvalidToSpace);
+  if (err->has_error())
+    return nullptr;
+  return Parser::Parse(*tokens, err);
+}
+
+// A file to format for RunFormat(), and the results that are printed once all
+// files are done so that the output doesn't depend on the order in which the
+// worker threads finish.
+struct FormatJob {
+  std::string name;  // As listed by --dry-run.
+  base::FilePath path;
+
+  // Errors may point to |file|, which is kept until they're printed.
+  std::unique_ptr<InputFile> file;
+  Err err;
+
+  std::string dump_output;
+  bool differs = false;
+  bool wrote = false;
+};
+
+void RunFormatJob(FormatJob* job, TreeDumpMode dump_tree, bool dry_run) {
+  std::string original_contents;
+  if (!base::ReadFileToString(job->path, &original_contents)) {
+    job->err = Err(Location(),
+                   std::string("Couldn't read \"") + FilePathToUTF8(job->path));
+    return;
+  }
+
+  job->file = std::make_unique<InputFile>(SourceFile());
+  job->file->SetContents(original_contents);
+  std::vector<Token> tokens;
+  std::unique_ptr<ParseNode> root =
+      ParseForFormat(*job->file, &tokens, &job->err);
+  if (job->err.has_error())
+    return;
+
+  if (dump_tree != TreeDumpMode::kInactive) {
+    std::string output;
+    DoFormat(root.get(), dump_tree, &output, &job->dump_output);
+    return;
+  }
+  if (dry_run) {
+    job->differs = !FormatMatches(root.get(), original_contents);
+    return;
+  }
+
+  std::string output;
+  DoFormat(root.get(), dump_tree, &output, nullptr);
+  if (output == original_contents)
+    return;
+  // Update the file in-place.
+  if (base::WriteFile(job->path, output.data(),
+                      static_cast<int>(output.size())) == -1) {
+    job->err = Err(Location(),
+                   std::string("Failed to write formatted output back to \"") +
+                       FilePathToUTF8(job->path) + std::string("\"."));
+    return;
+  }
+  job->wrote = true;
+}
+
+// Adds the jobs for one command-line argument, which is either a file or a
+// directory whose .gn and .gni files are formatted.
+void AddFormatJobs(const BuildSettings& build_settings,
+                   const SourceDir& source_dir,
+                   const std::string& arg,
+                   std::vector<FormatJob>* jobs) {
+  Err err;
+  SourceDir dir = source_dir.ResolveRelativeDir(
+      Value(nullptr, arg), &err, build_settings.root_path_utf8());
+  base::FilePath dir_path;
+  if (!err.has_error())
+    dir_path = build_settings.GetFullPath(dir);
+  if (!dir_path.empty() && base::DirectoryExists(dir_path)) {
+    std::vector<base::FilePath> paths;
+    base::FileEnumerator traversal(dir_path, true,
+                                   base::FileEnumerator::FILES);
+    for (base::FilePath path = traversal.Next(); !path.empty();
+         path = traversal.Next()) {
+      base::FilePath::StringType extension = path.FinalExtension();
+      if (extension == FILE_PATH_LITERAL(".gn") ||
+          extension == FILE_PATH_LITERAL(".gni"))
+        paths.push_back(path);
+    }
+    std::sort(paths.begin(), paths.end());
+    for (base::FilePath& path : paths) {
+      FormatJob& job = jobs->emplace_back();
+      job.name = FilePathToUTF8(path);
+      job.path = std::move(path);
+    }
+    return;
+  }
+
+  FormatJob& job = jobs->emplace_back();
+  job.name = arg;
+  err = Err();
+  SourceFile file = source_dir.ResolveRelativeFile(Value(nullptr, arg), &err);
+  if (err.has_error())
+    job.err = err;
+  else
+    job.path = build_settings.GetFullPath(file);
+}
+
 }  // namespace
 
 bool FormatJsonToString(const std::string& json, std::string* output) {
@@ -1273,22 +1440,30 @@ bool FormatStringToString(const std::string& input,
   InputFile file(source_file);
   file.SetContents(input);
   Err err;
-  // Tokenize.
-  std::vector<Token> tokens =
-      Tokenizer::Tokenize(&file, &err, WhitespaceTransform::kInvalidToSpace);
+  std::vector<Token> tokens;
+  std::unique_ptr<ParseNode> parse_node = ParseForFormat(file, &tokens, &err);
   if (err.has_error()) {
     err.PrintToStdout();
     return false;
   }
 
-  // Parse.
-  std::unique_ptr<ParseNode> parse_node = Parser::Parse(tokens, &err);
+  DoFormat(parse_node.get(), dump_tree, output, dump_output);
+  return true;
+}
+
+bool IsStringFormatted(const std::string& input, bool* is_formatted) {
+  SourceFile source_file;
+  InputFile file(source_file);
+  file.SetContents(input);
+  Err err;
+  std::vector<Token> tokens;
+  std::unique_ptr<ParseNode> parse_node = ParseForFormat(file, &tokens, &err);
   if (err.has_error()) {
     err.PrintToStdout();
     return false;
   }
 
-  DoFormat(parse_node.get(), dump_tree, output, dump_output);
+  *is_formatted = FormatMatches(parse_node.get(), input);
   return true;
 }
 
@@ -1396,60 +1571,30 @@ int RunFormat(const std::vector<std::string>& args) {
     return 0;
   }
 
-  // TODO(scottmg): Eventually, this list of files should be processed in
-  // parallel.
-  int exit_code = 0;
-  for (const auto& arg : args) {
-    Err err;
-    SourceFile file = source_dir.ResolveRelativeFile(Value(nullptr, arg), &err);
-    if (err.has_error()) {
-      err.PrintToStdout();
-      exit_code = 1;
-      continue;
-    }
+  std::vector<FormatJob> jobs;
+  for (const auto& arg : args)
+    AddFormatJobs(setup.build_settings(), source_dir, arg, &jobs);
 
-    base::FilePath to_format = setup.build_settings().GetFullPath(file);
-    std::string original_contents;
-    if (!base::ReadFileToString(to_format, &original_contents)) {
-      Err(Location(),
-          std::string("Couldn't read \"") + FilePathToUTF8(to_format))
-          .PrintToStdout();
-      exit_code = 1;
-      continue;
-    }
+  WorkerPool::GetShared().ParallelFor(
+      jobs.size(), [&jobs, dump_tree, dry_run](size_t i) {
+        if (!jobs[i].err.has_error())
+          RunFormatJob(&jobs[i], dump_tree, dry_run);
+      });
 
-    std::string output_string;
-    std::string dump_output_string;
-    if (!FormatStringToString(original_contents, dump_tree, &output_string,
-                              &dump_output_string)) {
+  int exit_code = 0;
+  for (const FormatJob& job : jobs) {
+    if (job.err.has_error()) {
+      job.err.PrintToStdout();
       exit_code = 1;
       continue;
     }
-    printf("%s", dump_output_string.c_str());
-    if (dump_tree == TreeDumpMode::kInactive) {
-      if (dry_run) {
-        if (original_contents != output_string) {
-          printf("%s\n", arg.c_str());
-          exit_code = 2;
-        }
-        continue;
-      }
-      // Update the file in-place.
-      if (original_contents != output_string) {
-        if (base::WriteFile(to_format, output_string.data(),
-                            static_cast<int>(output_string.size())) == -1) {
-          Err(Location(),
-              std::string("Failed to write formatted output back to \"") +
-                  FilePathToUTF8(to_format) + std::string("\"."))
-              .PrintToStdout();
-          exit_code = 1;
-          continue;
-        }
-        if (!quiet) {
-          printf("Wrote formatted to '%s'.\n",
-                 FilePathToUTF8(to_format).c_str());
-        }
-      }
+    printf("%s", job.dump_output.c_str());
+    if (job.differs) {
+      printf("%s\n", job.name.c_str());
+      exit_code = 2;
+    }
+    if (job.wrote && !quiet) {
+      printf("Wrote formatted to '%s'.\n", FilePathToUTF8(job.path).c_str());
     }
   }
 
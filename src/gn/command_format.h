@@ -31,6 +31,11 @@ bool FormatStringToString(const std::string& input,
                           std::string* output,
                           std::string* dump_output);
 
+// Sets |is_formatted| to whether formatting |input| leaves it unchanged.
+// Formatting stops at the first difference. Returns false and prints the
+// error if |input| can't be parsed.
+bool IsStringFormatted(const std::string& input, bool* is_formatted);
+
 }  // namespace commands
 
 #endif  // TOOLS_GN_COMAND_FORMAT_H_
@@ -40,6 +40,13 @@ using FormatTest = TestWithScheduler;
     EXPECT_TRUE(commands::FormatStringToString(                             \
         out, commands::TreeDumpMode::kInactive, &out_again, nullptr));      \
     ASSERT_EQ(out, out_again);                                              \
+    /* Make sure checking for changes stops at the same answer. */          \
+    bool is_formatted = false;                                              \
+    EXPECT_TRUE(commands::IsStringFormatted(out, &is_formatted));           \
+    EXPECT_TRUE(is_formatted);                                              \
+    EXPECT_TRUE(commands::IsStringFormatted(input, &is_formatted));         \
+    bool unchanged = input == out;                                          \
+    EXPECT_EQ(unchanged, is_formatted);                                     \
     /* Make sure we can roundtrip to json without any changes. */           \
     std::string as_json;                                                    \
     std::string unused;                                                     \
@@ -23,7 +23,9 @@
 #include "gn/ninja_target_writer.h"
 #include "gn/ninja_tools.h"
 #include "gn/ninja_writer.h"
+#include "gn/output_manifest.h"
 #include "gn/qt_creator_writer.h"
+#include "gn/resolved_flag_sets.h"
 #include "gn/runtime_deps.h"
 #include "gn/rust_project_writer.h"
 #include "gn/scheduler.h"
@@ -73,6 +75,7 @@ const char kSwitchXcodeAdditionalFilesRoots[] = "xcode-additional-files-roots";
 const char kSwitchJsonFileName[] = "json-file-name";
 const char kSwitchJsonIdeScript[] = "json-ide-script";
 const char kSwitchJsonIdeScriptArgs[] = "json-ide-script-args";
+const char kSwitchJsonSplitByDir[] = "json-split-by-dir";
 const char kSwitchExportCompileCommands[] = "export-compile-commands";
 const char kSwitchExportRustProject[] = "export-rust-project";
 
@@ -92,6 +95,9 @@ struct TargetWriteInfo {
   using ResolvedMap = std::unordered_map<std::thread::id, ResolvedTargetData>;
   std::unique_ptr<ResolvedMap> resolved_map = std::make_unique<ResolvedMap>();
 
+  // Shared by the flag sets of |resolved_map|.
+  SharedFlagNames shared_flag_names;
+
   void LeakOnPurpose() { (void)resolved_map.release(); }
 };
 
@@ -104,7 +110,12 @@ void BackgroundDoWrite(TargetWriteInfo* write_info, const Target* target) {
 
   {
     std::lock_guard<std::mutex> lock(write_info->lock);
-    resolved = &((*write_info->resolved_map)[std::this_thread::get_id()]);
+    auto [found, inserted] =
+        write_info->resolved_map->try_emplace(std::this_thread::get_id());
+    resolved = &found->second;
+    if (inserted)
+      resolved->flag_sets().set_shared_flag_names(
+          &write_info->shared_flag_names);
   }
   std::string rule =
       NinjaTargetWriter::RunAndWriteFile(target, resolved, ninja_outputs);
@@ -354,10 +365,11 @@ bool RunIdeWriter(const std::string& ide,
     std::string exec_script_extra_args =
         command_line->GetSwitchValueString(kSwitchJsonIdeScriptArgs);
     std::string filters = command_line->GetSwitchValueString(kSwitchFilters);
+    bool split_by_dir = command_line->HasSwitch(kSwitchJsonSplitByDir);
 
     bool res = JSONProjectWriter::RunAndWriteFiles(
         build_settings, builder, file_name, exec_script, exec_script_extra_args,
-        filters, quiet, err);
+        filters, split_by_dir, quiet, err);
     if (res && !quiet) {
       OutputString("Generating JSON projects took " +
                    base::Int64ToString(timer.Elapsed().InMilliseconds()) +
@@ -379,8 +391,10 @@ bool RunRustProjectWriter(const BuildSettings* build_settings,
   base::ElapsedTimer timer;
 
   std::string file_name = "rust-project.json";
-  bool res = RustProjectWriter::RunAndWriteFiles(build_settings, builder,
-                                                 file_name, quiet, err);
+  std::string root_filters =
+      command_line->GetSwitchValueString(kSwitchExportRustProject);
+  bool res = RustProjectWriter::RunAndWriteFiles(
+      build_settings, builder, file_name, root_filters, quiet, err);
   if (res && !quiet) {
     OutputString("Generating rust-project.json took " +
                  base::Int64ToString(timer.Elapsed().InMilliseconds()) +
@@ -659,6 +673,15 @@ Generic JSON Output
   --json-ide-script-args=<argument>
       Optional second argument that will be passed to executed script.
 
+  --json-split-by-dir
+      Writes the descriptions of the targets of each directory to a separate
+      file instead. They are named <dir>/targets.json, in a directory named
+      after the JSON file with a ".d" suffix (targets of system-absolute
+      directories go to its "_absolute" subdirectory). The JSON file then has a
+      "target_files" dictionary mapping each directory to its file, relative to
+      the build directory, instead of "targets". Only the files whose contents
+      changed are written, and the other files of that directory are removed.
+
 Ninja Outputs
 
   The --ninja-outputs-file=<FILE> option dumps a JSON file that maps GN labels
@@ -687,12 +710,17 @@ Ninja Outputs
 
 Compilation Database
 
-  --export-rust-project
+  --export-rust-project[=<label_pattern1;label_pattern2...>]
       Produces a rust-project.json file in the root of the build directory
       This is used for various tools in the Rust ecosystem allowing for the
       replay of individual compilations independent of the build system.
       This is an unstable format and likely to change without warning.
 
+      When label patterns are given (see "gn help label_pattern"), only the
+      crates of the matching targets and of their transitive dependencies are
+      written, which keeps the file small for large Rust graphs. For example:
+        --export-rust-project="//my/app:*;//tools/foo:bar"
+
   --add-export-compile-commands=<label_pattern>
       Adds an additional label pattern (see "gn help label_pattern") of a
       target to add to the compilation database. This pattern is appended to any
@@ -764,6 +792,15 @@ int RunGen(const std::vector<std::string>& args) {
     }
   }
 
+  // Remember what is written so that the next run can skip unchanged files
+  // without reading them back. This must be in place before the load since
+  // target files are written while loading.
+  OutputManifest output_manifest(setup->build_settings().GetFullPath(
+      SourceFile(setup->build_settings().build_dir().value() +
+                 OutputManifest::kFileName)));
+  output_manifest.Load();
+  g_output_manifest = &output_manifest;
+
   // Cause the load to also generate the ninja files for each target.
   TargetWriteInfo write_info;
   write_info.want_ninja_outputs =
@@ -793,10 +830,27 @@ int RunGen(const std::vector<std::string>& args) {
               });
   }
 
+  // Merge the shared flag variables referenced by the targets written on each
+  // thread. The names are derived from the values so the threads agree on
+  // them, and a name that collides with another thread's is never used.
+  NinjaWriter::PerToolchainSharedFlags shared_flags;
+  if (setup->build_settings().shared_ninja_flags()) {
+    for (const auto& [thread_id, resolved] : *write_info.resolved_map) {
+      for (const auto& [toolchain, variables] :
+           resolved.flag_sets().shared_variables()) {
+        NinjaWriter::SharedFlags& merged = shared_flags[toolchain];
+        for (const auto& [name, value] : variables) {
+          auto [found, inserted] = merged.emplace(name, *value);
+          DCHECK(inserted || found->second == *value);
+        }
+      }
+    }
+  }
+
   Err err;
   // Write the root ninja files.
   if (!NinjaWriter::RunAndWriteFiles(&setup->build_settings(), setup->builder(),
-                                     write_info.rules, &err)) {
+                                     write_info.rules, shared_flags, &err)) {
     err.PrintToStdout();
     return 1;
   }
@@ -869,6 +923,18 @@ int RunGen(const std::vector<std::string>& args) {
     return 1;
   }
 
+  // Failing to save the manifest only means that the next run compares the
+  // file contents again, so it isn't an error.
+  output_manifest.Save();
+
+  if (command_line->HasSwitch(switches::kTime)) {
+    OutputManifest::Stats stats = output_manifest.GetStats();
+    OutputString(base::StringPrintf(
+        "Output files: %zu written (%zu bytes), %zu unchanged (%zu bytes)\n",
+        stats.files_written, stats.bytes_written, stats.files_skipped,
+        stats.bytes_skipped));
+  }
+
   TickDelta elapsed_time = timer.Elapsed();
 
   if (!command_line->HasSwitch(switches::kQuiet)) {
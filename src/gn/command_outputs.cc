@@ -102,11 +102,12 @@ int RunOutputs(const std::vector<std::string>& args) {
   std::vector<OutputFile> outputs;
 
   // Files. This must go first because it may add to the "targets" list.
-  std::vector<const Target*> all_targets =
-      setup->builder().GetAllResolvedTargets();
-  for (const SourceFile& file : file_matches) {
-    std::vector<TargetContainingFile> targets;
-    GetTargetsContainingFile(setup, all_targets, file, false, &targets);
+  std::vector<std::vector<TargetContainingFile>> targets_containing;
+  GetTargetsContainingFiles(setup, setup->GetTargetGraph().targets(),
+                            file_matches.vector(), false, &targets_containing);
+  for (size_t i = 0; i < file_matches.size(); i++) {
+    const SourceFile& file = file_matches[i];
+    const std::vector<TargetContainingFile>& targets = targets_containing[i];
     if (targets.empty()) {
       Err(Location(), base::StringPrintf("No targets reference the file '%s'.",
                                          file.value().c_str()))
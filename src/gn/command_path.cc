@@ -3,14 +3,17 @@
 // found in the LICENSE file.
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <algorithm>
 
 #include "base/command_line.h"
 #include "base/strings/stringprintf.h"
 #include "gn/commands.h"
+#include "gn/id_table.h"
 #include "gn/setup.h"
 #include "gn/standard_out.h"
+#include "gn/target_graph.h"
 
 namespace commands {
 
@@ -18,18 +21,17 @@ namespace {
 
 enum class DepType { NONE, PUBLIC, PRIVATE, DATA };
 
-// The dependency paths are stored in a vector. Assuming the chain:
+// The dependency paths are stored in a vector of target graph nodes. Assuming
+// the chain:
 //    A --[public]--> B --[private]--> C
 // The stack will look like:
 //    [0] = A, NONE (this has no dep type since nobody depends on it)
 //    [1] = B, PUBLIC
 //    [2] = C, PRIVATE
-using TargetDep = std::pair<const Target*, DepType>;
+using TargetDep = std::pair<uint32_t, DepType>;
 using PathVector = std::vector<TargetDep>;
 
 // How to search.
-enum class PrivateDeps { INCLUDE, EXCLUDE };
-enum class DataDeps { INCLUDE, EXCLUDE };
 enum class PrintWhat { ONE, ALL };
 
 struct Options {
@@ -41,7 +43,14 @@ struct Options {
   bool with_data;
 };
 
-using WorkQueue = std::list<PathVector>;
+// An entry of the work queue of BreadthFirstSearch(). Rather than copying the
+// whole path of each entry, entries store the last dependency of their path
+// and the index of the entry for the rest of the path.
+struct WorkItem {
+  TargetDep dep;
+  size_t previous;
+};
+constexpr size_t kNoWorkItem = static_cast<size_t>(-1);
 
 struct Stats {
   Stats() : public_paths(0), other_paths(0) {}
@@ -51,11 +60,32 @@ struct Stats {
   int public_paths;
   int other_paths;
 
-  // Stores targets that have a path to the destination, and whether that
-  // path is public, private, or data.
-  std::map<const Target*, DepType> found_paths;
+  // Stores the nodes that have a path to the destination, and whether that
+  // path is public, private, or data. NONE for the other nodes.
+  IdTable<DepType> found_paths;
 };
 
+DepType DepTypeForGraph(TargetGraph::DepType type) {
+  switch (type) {
+    case TargetGraph::DepType::PUBLIC:
+      return DepType::PUBLIC;
+    case TargetGraph::DepType::PRIVATE:
+      return DepType::PRIVATE;
+    case TargetGraph::DepType::DATA:
+      return DepType::DATA;
+  }
+  return DepType::NONE;
+}
+
+// Returns the path ending with the given work queue entry.
+PathVector GetPath(const std::vector<WorkItem>& work_queue, size_t index) {
+  PathVector path;
+  for (; index != kNoWorkItem; index = work_queue[index].previous)
+    path.push_back(work_queue[index].dep);
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
 // If the implicit_last_dep is not "none", this type indicates the
 // classification of the elided last part of path.
 DepType ClassifyPath(const PathVector& path, DepType implicit_last_dep) {
@@ -96,15 +126,20 @@ const char* StringForDepType(DepType type) {
 
 // Prints the given path. If the implicit_last_dep is not "none", the last
 // dependency will show an elided dependency with the given annotation.
-void PrintPath(const PathVector& path, DepType implicit_last_dep) {
+void PrintPath(const TargetGraph& graph,
+               const PathVector& path,
+               DepType implicit_last_dep) {
   if (path.empty())
     return;
 
   // Don't print toolchains unless they differ from the first target.
-  const Label& default_toolchain = path[0].first->label().GetToolchainLabel();
+  const Label& default_toolchain =
+      graph.target(path[0].first)->label().GetToolchainLabel();
 
   for (size_t i = 0; i < path.size(); i++) {
-    OutputString(path[i].first->label().GetUserVisibleName(default_toolchain));
+    OutputString(graph.target(path[i].first)
+                     ->label()
+                     .GetUserVisibleName(default_toolchain));
 
     // Output dependency type.
     if (i == path.size() - 1) {
@@ -151,8 +186,8 @@ void InsertTargetsIntoFoundPaths(const PathVector& path,
     // Don't overwrite an existing one. The algorithm works by first doing
     // public, then private, then data, so anything already there is guaranteed
     // at least as good as our addition.
-    if (stats->found_paths.find(pair.first) == stats->found_paths.end()) {
-      stats->found_paths.insert(std::make_pair(pair.first, type));
+    if (stats->found_paths.get(pair.first) == DepType::NONE) {
+      stats->found_paths[pair.first] = type;
       inserted = true;
     }
   }
@@ -166,31 +201,37 @@ void InsertTargetsIntoFoundPaths(const PathVector& path,
   }
 }
 
-void BreadthFirstSearch(const Target* from,
-                        const Target* to,
-                        PrivateDeps private_deps,
-                        DataDeps data_deps,
+void BreadthFirstSearch(const TargetGraph& graph,
+                        uint32_t from,
+                        uint32_t to,
+                        TargetGraph::DepType max_dep_type,
                         PrintWhat print_what,
                         Stats* stats) {
-  // Seed the initial stack with just the "from" target.
-  PathVector initial_stack;
-  initial_stack.emplace_back(from, DepType::NONE);
-  WorkQueue work_queue;
-  work_queue.push_back(initial_stack);
+  // Only the targets depending directly or indirectly on the "to" target can
+  // be on a path to it. Walking the reverse deps from it first to find them
+  // keeps the search from exploring all the other deps of the "from" target,
+  // which are most of the graph when it is a high level target.
+  IdBitSet reaching(graph.size());
+  reaching.add(to);
+  graph.CollectDependents({to}, max_dep_type, &reaching);
+  if (!reaching.contains(from))
+    return;
 
-  // Track checked targets to avoid checking the same once more than once.
-  TargetSet visited;
+  // Seed the initial queue with just the "from" target.
+  std::vector<WorkItem> work_queue;
+  work_queue.push_back({TargetDep(from, DepType::NONE), kNoWorkItem});
 
-  while (!work_queue.empty()) {
-    PathVector current_path = work_queue.front();
-    work_queue.pop_front();
+  // Track checked targets to avoid checking the same once more than once.
+  IdBitSet visited(graph.size());
 
-    const Target* current_target = current_path.back().first;
+  for (size_t current = 0; current < work_queue.size(); current++) {
+    uint32_t current_node = work_queue[current].dep.first;
 
-    if (current_target == to) {
+    if (current_node == to) {
       // Found a new path.
+      PathVector current_path = GetPath(work_queue, current);
       if (stats->total_paths() == 0 || print_what == PrintWhat::ALL)
-        PrintPath(current_path, DepType::NONE);
+        PrintPath(graph, current_path, DepType::NONE);
 
       // Insert all nodes on the path into the found paths list. Since we're
       // doing search breadth first, we know that the current path is the best
@@ -203,16 +244,15 @@ void BreadthFirstSearch(const Target* from,
       // Doing this here will mean that the output is sorted by length of items
       // printed (with the redundant parts of the path omitted) rather than
       // complete path length.
-      const auto& found_current_target =
-          stats->found_paths.find(current_target);
-      if (found_current_target != stats->found_paths.end()) {
+      DepType found_type = stats->found_paths.get(current_node);
+      if (found_type != DepType::NONE) {
+        PathVector current_path = GetPath(work_queue, current);
         if (stats->total_paths() == 0 || print_what == PrintWhat::ALL)
-          PrintPath(current_path, found_current_target->second);
+          PrintPath(graph, current_path, found_type);
 
         // Insert all nodes on the path into the found paths list since we know
         // everything along this path also leads to the destination.
-        InsertTargetsIntoFoundPaths(current_path, found_current_target->second,
-                                    stats);
+        InsertTargetsIntoFoundPaths(current_path, found_type, stats);
         continue;
       }
     }
@@ -220,46 +260,34 @@ void BreadthFirstSearch(const Target* from,
     // If we've already checked this one, stop. This should be after the above
     // check for a known-good check, because known-good ones will always have
     // been previously visited.
-    if (!visited.add(current_target))
+    if (!visited.add(current_node))
       continue;
 
-    // Add public deps for this target to the queue.
-    for (const auto& pair : current_target->public_deps()) {
-      work_queue.push_back(current_path);
-      work_queue.back().push_back(TargetDep(pair.ptr, DepType::PUBLIC));
-    }
-
-    if (private_deps == PrivateDeps::INCLUDE) {
-      // Add private deps.
-      for (const auto& pair : current_target->private_deps()) {
-        work_queue.push_back(current_path);
-        work_queue.back().push_back(TargetDep(pair.ptr, DepType::PRIVATE));
-      }
-    }
-
-    if (data_deps == DataDeps::INCLUDE) {
-      // Add data deps.
-      for (const auto& pair : current_target->data_deps()) {
-        work_queue.push_back(current_path);
-        work_queue.back().push_back(TargetDep(pair.ptr, DepType::DATA));
+    // Add the public, then private and data deps for this target to the
+    // queue, skipping the ones which can't lead to the destination.
+    for (const TargetGraph::Edge& dep : graph.deps(current_node)) {
+      if (dep.type <= max_dep_type && reaching.contains(dep.node)) {
+        work_queue.push_back(
+            {TargetDep(dep.node, DepTypeForGraph(dep.type)), current});
       }
     }
   }
 }
 
-void DoSearch(const Target* from,
-              const Target* to,
+void DoSearch(const TargetGraph& graph,
+              uint32_t from,
+              uint32_t to,
               const Options& options,
               Stats* stats) {
-  BreadthFirstSearch(from, to, PrivateDeps::EXCLUDE, DataDeps::EXCLUDE,
+  BreadthFirstSearch(graph, from, to, TargetGraph::DepType::PUBLIC,
                      options.print_what, stats);
   if (!options.public_only) {
     // Check private deps.
-    BreadthFirstSearch(from, to, PrivateDeps::INCLUDE, DataDeps::EXCLUDE,
+    BreadthFirstSearch(graph, from, to, TargetGraph::DepType::PRIVATE,
                        options.print_what, stats);
     if (options.with_data) {
       // Check data deps.
-      BreadthFirstSearch(from, to, PrivateDeps::INCLUDE, DataDeps::INCLUDE,
+      BreadthFirstSearch(graph, from, to, TargetGraph::DepType::DATA,
                          options.print_what, stats);
     }
   }
@@ -347,13 +375,21 @@ int RunPath(const std::vector<std::string>& args) {
     return 1;
   }
 
+  // Targets which are not generated are not in the graph, and have no paths
+  // to the ones which are.
+  const TargetGraph& graph = setup->GetTargetGraph();
+  uint32_t node1 = graph.GetNode(target1);
+  uint32_t node2 = graph.GetNode(target2);
+
   Stats stats;
-  DoSearch(target1, target2, options, &stats);
-  if (stats.total_paths() == 0) {
-    // If we don't find a path going "forwards", try the reverse direction.
-    // Deps can only go in one direction without having a cycle, which will
-    // have caused a run failure above.
-    DoSearch(target2, target1, options, &stats);
+  if (node1 != TargetGraph::kNoNode && node2 != TargetGraph::kNoNode) {
+    DoSearch(graph, node1, node2, options, &stats);
+    if (stats.total_paths() == 0) {
+      // If we don't find a path going "forwards", try the reverse direction.
+      // Deps can only go in one direction without having a cycle, which will
+      // have caused a run failure above.
+      DoSearch(graph, node2, node1, options, &stats);
+    }
   }
 
   // This string is inserted in the results to annotate whether the result
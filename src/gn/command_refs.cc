@@ -4,8 +4,7 @@
 
 #include <stddef.h>
 
-#include <map>
-#include <set>
+#include <vector>
 
 #include "base/command_line.h"
 #include "base/files/file_util.h"
@@ -15,35 +14,25 @@
 #include "gn/config_values_extractors.h"
 #include "gn/deps_iterator.h"
 #include "gn/filesystem_utils.h"
+#include "gn/id_table.h"
 #include "gn/input_file.h"
 #include "gn/item.h"
 #include "gn/setup.h"
 #include "gn/standard_out.h"
 #include "gn/switches.h"
 #include "gn/target.h"
+#include "gn/target_graph.h"
 
 namespace commands {
 
 namespace {
 
-using TargetSet = TargetSet;
-using TargetVector = std::vector<const Target*>;
-
-// Maps targets to the list of targets that depend on them.
-using DepMap = std::multimap<const Target*, const Target*>;
-
-// Populates the reverse dependency map for the targets in the Setup.
-void FillDepMap(Setup* setup, DepMap* dep_map) {
-  for (auto* target : setup->builder().GetAllResolvedTargets()) {
-    for (const auto& dep_pair : target->GetDeps(Target::DEPS_ALL))
-      dep_map->insert(std::make_pair(dep_pair.ptr, target));
-  }
-}
+using DepType = TargetGraph::DepType;
 
 // Forward declaration for function below.
-size_t RecursivePrintTargetDeps(const DepMap& dep_map,
+size_t RecursivePrintTargetDeps(const TargetGraph& graph,
                                 const Target* target,
-                                TargetSet* seen_targets,
+                                IdBitSet* seen_nodes,
                                 int indent_level);
 
 // Prints the target and its dependencies in tree form. If the set is non-null,
@@ -52,9 +41,9 @@ size_t RecursivePrintTargetDeps(const DepMap& dep_map,
 // printed.
 //
 // Returns the number of items printed.
-size_t RecursivePrintTarget(const DepMap& dep_map,
+size_t RecursivePrintTarget(const TargetGraph& graph,
                             const Target* target,
-                            TargetSet* seen_targets,
+                            IdBitSet* seen_nodes,
                             int indent_level) {
   std::string indent(indent_level * 2, ' ');
   size_t count = 1;
@@ -64,20 +53,21 @@ size_t RecursivePrintTarget(const DepMap& dep_map,
                             !target->settings()->is_default()));
 
   bool print_children = true;
-  if (seen_targets) {
-    if (!seen_targets->add(target)) {
+  uint32_t node = graph.GetNode(target);
+  if (seen_nodes && node != TargetGraph::kNoNode) {
+    if (!seen_nodes->add(node)) {
       // Already seen.
       print_children = false;
       // Only print "..." if something is actually elided, which means that
       // the current target has children.
-      if (dep_map.lower_bound(target) != dep_map.upper_bound(target))
+      if (!graph.dependents(node).empty())
         OutputString("...");
     }
   }
 
   OutputString("\n");
   if (print_children) {
-    count += RecursivePrintTargetDeps(dep_map, target, seen_targets,
+    count += RecursivePrintTargetDeps(graph, target, seen_nodes,
                                       indent_level + 1);
   }
   return count;
@@ -85,44 +75,40 @@ size_t RecursivePrintTarget(const DepMap& dep_map,
 
 // Prints refs of the given target (not the target itself). See
 // RecursivePrintTarget.
-size_t RecursivePrintTargetDeps(const DepMap& dep_map,
+size_t RecursivePrintTargetDeps(const TargetGraph& graph,
                                 const Target* target,
-                                TargetSet* seen_targets,
+                                IdBitSet* seen_nodes,
                                 int indent_level) {
-  DepMap::const_iterator dep_begin = dep_map.lower_bound(target);
-  DepMap::const_iterator dep_end = dep_map.upper_bound(target);
+  uint32_t node = graph.GetNode(target);
+  if (node == TargetGraph::kNoNode)
+    return 0;  // Nothing in the graph depends on it.
+
   size_t count = 0;
-  for (DepMap::const_iterator cur_dep = dep_begin; cur_dep != dep_end;
-       cur_dep++) {
-    count += RecursivePrintTarget(dep_map, cur_dep->second, seen_targets,
-                                  indent_level);
+  for (const TargetGraph::Edge& dependent : graph.dependents(node)) {
+    count += RecursivePrintTarget(graph, graph.target(dependent.node),
+                                  seen_nodes, indent_level);
   }
   return count;
 }
 
-void RecursiveCollectChildRefs(const DepMap& dep_map,
-                               const Target* target,
-                               TargetSet* results);
-
-// Recursively finds all targets that reference the given one, and additionally
-// adds the current one to the list.
-void RecursiveCollectRefs(const DepMap& dep_map,
-                          const Target* target,
-                          TargetSet* results) {
-  if (!results->add(target))
-    return;  // Already found this target.
-  RecursiveCollectChildRefs(dep_map, target, results);
+// Returns the nodes of the given targets which are in the graph.
+std::vector<uint32_t> GetNodes(const TargetGraph& graph,
+                               const UniqueVector<const Target*>& targets) {
+  std::vector<uint32_t> result;
+  result.reserve(targets.size());
+  for (const Target* target : targets) {
+    uint32_t node = graph.GetNode(target);
+    if (node != TargetGraph::kNoNode)
+      result.push_back(node);
+  }
+  return result;
 }
 
-// Recursively finds all targets that reference the given one.
-void RecursiveCollectChildRefs(const DepMap& dep_map,
-                               const Target* target,
-                               TargetSet* results) {
-  DepMap::const_iterator dep_begin = dep_map.lower_bound(target);
-  DepMap::const_iterator dep_end = dep_map.upper_bound(target);
-  for (DepMap::const_iterator cur_dep = dep_begin; cur_dep != dep_end;
-       cur_dep++)
-    RecursiveCollectRefs(dep_map, cur_dep->second, results);
+// Prints the targets of the given nodes. Returns the number of nodes.
+size_t PrintNodes(const TargetGraph& graph, const IdBitSet& nodes) {
+  std::vector<const Target*> targets = graph.GetTargets(nodes);
+  FilterAndPrintTargets(false, &targets);
+  return nodes.size();
 }
 
 bool TargetReferencesConfig(const Target* target, const Config* config) {
@@ -155,27 +141,27 @@ void GetTargetsReferencingConfig(Setup* setup,
 }
 
 // Returns the number of matches printed.
-size_t DoTreeOutput(const DepMap& dep_map,
+size_t DoTreeOutput(const TargetGraph& graph,
                     const UniqueVector<const Target*>& implicit_target_matches,
                     const UniqueVector<const Target*>& explicit_target_matches,
                     bool all) {
-  TargetSet seen_targets;
+  IdBitSet seen_nodes(graph.size());
   size_t count = 0;
 
   // Implicit targets don't get printed themselves.
   for (const Target* target : implicit_target_matches) {
     if (all)
-      count += RecursivePrintTargetDeps(dep_map, target, nullptr, 0);
+      count += RecursivePrintTargetDeps(graph, target, nullptr, 0);
     else
-      count += RecursivePrintTargetDeps(dep_map, target, &seen_targets, 0);
+      count += RecursivePrintTargetDeps(graph, target, &seen_nodes, 0);
   }
 
   // Explicit targets appear in the output.
   for (const Target* target : implicit_target_matches) {
     if (all)
-      count += RecursivePrintTarget(dep_map, target, nullptr, 0);
+      count += RecursivePrintTarget(graph, target, nullptr, 0);
     else
-      count += RecursivePrintTarget(dep_map, target, &seen_targets, 0);
+      count += RecursivePrintTarget(graph, target, &seen_nodes, 0);
   }
 
   return count;
@@ -183,47 +169,43 @@ size_t DoTreeOutput(const DepMap& dep_map,
 
 // Returns the number of matches printed.
 size_t DoAllListOutput(
-    const DepMap& dep_map,
+    const TargetGraph& graph,
     const UniqueVector<const Target*>& implicit_target_matches,
     const UniqueVector<const Target*>& explicit_target_matches) {
   // Output recursive dependencies, uniquified and flattened.
-  TargetSet results;
-
-  for (const Target* target : implicit_target_matches)
-    RecursiveCollectChildRefs(dep_map, target, &results);
-  for (const Target* target : explicit_target_matches) {
-    // Explicit targets also get added to the output themselves.
-    results.insert(target);
-    RecursiveCollectChildRefs(dep_map, target, &results);
-  }
-
-  FilterAndPrintTargetSet(false, results);
-  return results.size();
+  IdBitSet results(graph.size());
+
+  // Explicit targets also get added to the output themselves.
+  std::vector<uint32_t> explicit_nodes =
+      GetNodes(graph, explicit_target_matches);
+  for (uint32_t node : explicit_nodes)
+    results.add(node);
+
+  graph.CollectDependents(GetNodes(graph, implicit_target_matches),
+                          DepType::DATA, &results);
+  graph.CollectDependents(explicit_nodes, DepType::DATA, &results);
+  return PrintNodes(graph, results);
 }
 
 // Returns the number of matches printed.
 size_t DoDirectListOutput(
-    const DepMap& dep_map,
+    const TargetGraph& graph,
     const UniqueVector<const Target*>& implicit_target_matches,
     const UniqueVector<const Target*>& explicit_target_matches) {
-  TargetSet results;
+  IdBitSet results(graph.size());
 
   // Output everything that refers to the implicit ones.
-  for (const Target* target : implicit_target_matches) {
-    DepMap::const_iterator dep_begin = dep_map.lower_bound(target);
-    DepMap::const_iterator dep_end = dep_map.upper_bound(target);
-    for (DepMap::const_iterator cur_dep = dep_begin; cur_dep != dep_end;
-         cur_dep++)
-      results.insert(cur_dep->second);
+  for (uint32_t node : GetNodes(graph, implicit_target_matches)) {
+    for (const TargetGraph::Edge& dependent : graph.dependents(node))
+      results.add(dependent.node);
   }
 
   // And just output the explicit ones directly (these are the target matches
   // when referring to what references a file or config).
-  for (const Target* target : explicit_target_matches)
-    results.insert(target);
+  for (uint32_t node : GetNodes(graph, explicit_target_matches))
+    results.add(node);
 
-  FilterAndPrintTargetSet(false, results);
-  return results.size();
+  return PrintNodes(graph, results);
 }
 
 }  // namespace
@@ -395,14 +377,14 @@ int RunRefs(const std::vector<std::string>& args) {
   // target_matches, however, since these targets should actually be listed in
   // the output, while for normal targets you don't want to see the inputs,
   // only what refers to them.
-  std::vector<const Target*> all_targets =
-      setup->builder().GetAllResolvedTargets();
+  const TargetGraph& graph = setup->GetTargetGraph();
+  const std::vector<const Target*>& all_targets = graph.targets();
   UniqueVector<const Target*> explicit_target_matches;
-  for (const auto& file : file_matches) {
-    std::vector<TargetContainingFile> target_containing;
-    GetTargetsContainingFile(setup, all_targets, file, default_toolchain_only,
-                             &target_containing);
-
+  std::vector<std::vector<TargetContainingFile>> targets_containing;
+  GetTargetsContainingFiles(setup, all_targets, file_matches.vector(),
+                            default_toolchain_only, &targets_containing);
+  for (const std::vector<TargetContainingFile>& target_containing :
+       targets_containing) {
     // Extract just the Target*.
     for (const TargetContainingFile& pair : target_containing)
       explicit_target_matches.push_back(pair.first);
@@ -426,17 +408,13 @@ int RunRefs(const std::vector<std::string>& args) {
     return 1;
   }
 
-  // Construct the reverse dependency tree.
-  DepMap dep_map;
-  FillDepMap(setup, &dep_map);
-
   size_t cnt = 0;
   if (tree)
-    cnt = DoTreeOutput(dep_map, target_matches, explicit_target_matches, all);
+    cnt = DoTreeOutput(graph, target_matches, explicit_target_matches, all);
   else if (all)
-    cnt = DoAllListOutput(dep_map, target_matches, explicit_target_matches);
+    cnt = DoAllListOutput(graph, target_matches, explicit_target_matches);
   else
-    cnt = DoDirectListOutput(dep_map, target_matches, explicit_target_matches);
+    cnt = DoDirectListOutput(graph, target_matches, explicit_target_matches);
 
   // If you ask for the references of a valid target, but that target has
   // nothing referencing it, we'll get here without having printed anything.
@@ -4,8 +4,10 @@
 
 #include "gn/commands.h"
 
+#include <algorithm>
 #include <fstream>
 #include <optional>
+#include <utility>
 
 #include "base/command_line.h"
 #include "base/environment.h"
@@ -20,6 +22,7 @@
 #include "gn/item.h"
 #include "gn/label.h"
 #include "gn/label_pattern.h"
+#include "gn/label_pattern_set.h"
 #include "gn/ninja_build_writer.h"
 #include "gn/setup.h"
 #include "gn/standard_out.h"
@@ -27,6 +30,7 @@
 #include "gn/target.h"
 #include "util/atomic_write.h"
 #include "util/build_config.h"
+#include "util/worker_pool.h"
 
 namespace commands {
 
@@ -67,8 +71,8 @@ bool ResolveTargetsFromCommandLinePattern(Setup* setup,
 
   std::vector<LabelPattern> pattern_vector;
   pattern_vector.push_back(pattern);
-  FilterTargetsByPatterns(setup->builder().GetAllResolvedTargets(),
-                          pattern_vector, matches);
+  FilterTargetsByPatterns(setup->GetTargetGraph().targets(), pattern_vector,
+                          matches);
   return true;
 }
 
@@ -312,6 +316,9 @@ inline std::string FixGitBashLabelEdit(const std::string& label) {
 }
 #endif
 
+// Number of targets checked by each task of GetTargetsContainingFiles().
+constexpr size_t kTargetsPerChunk = 64;
+
 std::optional<HowTargetContainsFile> TargetContainsFile(
     const Target* target,
     const SourceFile& file) {
@@ -623,43 +630,30 @@ bool ResolveFromCommandLineInput(
 void FilterTargetsByPatterns(const std::vector<const Target*>& input,
                              const std::vector<LabelPattern>& filter,
                              std::vector<const Target*>* output) {
+  LabelPatternSet filter_set(filter);
   for (auto* target : input) {
-    for (const auto& pattern : filter) {
-      if (pattern.Matches(target->label())) {
-        output->push_back(target);
-        break;
-      }
-    }
+    if (filter_set.Matches(target->label()))
+      output->push_back(target);
   }
 }
 
 void FilterTargetsByPatterns(const std::vector<const Target*>& input,
                              const std::vector<LabelPattern>& filter,
                              UniqueVector<const Target*>* output) {
+  LabelPatternSet filter_set(filter);
   for (auto* target : input) {
-    for (const auto& pattern : filter) {
-      if (pattern.Matches(target->label())) {
-        output->push_back(target);
-        break;
-      }
-    }
+    if (filter_set.Matches(target->label()))
+      output->push_back(target);
   }
 }
 
 void FilterOutTargetsByPatterns(const std::vector<const Target*>& input,
                                 const std::vector<LabelPattern>& filter,
                                 std::vector<const Target*>* output) {
+  LabelPatternSet filter_set(filter);
   for (auto* target : input) {
-    bool match = false;
-    for (const auto& pattern : filter) {
-      if (pattern.Matches(target->label())) {
-        match = true;
-        break;
-      }
-    }
-    if (!match) {
+    if (!filter_set.Matches(target->label()))
       output->push_back(target);
-    }
   }
 }
 
@@ -734,20 +728,41 @@ void FilterAndPrintTargetSet(const TargetSet& targets, base::ListValue* out) {
   FilterAndPrintTargets(&target_vector, out);
 }
 
-void GetTargetsContainingFile(Setup* setup,
-                              const std::vector<const Target*>& all_targets,
-                              const SourceFile& file,
-                              bool default_toolchain_only,
-                              std::vector<TargetContainingFile>* matches) {
+void GetTargetsContainingFiles(
+    Setup* setup,
+    const std::vector<const Target*>& all_targets,
+    const std::vector<SourceFile>& files,
+    bool default_toolchain_only,
+    std::vector<std::vector<TargetContainingFile>>* matches) {
   Label default_toolchain = setup->loader()->default_toolchain_label();
-  for (auto* target : all_targets) {
-    if (default_toolchain_only) {
-      // Only check targets in the default toolchain.
-      if (target->label().GetToolchainLabel() != default_toolchain)
-        continue;
+
+  // Each chunk of targets collects its matches as (file index, match) pairs,
+  // which are then appended to the lists of the files in target order.
+  using FileMatch = std::pair<size_t, TargetContainingFile>;
+  const size_t chunk_count =
+      (all_targets.size() + kTargetsPerChunk - 1) / kTargetsPerChunk;
+  std::vector<std::vector<FileMatch>> chunk_matches(chunk_count);
+  WorkerPool::GetShared().ParallelFor(chunk_count, [&](size_t chunk) {
+    const size_t begin = chunk * kTargetsPerChunk;
+    const size_t end = std::min(begin + kTargetsPerChunk, all_targets.size());
+    for (size_t i = begin; i < end; i++) {
+      const Target* target = all_targets[i];
+      if (default_toolchain_only) {
+        // Only check targets in the default toolchain.
+        if (target->label().GetToolchainLabel() != default_toolchain)
+          continue;
+      }
+      for (size_t file = 0; file < files.size(); file++) {
+        if (auto how = TargetContainsFile(target, files[file]))
+          chunk_matches[chunk].emplace_back(file, std::pair(target, *how));
+      }
     }
-    if (auto how = TargetContainsFile(target, file))
-      matches->emplace_back(target, *how);
+  });
+
+  matches->assign(files.size(), {});
+  for (const std::vector<FileMatch>& chunk : chunk_matches) {
+    for (const FileMatch& match : chunk)
+      (*matches)[match.first].push_back(match.second);
   }
 }
 
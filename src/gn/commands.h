@@ -363,11 +363,16 @@ enum class HowTargetContainsFile {
   kOutput,
 };
 using TargetContainingFile = std::pair<const Target*, HowTargetContainsFile>;
-void GetTargetsContainingFile(Setup* setup,
-                              const std::vector<const Target*>& all_targets,
-                              const SourceFile& file,
-                              bool default_toolchain_only,
-                              std::vector<TargetContainingFile>* matches);
+
+// Finds the targets of |all_targets| containing each of |files|. The targets
+// are checked on a worker pool, and |matches| receives one list per file with
+// the matching targets in the order of |all_targets|.
+void GetTargetsContainingFiles(
+    Setup* setup,
+    const std::vector<const Target*>& all_targets,
+    const std::vector<SourceFile>& files,
+    bool default_toolchain_only,
+    std::vector<std::vector<TargetContainingFile>>* matches);
 
 // Extra help from command_check.cc
 extern const char kNoGnCheck_Help[];
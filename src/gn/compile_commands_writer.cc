@@ -4,6 +4,9 @@
 
 #include "gn/compile_commands_writer.h"
 
+#include <algorithm>
+#include <functional>
+#include <memory>
 #include <sstream>
 
 #include "base/json/string_escape.h"
@@ -15,10 +18,13 @@
 #include "gn/config_values_extractors.h"
 #include "gn/deps_iterator.h"
 #include "gn/escape.h"
+#include "gn/label_pattern_set.h"
 #include "gn/ninja_target_command_util.h"
 #include "gn/path_output.h"
+#include "gn/streaming_file_writer.h"
 #include "gn/string_output_buffer.h"
 #include "gn/substitution_writer.h"
+#include "util/worker_pool.h"
 
 // Structure of JSON output file
 // [
@@ -131,66 +137,89 @@ void SetupCompileFlags(const Target* target,
                &ConfigValues::cflags_objcc);
 }
 
-void WriteFile(const SourceFile& source,
-               PathOutput& path_output,
-               std::ostream& out) {
-  std::ostringstream rel_source_path;
-  out << "    \"file\": \"";
-  path_output.WriteFile(out, source);
-}
+// Number of targets whose entries are rendered by one task. Chunks are
+// rendered in parallel, a window of them at a time so that only that much of
+// the output is held in memory before being passed on.
+constexpr size_t kTargetsPerChunk = 64;
+constexpr size_t kChunksPerWindow = 256;
+
+// A part of a tool's command for one target. Everything that is the same for
+// all sources of the target is rendered into |text| once. It is followed by
+// the outputs if |write_outputs| is set, or by the source substitution of
+// |source_plan|.
+struct CommandPart {
+  std::string text;
+  bool write_outputs = false;
+  std::unique_ptr<SourceSubstitutionPlan> source_plan;
+};
 
-void WriteDirectory(std::string build_dir, std::ostream& out) {
-  out << "\",";
-  out << kPrettyPrintLineEnding;
-  out << "    \"directory\": \"";
-  out << build_dir;
-  out << "\",";
+// The command parts for the sources compiled with a given tool.
+struct ToolCommand {
+  const char* tool_name;
+  SourceFile::Type source_type;
+  std::vector<CommandPart> parts;
+};
+
+bool IsSourceSubstitution(const Substitution* type) {
+  return type == &SubstitutionSource || type == &SubstitutionSourceNamePart ||
+         type == &SubstitutionSourceFilePart ||
+         type == &SubstitutionSourceDir ||
+         type == &SubstitutionSourceRootRelativeDir ||
+         type == &SubstitutionSourceGenDir ||
+         type == &SubstitutionSourceOutDir ||
+         type == &SubstitutionSourceTargetRelative;
 }
 
-void WriteCommand(const Target* target,
-                  const SourceFile& source,
-                  const CompileFlags& flags,
-                  std::vector<OutputFile>& tool_outputs,
-                  PathOutput& path_output,
-                  SourceFile::Type source_type,
-                  const char* tool_name,
-                  EscapeOptions opts,
-                  std::ostream& out) {
+std::vector<CommandPart> BuildCommandParts(const Target* target,
+                                           const CompileFlags& flags,
+                                           SourceFile::Type source_type,
+                                           const char* tool_name,
+                                           EscapeOptions opts) {
   EscapeOptions no_quoting(opts);
   no_quoting.inhibit_quoting = true;
   const Tool* tool = target->toolchain()->GetTool(tool_name);
 
-  out << kPrettyPrintLineEnding;
-  out << "    \"command\": \"";
-
+  std::vector<CommandPart> parts;
+  std::ostringstream text;
   for (const auto& range : tool->command().ranges()) {
     // TODO: this is emitting a bonus space prior to each substitution.
     if (range.type == &SubstitutionLiteral) {
-      EscapeJSONStringToStream(out, range.literal, no_quoting);
+      EscapeJSONStringToStream(text, range.literal, no_quoting);
     } else if (range.type == &SubstitutionOutput) {
-      path_output.WriteFiles(out, tool_outputs);
+      parts.emplace_back();
+      parts.back().text = text.str();
+      parts.back().write_outputs = true;
+      text.str(std::string());
+    } else if (IsSourceSubstitution(range.type)) {
+      parts.emplace_back();
+      parts.back().text = text.str();
+      parts.back().source_plan = std::make_unique<SourceSubstitutionPlan>(
+          target, target->settings(), range.type,
+          SubstitutionWriter::OUTPUT_RELATIVE,
+          target->settings()->build_settings()->build_dir());
+      text.str(std::string());
     } else if (range.type == &CSubstitutionDefines) {
-      out << flags.defines;
+      text << flags.defines;
     } else if (range.type == &CSubstitutionFrameworkDirs) {
-      out << flags.framework_dirs;
+      text << flags.framework_dirs;
     } else if (range.type == &CSubstitutionFrameworks) {
-      out << flags.frameworks;
+      text << flags.frameworks;
     } else if (range.type == &CSubstitutionIncludeDirs) {
-      out << flags.includes;
+      text << flags.includes;
     } else if (range.type == &CSubstitutionCFlags) {
-      out << flags.cflags;
+      text << flags.cflags;
     } else if (range.type == &CSubstitutionCFlagsC) {
       if (source_type == SourceFile::SOURCE_C)
-        out << flags.cflags_c;
+        text << flags.cflags_c;
     } else if (range.type == &CSubstitutionCFlagsCc) {
       if (source_type == SourceFile::SOURCE_CPP)
-        out << flags.cflags_cc;
+        text << flags.cflags_cc;
     } else if (range.type == &CSubstitutionCFlagsObjC) {
       if (source_type == SourceFile::SOURCE_M)
-        out << flags.cflags_objc;
+        text << flags.cflags_objc;
     } else if (range.type == &CSubstitutionCFlagsObjCc) {
       if (source_type == SourceFile::SOURCE_MM)
-        out << flags.cflags_objcc;
+        text << flags.cflags_objcc;
     } else if (range.type == &SubstitutionLabel ||
                range.type == &SubstitutionLabelName ||
                range.type == &SubstitutionLabelNoToolchain ||
@@ -198,19 +227,10 @@ void WriteCommand(const Target* target,
                range.type == &SubstitutionRootOutDir ||
                range.type == &SubstitutionTargetGenDir ||
                range.type == &SubstitutionTargetOutDir ||
-               range.type == &SubstitutionTargetOutputName ||
-               range.type == &SubstitutionSource ||
-               range.type == &SubstitutionSourceNamePart ||
-               range.type == &SubstitutionSourceFilePart ||
-               range.type == &SubstitutionSourceDir ||
-               range.type == &SubstitutionSourceRootRelativeDir ||
-               range.type == &SubstitutionSourceGenDir ||
-               range.type == &SubstitutionSourceOutDir ||
-               range.type == &SubstitutionSourceTargetRelative) {
-      EscapeStringToStream(out,
-                           SubstitutionWriter::GetCompilerSubstitution(
-                               target, source, range.type),
-                           opts);
+               range.type == &SubstitutionTargetOutputName) {
+      EscapeStringToStream(
+          text, SubstitutionWriter::GetTargetSubstitution(target, range.type),
+          opts);
     } else {
       // Other flags shouldn't be relevant to compiling C/C++/ObjC/ObjC++
       // source files.
@@ -219,24 +239,43 @@ void WriteCommand(const Target* target,
       continue;
     }
   }
+  parts.emplace_back();
+  parts.back().text = text.str();
+  return parts;
 }
 
-void OutputJSON(const BuildSettings* build_settings,
-                std::vector<const Target*>& all_targets,
-                std::ostream& out) {
-  out << '[';
+void WriteCommand(const SourceFile& source,
+                  std::vector<CommandPart>& parts,
+                  std::vector<OutputFile>& tool_outputs,
+                  PathOutput& path_output,
+                  EscapeOptions opts,
+                  std::ostream& out) {
   out << kPrettyPrintLineEnding;
+  out << "    \"command\": \"";
+
+  for (auto& part : parts) {
+    out << part.text;
+    if (part.write_outputs)
+      path_output.WriteFiles(out, tool_outputs);
+    else if (part.source_plan)
+      part.source_plan->WriteForSource(source, opts, out);
+  }
+}
+
+// Writes the entries for the sources of the given binary targets, separated
+// by commas. Returns whether anything was written.
+bool WriteTargets(const std::string& build_dir,
+                  const Target* const* targets,
+                  size_t count,
+                  std::ostream& out) {
   bool first = true;
-  auto build_dir = build_settings->GetFullPath(build_settings->build_dir())
-                       .StripTrailingSeparators();
   std::vector<OutputFile> tool_outputs;  // Prevent reallocation in loop.
 
   EscapeOptions opts;
   opts.mode = ESCAPE_NINJA_PREFORMATTED_COMMAND;
 
-  for (const auto* target : all_targets) {
-    if (!target->IsBinary())
-      continue;
+  for (size_t i = 0; i < count; i++) {
+    const Target* target = targets[i];
 
     // Precompute values that are the same for all sources in a target to avoid
     // computing for every source.
@@ -249,6 +288,9 @@ void OutputJSON(const BuildSettings* build_settings,
     CompileFlags flags;
     SetupCompileFlags(target, path_output, opts, flags);
 
+    // Commands for the tools used so far, there are only a few.
+    std::vector<ToolCommand> commands;
+
     for (const auto& source : target->sources()) {
       // If this source is not a C/C++/ObjC/ObjC++ source (not header) file,
       // continue as it does not belong in the compilation database.
@@ -263,6 +305,18 @@ void OutputJSON(const BuildSettings* build_settings,
       if (!target->GetOutputFilesForSource(source, &tool_name, &tool_outputs))
         continue;
 
+      auto command = std::find_if(
+          commands.begin(), commands.end(), [&](const ToolCommand& command) {
+            return command.tool_name == tool_name &&
+                   command.source_type == source_type;
+          });
+      if (command == commands.end()) {
+        commands.push_back({tool_name, source_type,
+                            BuildCommandParts(target, flags, source_type,
+                                              tool_name, opts)});
+        command = commands.end() - 1;
+      }
+
       if (!first) {
         out << ',';
         out << kPrettyPrintLineEnding;
@@ -271,19 +325,78 @@ void OutputJSON(const BuildSettings* build_settings,
       out << "  {";
       out << kPrettyPrintLineEnding;
 
-      WriteFile(source, path_output, out);
-      WriteDirectory(base::StringPrintf("%" PRIsFP, PATH_CSTR(build_dir)), out);
-      WriteCommand(target, source, flags, tool_outputs, path_output,
-                   source_type, tool_name, opts, out);
+      out << "    \"file\": \"";
+      path_output.WriteFile(out, source);
+      out << "\",";
+      out << kPrettyPrintLineEnding;
+      out << "    \"directory\": \"";
+      out << build_dir;
+      out << "\",";
+      WriteCommand(source, command->parts, tool_outputs, path_output, opts,
+                   out);
       out << "\"";
       out << kPrettyPrintLineEnding;
       out << "  }";
     }
   }
+  return !first;
+}
 
-  out << kPrettyPrintLineEnding;
-  out << "]";
-  out << kPrettyPrintLineEnding;
+// Renders the compilation database for the given targets and passes it to
+// |sink| in consecutive pieces.
+void OutputJSON(const BuildSettings* build_settings,
+                const std::vector<const Target*>& all_targets,
+                const std::function<void(std::string_view)>& sink) {
+  std::string header("[");
+  header.append(kPrettyPrintLineEnding);
+  sink(header);
+
+  auto build_dir = build_settings->GetFullPath(build_settings->build_dir())
+                       .StripTrailingSeparators();
+  std::string build_dir_string =
+      base::StringPrintf("%" PRIsFP, PATH_CSTR(build_dir));
+
+  std::vector<const Target*> binaries;
+  for (const Target* target : all_targets) {
+    if (target->IsBinary())
+      binaries.push_back(target);
+  }
+
+  // Rendering the entries dominates, so targets are rendered in parallel into
+  // separate buffers which are then passed on in order.
+  size_t chunk_count =
+      (binaries.size() + kTargetsPerChunk - 1) / kTargetsPerChunk;
+  bool wrote_entries = false;
+  for (size_t window_begin = 0; window_begin < chunk_count;
+       window_begin += kChunksPerWindow) {
+    size_t window_size =
+        std::min(kChunksPerWindow, chunk_count - window_begin);
+    std::vector<StringOutputBuffer> chunks(window_size);
+    std::vector<char> chunk_has_entries(window_size);
+    WorkerPool::GetShared().ParallelFor(window_size, [&](size_t i) {
+      size_t begin = (window_begin + i) * kTargetsPerChunk;
+      size_t count = std::min(kTargetsPerChunk, binaries.size() - begin);
+      std::ostream out(&chunks[i]);
+      chunk_has_entries[i] =
+          WriteTargets(build_dir_string, &binaries[begin], count, out);
+    });
+
+    std::string separator(",");
+    separator.append(kPrettyPrintLineEnding);
+    for (size_t i = 0; i < window_size; i++) {
+      if (!chunk_has_entries[i])
+        continue;
+      if (wrote_entries)
+        sink(separator);
+      wrote_entries = true;
+      sink(chunks[i].str());
+    }
+  }
+
+  std::string footer(kPrettyPrintLineEnding);
+  footer.append("]");
+  footer.append(kPrettyPrintLineEnding);
+  sink(footer);
 }
 
 }  // namespace
@@ -291,10 +404,10 @@ void OutputJSON(const BuildSettings* build_settings,
 std::string CompileCommandsWriter::RenderJSON(
     const BuildSettings* build_settings,
     std::vector<const Target*>& all_targets) {
-  StringOutputBuffer json;
-  std::ostream out(&json);
-  OutputJSON(build_settings, all_targets, out);
-  return json.str();
+  std::string json;
+  OutputJSON(build_settings, all_targets,
+             [&json](std::string_view piece) { json.append(piece); });
+  return json;
 }
 
 bool CompileCommandsWriter::RunAndWriteFiles(
@@ -309,11 +422,14 @@ bool CompileCommandsWriter::RunAndWriteFiles(
   if (err->has_error())
     return false;
 
-  StringOutputBuffer json;
-  std::ostream output_to_json(&json);
-  OutputJSON(build_settings, to_write, output_to_json);
-
-  return json.WriteToFileIfChanged(output_path, err);
+  // The database can be very large for big builds, so it's streamed to disk
+  // rather than built in memory first.
+  StreamingFileWriter writer(output_path);
+  if (!writer.Create(err))
+    return false;
+  OutputJSON(build_settings, to_write,
+             [&writer](std::string_view piece) { writer.Write(piece); });
+  return writer.Commit(err);
 }
 
 std::vector<const Target*> CompileCommandsWriter::CollectTargets(
@@ -330,9 +446,10 @@ std::vector<const Target*> CompileCommandsWriter::CollectTargets(
 
   // Collect the first level of target matches. These are the ones that the
   // patterns match directly.
+  LabelPatternSet pattern_set(patterns);
   std::vector<const Target*> input_targets;
   for (const Target* target : all_targets) {
-    if (LabelPattern::VectorMatches(patterns, target->label()))
+    if (pattern_set.Matches(target->label()))
       input_targets.push_back(target);
   }
 
@@ -734,3 +734,49 @@ TEST_F(CompileCommandsTest, CollectTargets) {
   EXPECT_EQ(&target2, output[3]);
   EXPECT_EQ(&icu_target, output[4]);
 }
+
+// Targets are rendered in parallel in chunks, which must be joined in order.
+TEST_F(CompileCommandsTest, ManyTargets) {
+#if defined(OS_WIN)
+  const std::string kEol = "\r\n";
+#else
+  const std::string kEol = "\n";
+#endif
+
+  Err err;
+  std::vector<std::unique_ptr<Target>> storage;
+  std::vector<const Target*> targets;
+  std::string expected = "[" + kEol;
+  bool first = true;
+  for (int i = 0; i < 1000; i++) {
+    std::string name = "t" + std::to_string(i);
+    auto target = std::make_unique<Target>(
+        settings(), Label(SourceDir("//foo/"), name));
+    target->set_output_type(Target::SOURCE_SET);
+    target->visibility().SetPublic();
+
+    // Only some targets have entries, so that some chunks are empty.
+    if (i % 7 == 0 || (i >= 200 && i < 400)) {
+      target->sources().push_back(SourceFile("//foo/" + name + ".h"));
+    } else {
+      target->sources().push_back(SourceFile("//foo/" + name + ".cc"));
+      if (!first)
+        expected += "," + kEol;
+      first = false;
+      expected += "  {" + kEol + "    \"file\": \"../../foo/" + name +
+                  ".cc\"," + kEol +
+                  "    \"directory\": \"out/Debug\"," + kEol +
+                  "    \"command\": \"c++ ../../foo/" + name +
+                  ".cc     -o  obj/foo/" + name + "." + name + ".o\"" + kEol +
+                  "  }";
+    }
+    target->SetToolchain(toolchain());
+    ASSERT_TRUE(target->OnResolved(&err));
+    targets.push_back(target.get());
+    storage.push_back(std::move(target));
+  }
+  expected += kEol + "]" + kEol;
+
+  CompileCommandsWriter writer;
+  EXPECT_EQ(expected, writer.RenderJSON(build_settings(), targets));
+}
@@ -6,23 +6,11 @@
 
 #include "gn/escape.h"
 
-namespace {
-
-class EscapedStringWriter {
- public:
-  explicit EscapedStringWriter(const EscapeOptions& escape_options)
-      : escape_options_(escape_options) {}
-
-  void operator()(const std::string& s, std::ostream& out) const {
-    out << " ";
-    EscapeStringToStream(out, s, escape_options_);
-  }
-
- private:
-  const EscapeOptions& escape_options_;
-};
-
-}  // namespace
+void EscapedStringWriter::operator()(const std::string& s,
+                                     std::ostream& out) const {
+  out << " ";
+  EscapeStringToStream(out, s, escape_options_);
+}
 
 void RecursiveTargetConfigStringsToStream(
     RecursiveWriterConfig config,
@@ -107,6 +107,19 @@ inline void RecursiveTargetConfigToStream(
   }
 }
 
+// Writer for RecursiveTargetConfigToStream() that writes each string escaped
+// with the given options, preceded by a space.
+class EscapedStringWriter {
+ public:
+  explicit EscapedStringWriter(const EscapeOptions& escape_options)
+      : escape_options_(escape_options) {}
+
+  void operator()(const std::string& s, std::ostream& out) const;
+
+ private:
+  const EscapeOptions& escape_options_;
+};
+
 // Writes the values out as strings with no transformation.
 void RecursiveTargetConfigStringsToStream(
     RecursiveWriterConfig config,
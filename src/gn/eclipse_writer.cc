@@ -4,14 +4,15 @@
 
 #include "gn/eclipse_writer.h"
 
-#include <fstream>
 #include <memory>
+#include <ostream>
 
 #include "base/files/file_path.h"
 #include "gn/builder.h"
 #include "gn/config_values_extractors.h"
 #include "gn/filesystem_utils.h"
 #include "gn/loader.h"
+#include "gn/string_output_buffer.h"
 #include "gn/xml_element_writer.h"
 
 namespace {
@@ -55,18 +56,11 @@ bool EclipseWriter::RunAndWriteFile(const BuildSettings* build_settings,
                                     Err* err) {
   base::FilePath file = build_settings->GetFullPath(build_settings->build_dir())
                             .AppendASCII("eclipse-cdt-settings.xml");
-  std::ofstream file_out;
-  file_out.open(FilePathToUTF8(file).c_str(),
-                std::ios_base::out | std::ios_base::binary);
-  if (file_out.fail()) {
-    *err =
-        Err(Location(), "Couldn't open eclipse-cdt-settings.xml for writing");
-    return false;
-  }
-
+  StringOutputBuffer storage;
+  std::ostream file_out(&storage);
   EclipseWriter gen(build_settings, builder, file_out);
   gen.Run();
-  return true;
+  return storage.WriteToFileIfChanged(file, err);
 }
 
 void EclipseWriter::Run() {
@@ -5,6 +5,8 @@
 #include "gn/escape.h"
 
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 
 #include <memory>
 
@@ -42,17 +44,65 @@ const char kShellValid[0x80] = {
     1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0};
 // clang-format on
 
+inline bool IsShellValid(char ch) {
+  return static_cast<unsigned char>(ch) < 0x80 &&
+         kShellValid[static_cast<int>(ch)];
+}
+
+// Returns a word with all bytes set to the given character.
+constexpr uint64_t RepeatByte(char ch) {
+  return 0x0101010101010101ull * static_cast<unsigned char>(ch);
+}
+
+// Returns non-zero if any byte of |word| equals the byte repeated in |pattern|.
+inline uint64_t HasByte(uint64_t word, uint64_t pattern) {
+  uint64_t x = word ^ pattern;
+  return (x - 0x0101010101010101ull) & ~x & 0x8080808080808080ull;
+}
+
+// Returns the offset of the first of |kChars| in |str| at or after |begin|,
+// or str.size() if there is none. Most strings have long runs of characters
+// that don't need escaping, so they are skipped eight bytes at a time.
+template <char... kChars>
+size_t FindFirstOf(std::string_view str, size_t begin) {
+  size_t i = begin;
+  for (; i + sizeof(uint64_t) <= str.size(); i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, str.data() + i, sizeof(word));
+    if ((HasByte(word, RepeatByte(kChars)) | ...))
+      break;
+  }
+  for (; i < str.size(); i++) {
+    if (((str[i] == kChars) || ...))
+      break;
+  }
+  return i;
+}
+
+// Escapes |str| into |dest| by prefixing each of |kChars| with |prefix|.
+// Returns the number of characters written.
+template <char... kChars>
+size_t EscapeCharsWithPrefix(std::string_view str, char prefix, char* dest) {
+  size_t i = 0;
+  size_t begin = 0;
+  while (begin < str.size()) {
+    size_t end = FindFirstOf<kChars...>(str, begin);
+    memcpy(dest + i, str.data() + begin, end - begin);
+    i += end - begin;
+    if (end == str.size())
+      break;
+    dest[i++] = prefix;
+    dest[i++] = str[end];
+    begin = end + 1;
+  }
+  return i;
+}
+
 size_t EscapeStringToString_Space(std::string_view str,
                                   const EscapeOptions& options,
                                   char* dest,
                                   bool* needed_quoting) {
-  size_t i = 0;
-  for (const auto& elem : str) {
-    if (elem == ' ')
-      dest[i++] = '\\';
-    dest[i++] = elem;
-  }
-  return i;
+  return EscapeCharsWithPrefix<' '>(str, '\\', dest);
 }
 
 // Uses the stack if the space needed is small and the heap otherwise.
@@ -80,17 +130,8 @@ size_t EscapeStringToString_Ninja(std::string_view str,
                                   const EscapeOptions& options,
                                   char* dest,
                                   bool* needed_quoting) {
-  size_t i = 0;
-  for (const auto& elem : str) {
-    if (ShouldEscapeCharForNinja(elem))
-      dest[i++] = '$';
-    dest[i++] = elem;
-  }
-  return i;
-}
-
-inline bool ShouldEscapeCharForCompilationDatabase(char ch) {
-  return ch == '\\' || ch == '"';
+  // Same as ShouldEscapeCharForNinja().
+  return EscapeCharsWithPrefix<'$', ' ', ':'>(str, '$', dest);
 }
 
 size_t EscapeStringToString_CompilationDatabase(std::string_view str,
@@ -100,8 +141,7 @@ size_t EscapeStringToString_CompilationDatabase(std::string_view str,
   size_t i = 0;
   bool quote = false;
   for (const auto& elem : str) {
-    if (static_cast<unsigned>(elem) >= 0x80 ||
-        !kShellValid[static_cast<int>(elem)]) {
+    if (!IsShellValid(elem)) {
       quote = true;
       break;
     }
@@ -109,11 +149,7 @@ size_t EscapeStringToString_CompilationDatabase(std::string_view str,
   if (quote)
     dest[i++] = '"';
 
-  for (const auto& elem : str) {
-    if (ShouldEscapeCharForCompilationDatabase(elem))
-      dest[i++] = '\\';
-    dest[i++] = elem;
-  }
+  i += EscapeCharsWithPrefix<'\\', '"'>(str, '\\', dest + i);
   if (quote)
     dest[i++] = '"';
   return i;
@@ -140,13 +176,7 @@ size_t EscapeStringToString_Depfile(std::string_view str,
 size_t EscapeStringToString_NinjaPreformatted(std::string_view str,
                                               char* dest) {
   // Only Ninja-escape $.
-  size_t i = 0;
-  for (const auto& elem : str) {
-    if (elem == '$')
-      dest[i++] = '$';
-    dest[i++] = elem;
-  }
-  return i;
+  return EscapeCharsWithPrefix<'$'>(str, '$', dest);
 }
 
 // Escape for CommandLineToArgvW and additionally escape Ninja characters.
@@ -214,7 +244,19 @@ size_t EscapeStringToString_PosixNinjaFork(std::string_view str,
                                            char* dest,
                                            bool* needed_quoting) {
   size_t i = 0;
-  for (const auto& elem : str) {
+  size_t j = 0;
+  while (j < str.size()) {
+    // Copy the run of literals in one go. Colon is valid in the shell but
+    // special to Ninja, so it ends the run too.
+    size_t run_begin = j;
+    while (j < str.size() && IsShellValid(str[j]) && str[j] != ':')
+      j++;
+    memcpy(dest + i, str.data() + run_begin, j - run_begin);
+    i += j - run_begin;
+    if (j == str.size())
+      break;
+
+    char elem = str[j++];
     if (elem == '$' || elem == ' ') {
       // Space and $ are special to both Ninja and the shell. '$' escape for
       // Ninja, then backslash-escape for the shell.
@@ -226,14 +268,10 @@ size_t EscapeStringToString_PosixNinjaFork(std::string_view str,
       // the shell.
       dest[i++] = '$';
       dest[i++] = ':';
-    } else if (static_cast<unsigned>(elem) >= 0x80 ||
-               !kShellValid[static_cast<int>(elem)]) {
+    } else {
       // All other invalid shell chars get backslash-escaped.
       dest[i++] = '\\';
       dest[i++] = elem;
-    } else {
-      // Everything else is a literal.
-      dest[i++] = elem;
     }
   }
   return i;
@@ -308,5 +346,8 @@ void EscapeJSONStringToStream(std::ostream& out,
   bool needed_quoting = !options.inhibit_quoting;
   base::EscapeJSONString(str, needed_quoting, &dest);
 
-  EscapeStringToStream(out, dest, options);
+  if (options.mode == ESCAPE_NONE)
+    out.write(dest.data(), dest.size());
+  else
+    EscapeStringToStream(out, dest, options);
 }
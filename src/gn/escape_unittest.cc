@@ -2,10 +2,138 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <stdint.h>
+
+#include <string>
+
+#include "base/json/string_escape.h"
 #include "gn/escape.h"
 #include "gn/string_output_buffer.h"
 #include "util/test/test.h"
 
+namespace {
+
+// Character-at-a-time versions of the escapers. The real ones copy runs of
+// characters that need no escaping in bulk and must produce the same output.
+bool IsShellValidForTest(char ch) {
+  std::string_view valid =
+      "+,-./0123456789:=@ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
+  return valid.find(ch) != std::string_view::npos;
+}
+
+std::string ReferenceEscape(std::string_view str, EscapingMode mode) {
+  std::string result;
+  if (mode == ESCAPE_COMPILATION_DATABASE) {
+    bool quote = false;
+    for (char ch : str)
+      quote |= !IsShellValidForTest(ch);
+    if (quote)
+      result.push_back('"');
+    for (char ch : str) {
+      if (ch == '\\' || ch == '"')
+        result.push_back('\\');
+      result.push_back(ch);
+    }
+    if (quote)
+      result.push_back('"');
+    return result;
+  }
+
+  for (char ch : str) {
+    switch (mode) {
+      case ESCAPE_SPACE:
+        if (ch == ' ')
+          result.push_back('\\');
+        break;
+      case ESCAPE_NINJA:
+        if (ch == '$' || ch == ' ' || ch == ':')
+          result.push_back('$');
+        break;
+      case ESCAPE_NINJA_PREFORMATTED_COMMAND:
+        if (ch == '$')
+          result.push_back('$');
+        break;
+      case ESCAPE_NINJA_COMMAND:  // POSIX.
+        if (ch == '$' || ch == ' ')
+          result.append("\\$");
+        else if (ch == ':')
+          result.push_back('$');
+        else if (!IsShellValidForTest(ch))
+          result.push_back('\\');
+        break;
+      default:
+        break;
+    }
+    result.push_back(ch);
+  }
+  return result;
+}
+
+std::string ReferenceEscapeJSON(std::string_view str) {
+  std::string result;
+  for (char ch : str) {
+    switch (ch) {
+      case '\b':
+        result.append("\\b");
+        break;
+      case '\f':
+        result.append("\\f");
+        break;
+      case '\n':
+        result.append("\\n");
+        break;
+      case '\r':
+        result.append("\\r");
+        break;
+      case '\t':
+        result.append("\\t");
+        break;
+      case '\\':
+        result.append("\\\\");
+        break;
+      case '"':
+        result.append("\\\"");
+        break;
+      case '<':
+        result.append("\\u003C");
+        break;
+      default:
+        if (ch >= 0 && ch < 32) {
+          const char kHex[] = "0123456789ABCDEF";
+          result.append("\\u00");
+          result.push_back(kHex[ch >> 4]);
+          result.push_back(kHex[ch & 0xf]);
+        } else {
+          result.push_back(ch);
+        }
+    }
+  }
+  return result;
+}
+
+// Returns pseudo-random strings made mostly of characters that need no
+// escaping, with the special characters of all modes mixed in, so that runs
+// of all lengths start and end at all offsets within a word.
+std::string RandomString(uint32_t* seed) {
+  static const char kSpecial[] = " $:\\\"#*[]|;<>'`~&()!\t\n\x01";
+  auto next = [seed]() {
+    *seed = *seed * 1103515245u + 12345u;
+    return *seed >> 16;
+  };
+  std::string result;
+  size_t size = next() % 70;
+  for (size_t i = 0; i < size; i++) {
+    uint32_t r = next() % 16;
+    if (r == 0)
+      result.push_back(kSpecial[next() % (sizeof(kSpecial) - 1)]);
+    else
+      result.push_back(static_cast<char>('a' + r));
+  }
+  return result;
+}
+
+}  // namespace
+
 TEST(Escape, Ninja) {
   EscapeOptions opts;
   opts.mode = ESCAPE_NINJA;
@@ -110,3 +238,49 @@ TEST(Escape, CompilationDatabase) {
   std::string result = EscapeString("asdf:$ \\#*[|]bar", opts, nullptr);
   EXPECT_EQ("\"asdf:$ \\\\#*[|]bar\"", result);
 }
+
+TEST(Escape, MatchesCharacterAtATime) {
+  EscapeOptions posix_command;
+  posix_command.mode = ESCAPE_NINJA_COMMAND;
+  posix_command.platform = ESCAPE_PLATFORM_POSIX;
+
+  uint32_t seed = 1;
+  for (int i = 0; i < 5000; i++) {
+    std::string str = RandomString(&seed);
+    for (EscapingMode mode :
+         {ESCAPE_SPACE, ESCAPE_NINJA, ESCAPE_NINJA_PREFORMATTED_COMMAND,
+          ESCAPE_COMPILATION_DATABASE}) {
+      EscapeOptions opts;
+      opts.mode = mode;
+      EXPECT_EQ(ReferenceEscape(str, mode), EscapeString(str, opts, nullptr))
+          << mode << " " << str;
+    }
+    EXPECT_EQ(ReferenceEscape(str, ESCAPE_NINJA_COMMAND),
+              EscapeString(str, posix_command, nullptr))
+        << str;
+
+    std::string json;
+    base::EscapeJSONString(str, false, &json);
+    EXPECT_EQ(ReferenceEscapeJSON(str), json) << str;
+  }
+
+  // Every ASCII character, also as the last one of a word.
+  for (int ch = 1; ch < 0x7f; ch++) {
+    for (size_t offset : {0, 7, 8, 15}) {
+      std::string str(offset, 'a');
+      str.push_back(static_cast<char>(ch));
+      for (EscapingMode mode :
+           {ESCAPE_SPACE, ESCAPE_NINJA, ESCAPE_NINJA_PREFORMATTED_COMMAND,
+            ESCAPE_COMPILATION_DATABASE}) {
+        EscapeOptions opts;
+        opts.mode = mode;
+        EXPECT_EQ(ReferenceEscape(str, mode),
+                  EscapeString(str, opts, nullptr))
+            << mode << " " << ch;
+      }
+      EXPECT_EQ(ReferenceEscape(str, ESCAPE_NINJA_COMMAND),
+                EscapeString(str, posix_command, nullptr))
+          << ch;
+    }
+  }
+}
@@ -7,6 +7,7 @@
 #include <stddef.h>
 
 #include <memory>
+#include <vector>
 
 #include "base/command_line.h"
 #include "base/files/file_util.h"
@@ -22,14 +23,25 @@
 #else
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <signal.h>
-#include <sys/select.h>
-#include <sys/time.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
 #include "base/posix/eintr_wrapper.h"
 #include "base/posix/file_descriptor_shuffle.h"
+
+// posix_spawn_file_actions_addchdir_np() is needed to start the process in
+// its directory. Elsewhere, the process is started with fork().
+#if defined(OS_LINUX) && defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+#define USE_POSIX_SPAWN 1
+#include <spawn.h>
+
+extern char** environ;
+#else
+#define USE_POSIX_SPAWN 0
+#endif
 #endif
 
 namespace internal {
@@ -144,15 +156,48 @@ bool ExecProcess(const std::u16string& cmdline_str,
 // if the fd is closed or there is an unexpected error (not
 // EINTR/EAGAIN/EWOULDBLOCK).
 bool ReadFromPipe(int fd, std::string* output) {
-  char buffer[256];
-  int bytes_read = HANDLE_EINTR(read(fd, buffer, sizeof(buffer)));
-  if (bytes_read == -1) {
+  // Read as much as a full pipe buffer holds on Linux in one call, and let
+  // the output grow geometrically as it is appended to.
+  char buffer[65536];
+  ssize_t bytes_read = HANDLE_EINTR(read(fd, buffer, sizeof(buffer)));
+  if (bytes_read == -1)
     return errno == EAGAIN || errno == EWOULDBLOCK;
-  } else if (bytes_read <= 0) {
-    return false;
-  }
   output->append(buffer, bytes_read);
-  return true;
+  return bytes_read > 0;
+}
+
+// Reads the output of the child process from both pipes as it comes, until
+// both are closed.
+void ReadFromPipes(int out_fd,
+                   int err_fd,
+                   std::string* std_out,
+                   std::string* std_err) {
+  struct pollfd fds[2] = {{out_fd, POLLIN, 0}, {err_fd, POLLIN, 0}};
+  std::string* outputs[2] = {std_out, std_err};
+  int open_count = 2;
+  while (open_count > 0) {
+    if (HANDLE_EINTR(poll(fds, 2, -1)) <= 0)
+      break;
+    for (int i = 0; i < 2; i++) {
+      if (fds[i].fd < 0 || !fds[i].revents)
+        continue;
+      if (!ReadFromPipe(fds[i].fd, outputs[i])) {
+        // poll() ignores negative fds.
+        fds[i].fd = -1;
+        open_count--;
+      }
+    }
+  }
+}
+
+// Creates a pipe whose fds aren't inherited by the processes started by the
+// other threads meanwhile, which would keep the pipe open until they exit.
+bool CreatePipe(int fds[2]) {
+#if defined(OS_LINUX)
+  return pipe2(fds, O_CLOEXEC) == 0;
+#else
+  return pipe(fds) == 0;
+#endif
 }
 
 bool WaitForExit(int pid, int* exit_code) {
@@ -173,35 +218,53 @@ bool WaitForExit(int pid, int* exit_code) {
   return false;
 }
 
-bool ExecProcess(const base::CommandLine& cmdline,
-                 const base::FilePath& startup_dir,
-                 std::string* std_out,
-                 std::string* std_err,
-                 int* exit_code) {
-  *exit_code = EXIT_FAILURE;
-
-  std::vector<std::string> argv = cmdline.argv();
-
-  int out_fd[2], err_fd[2];
-  pid_t pid;
+#if USE_POSIX_SPAWN
+// Starts the process with posix_spawn(), which glibc implements with a
+// vfork-like clone sharing the memory of gn instead of copying its page
+// tables, which gets slow as gn grows.
+bool LaunchProcess(const std::vector<std::string>& argv,
+                   const base::FilePath& startup_dir,
+                   int out_fd,
+                   int err_fd,
+                   pid_t* pid) {
+  posix_spawn_file_actions_t actions;
+  if (posix_spawn_file_actions_init(&actions) != 0)
+    return false;
+  int result = posix_spawn_file_actions_addchdir_np(
+      &actions, startup_dir.value().c_str());
+  if (result == 0) {
+    result = posix_spawn_file_actions_addopen(&actions, STDIN_FILENO,
+                                              "/dev/null", O_RDONLY, 0);
+  }
+  if (result == 0)
+    result = posix_spawn_file_actions_adddup2(&actions, out_fd, STDOUT_FILENO);
+  if (result == 0)
+    result = posix_spawn_file_actions_adddup2(&actions, err_fd, STDERR_FILENO);
+  if (result == 0) {
+    std::vector<char*> argv_cstr;
+    argv_cstr.reserve(argv.size() + 1);
+    for (const std::string& arg : argv)
+      argv_cstr.push_back(const_cast<char*>(arg.c_str()));
+    argv_cstr.push_back(nullptr);
+    result = posix_spawnp(pid, argv_cstr[0], &actions, nullptr,
+                          argv_cstr.data(), environ);
+  }
+  posix_spawn_file_actions_destroy(&actions);
+  return result == 0;
+}
+#else
+bool LaunchProcess(const std::vector<std::string>& argv,
+                   const base::FilePath& startup_dir,
+                   int out_fd,
+                   int err_fd,
+                   pid_t* pid) {
   base::InjectiveMultimap fd_shuffle1, fd_shuffle2;
   std::unique_ptr<char*[]> argv_cstr(new char*[argv.size() + 1]);
 
   fd_shuffle1.reserve(3);
   fd_shuffle2.reserve(3);
 
-  if (pipe(out_fd) < 0)
-    return false;
-  base::ScopedFD out_read(out_fd[0]), out_write(out_fd[1]);
-
-  if (pipe(err_fd) < 0)
-    return false;
-  base::ScopedFD err_read(err_fd[0]), err_write(err_fd[1]);
-
-  if (out_read.get() >= FD_SETSIZE || err_read.get() >= FD_SETSIZE)
-    return false;
-
-  switch (pid = fork()) {
+  switch (*pid = fork()) {
     case -1:  // error
       return false;
     case 0:  // child
@@ -224,14 +287,12 @@ bool ExecProcess(const base::CommandLine& cmdline,
       // call any previously-registered (in the parent) exit handlers, which
       // might do things like block waiting for threads that don't even exist
       // in the child.
-      int dev_null = open("/dev/null", O_WRONLY);
+      int dev_null = open("/dev/null", O_RDONLY);
       if (dev_null < 0)
         _exit(127);
 
-      fd_shuffle1.push_back(
-          base::InjectionArc(out_write.get(), STDOUT_FILENO, true));
-      fd_shuffle1.push_back(
-          base::InjectionArc(err_write.get(), STDERR_FILENO, true));
+      fd_shuffle1.push_back(base::InjectionArc(out_fd, STDOUT_FILENO, true));
+      fd_shuffle1.push_back(base::InjectionArc(err_fd, STDERR_FILENO, true));
       fd_shuffle1.push_back(base::InjectionArc(dev_null, STDIN_FILENO, true));
       // Adding another element here? Remember to increase the argument to
       // reserve(), above.
@@ -254,39 +315,42 @@ bool ExecProcess(const base::CommandLine& cmdline,
       argv_cstr[argv.size()] = nullptr;
       execvp(argv_cstr[0], argv_cstr.get());
       _exit(127);
-      // Avoid `fall through` warning on some gcc versions.
-      break;
     }
     default:  // parent
-    {
-      // Close our writing end of pipe now. Otherwise later read would not
-      // be able to detect end of child's output (in theory we could still
-      // write to the pipe).
-      out_write.reset();
-      err_write.reset();
-
-      bool out_open = true, err_open = true;
-      while (out_open || err_open) {
-        fd_set read_fds;
-        FD_ZERO(&read_fds);
-        FD_SET(out_read.get(), &read_fds);
-        FD_SET(err_read.get(), &read_fds);
-        int res =
-            HANDLE_EINTR(select(std::max(out_read.get(), err_read.get()) + 1,
-                                &read_fds, nullptr, nullptr, nullptr));
-        if (res <= 0)
-          break;
-        if (FD_ISSET(out_read.get(), &read_fds))
-          out_open = ReadFromPipe(out_read.get(), std_out);
-        if (FD_ISSET(err_read.get(), &read_fds))
-          err_open = ReadFromPipe(err_read.get(), std_err);
-      }
-
-      return WaitForExit(pid, exit_code);
-    }
+      return true;
   }
+}
+#endif  // USE_POSIX_SPAWN
 
-  return false;
+bool ExecProcess(const base::CommandLine& cmdline,
+                 const base::FilePath& startup_dir,
+                 std::string* std_out,
+                 std::string* std_err,
+                 int* exit_code) {
+  *exit_code = EXIT_FAILURE;
+
+  int out_fd[2], err_fd[2];
+  if (!CreatePipe(out_fd))
+    return false;
+  base::ScopedFD out_read(out_fd[0]), out_write(out_fd[1]);
+
+  if (!CreatePipe(err_fd))
+    return false;
+  base::ScopedFD err_read(err_fd[0]), err_write(err_fd[1]);
+
+  pid_t pid;
+  if (!LaunchProcess(cmdline.argv(), startup_dir, out_write.get(),
+                     err_write.get(), &pid))
+    return false;
+
+  // Close our writing end of pipe now. Otherwise later read would not be able
+  // to detect end of child's output (in theory we could still write to the
+  // pipe).
+  out_write.reset();
+  err_write.reset();
+
+  ReadFromPipes(out_read.get(), err_read.get(), std_out, std_err);
+  return WaitForExit(pid, exit_code);
 }
 #endif
 
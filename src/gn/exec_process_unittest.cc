@@ -4,6 +4,8 @@
 
 #include "gn/exec_process.h"
 
+#include <stdlib.h>
+
 #include "base/command_line.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/strings/string_util.h"
@@ -99,6 +101,60 @@ TEST(ExecProcessTest, TestStdoutAndStderrOutput) {
   EXPECT_EQ(10001u, std_err.size());
 }
 
+// Both outputs being larger than a pipe buffer deadlocks unless they are read
+// at the same time.
+TEST(ExecProcessTest, TestLargeStdoutAndStderrOutput) {
+  std::string std_out, std_err;
+  int exit_code;
+
+  ASSERT_TRUE(
+      ExecPython("import sys\n"
+                 "for i in range(100):\n"
+                 "  sys.stdout.write('o' * 10000)\n"
+                 "  sys.stderr.write('e' * 20000)\n",
+                 &std_out, &std_err, &exit_code));
+  EXPECT_EQ(0, exit_code);
+  EXPECT_EQ(std::string(1000000, 'o'), std_out);
+  EXPECT_EQ(std::string(2000000, 'e'), std_err);
+}
+
+TEST(ExecProcessTest, TestStartupDirAndStdin) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::CommandLine::StringVector args = {
+      "python3", "-c",
+      "import os, sys; print(os.path.samefile(os.getcwd(), sys.argv[1])); "
+      "print(len(sys.stdin.read()))",
+      temp_dir.GetPath().value()};
+  std::string std_out, std_err;
+  int exit_code;
+  ASSERT_TRUE(ExecProcess(base::CommandLine(args), temp_dir.GetPath(),
+                          &std_out, &std_err, &exit_code));
+  EXPECT_EQ(0, exit_code);
+  EXPECT_EQ("True\n0\n", std_out);
+}
+
+TEST(ExecProcessTest, TestProgramNotFound) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::CommandLine::StringVector args = {"gn-no-such-program"};
+  std::string std_out, std_err;
+  int exit_code;
+  // posix_spawn() fails to start the process, while a forked child exits
+  // with 127 when exec fails.
+#if defined(OS_LINUX) && defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+  EXPECT_FALSE(ExecProcess(base::CommandLine(args), temp_dir.GetPath(),
+                           &std_out, &std_err, &exit_code));
+#else
+  {
+    ASSERT_TRUE(ExecProcess(base::CommandLine(args), temp_dir.GetPath(),
+                            &std_out, &std_err, &exit_code));
+    EXPECT_EQ(127, exit_code);
+  }
+#endif
+}
+
 TEST(ExecProcessTest, TestOneOutputClosed) {
   std::string std_out, std_err;
   int exit_code;
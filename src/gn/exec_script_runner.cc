@@ -0,0 +1,143 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/exec_script_runner.h"
+
+#include <algorithm>
+
+#include "base/files/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/values.h"
+#include "gn/exec_process.h"
+#include "gn/filesystem_utils.h"
+#include "util/atomic_write.h"
+#include "util/sys_info.h"
+#include "util/worker_pool.h"
+
+namespace {
+
+// Changing the format of the record must change this so that older records
+// are ignored.
+const int kVersion = 1;
+
+}  // namespace
+
+const char ExecScriptRunner::kRecordFileName[] = ".gn_exec_script_record";
+
+ExecScriptRunner::ExecScriptRunner() = default;
+
+ExecScriptRunner::~ExecScriptRunner() {
+  // Wait for the processes still running, which use the members.
+  pool_.reset();
+}
+
+ExecScriptRunner::Result ExecScriptRunner::Run(
+    const base::CommandLine& cmdline,
+    const base::FilePath& startup_dir) {
+  Command command(cmdline.argv(), startup_dir);
+
+  WorkerPool::ScopedBlockingWait blocking_wait;
+  std::unique_lock<std::mutex> lock(lock_);
+  std::shared_ptr<Job> job;
+  auto found = prefetched_.find(command);
+  if (found != prefetched_.end()) {
+    job = std::move(found->second);
+    prefetched_.erase(found);
+  } else {
+    job = StartLocked(cmdline, startup_dir);
+  }
+  commands_.push_back(std::move(command));
+
+  job_done_.wait(lock, [&job]() { return job->done; });
+  return std::move(job->result);
+}
+
+void ExecScriptRunner::Prefetch(const base::FilePath& record_file) {
+  std::string contents;
+  if (!base::ReadFileToString(record_file, &contents))
+    return;
+  std::unique_ptr<base::Value> record = base::JSONReader::Read(contents);
+  if (!record || !record->is_dict())
+    return;
+  const base::Value* version =
+      record->FindKeyOfType("version", base::Value::Type::INTEGER);
+  const base::Value* commands =
+      record->FindKeyOfType("commands", base::Value::Type::LIST);
+  if (!version || version->GetInt() != kVersion || !commands)
+    return;
+
+  std::lock_guard<std::mutex> lock(lock_);
+  for (const base::Value& command : commands->GetList()) {
+    // Each command is a list of its directory then its arguments.
+    if (!command.is_list() || command.GetList().size() < 2)
+      continue;
+    const auto& strings = command.GetList();
+    if (!std::all_of(strings.begin(), strings.end(),
+                     [](const base::Value& value) {
+                       return value.is_string();
+                     }))
+      continue;
+
+    base::FilePath startup_dir = UTF8ToFilePath(strings[0].GetString());
+    base::CommandLine cmdline(base::CommandLine::NO_PROGRAM);
+    cmdline.SetParseSwitches(false);
+    cmdline.SetProgram(base::FilePath(
+        base::CommandLine::UTF8ToStringType(strings[1].GetString())));
+    for (size_t i = 2; i < strings.size(); i++) {
+      cmdline.AppendArgNative(
+          base::CommandLine::UTF8ToStringType(strings[i].GetString()));
+    }
+    prefetched_.emplace(Command(cmdline.argv(), startup_dir),
+                        StartLocked(cmdline, startup_dir));
+  }
+}
+
+bool ExecScriptRunner::SaveRecord(const base::FilePath& record_file) const {
+  base::Value record(base::Value::Type::DICTIONARY);
+  record.SetKey("version", base::Value(kVersion));
+
+  base::Value command_list(base::Value::Type::LIST);
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    for (const Command& command : commands_) {
+      base::Value strings(base::Value::Type::LIST);
+      strings.GetList().emplace_back(FilePathToUTF8(command.second));
+      for (const base::CommandLine::StringType& arg : command.first) {
+        strings.GetList().emplace_back(
+            base::CommandLine::StringTypeToUTF8(arg));
+      }
+      command_list.GetList().push_back(std::move(strings));
+    }
+  }
+  record.SetKey("commands", std::move(command_list));
+
+  std::string contents;
+  if (!base::JSONWriter::Write(record, &contents))
+    return false;
+  return util::WriteFileAtomically(record_file, contents.data(),
+                                   static_cast<int>(contents.size())) ==
+         static_cast<int>(contents.size());
+}
+
+std::shared_ptr<ExecScriptRunner::Job> ExecScriptRunner::StartLocked(
+    const base::CommandLine& cmdline,
+    const base::FilePath& startup_dir) {
+  if (!pool_)
+    pool_ = std::make_unique<WorkerPool>(std::max(NumberOfProcessors(), 1));
+
+  auto job = std::make_shared<Job>();
+  pool_->PostTask([this, job, cmdline, startup_dir]() {
+    Result result;
+    result.launched =
+        internal::ExecProcess(cmdline, startup_dir, &result.std_out,
+                              &result.std_err, &result.exit_code);
+
+    std::lock_guard<std::mutex> lock(lock_);
+    job->result = std::move(result);
+    job->done = true;
+    job_done_.notify_all();
+  });
+  return job;
+}
@@ -0,0 +1,92 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_EXEC_SCRIPT_RUNNER_H_
+#define TOOLS_GN_EXEC_SCRIPT_RUNNER_H_
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+
+class WorkerPool;
+
+// Runs the processes of exec_script() calls.
+//
+// The processes run on a pool of threads of their own, which limits how many
+// run at once. The thread calling Run() waits for its process without holding
+// a thread of the scheduler's pool, which starts another thread to keep
+// running the other loads meanwhile (see WorkerPool::ScopedBlockingWait).
+//
+// The commands run can be recorded in the build directory, and the next run
+// can prefetch them: they are started as soon as the load begins, and the
+// calls running the same command in the same directory later wait for their
+// result instead of running it again.
+class ExecScriptRunner {
+ public:
+  struct Result {
+    // False if the process couldn't be started.
+    bool launched = false;
+    std::string std_out;
+    std::string std_err;
+    int exit_code = 0;
+  };
+
+  // Name of the file in the root build directory recording the commands.
+  static const char kRecordFileName[];
+
+  ExecScriptRunner();
+  ~ExecScriptRunner();
+
+  // Runs |cmdline| in |startup_dir| and waits for the process to exit.
+  Result Run(const base::CommandLine& cmdline,
+             const base::FilePath& startup_dir);
+
+  // Starts the commands recorded in |record_file| by SaveRecord(), if it
+  // exists. Each started command can be used by one call to Run().
+  void Prefetch(const base::FilePath& record_file);
+
+  // Writes the commands passed to Run() so far to |record_file|.
+  bool SaveRecord(const base::FilePath& record_file) const;
+
+ private:
+  // A command line and the directory it runs in.
+  using Command = std::pair<base::CommandLine::StringVector, base::FilePath>;
+
+  // A process started on the pool. Protected by |lock_|.
+  struct Job {
+    bool done = false;
+    Result result;
+  };
+
+  // Starts running |cmdline| on the pool. Must be called with |lock_| held.
+  std::shared_ptr<Job> StartLocked(const base::CommandLine& cmdline,
+                                   const base::FilePath& startup_dir);
+
+  mutable std::mutex lock_;
+
+  // Signaled when a job is done.
+  std::condition_variable job_done_;
+
+  // Created when the first command is started, to not start any thread for
+  // the many loads which don't run scripts.
+  std::unique_ptr<WorkerPool> pool_;
+
+  // The jobs started by Prefetch() that weren't used by Run() yet.
+  std::multimap<Command, std::shared_ptr<Job>> prefetched_;
+
+  // The commands passed to Run(), for the record.
+  std::vector<Command> commands_;
+
+  ExecScriptRunner(const ExecScriptRunner&) = delete;
+  ExecScriptRunner& operator=(const ExecScriptRunner&) = delete;
+};
+
+#endif  // TOOLS_GN_EXEC_SCRIPT_RUNNER_H_
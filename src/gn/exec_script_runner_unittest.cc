@@ -0,0 +1,99 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/exec_script_runner.h"
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "util/build_config.h"
+#include "util/test/test.h"
+
+// Like ExecProcessTest, these run python, which isn't runnable on Windows.
+#if !defined(OS_WIN)
+namespace {
+
+base::CommandLine PythonCommandLine(const std::string& command) {
+  base::CommandLine cmdline(base::CommandLine::NO_PROGRAM);
+  cmdline.SetParseSwitches(false);
+  cmdline.SetProgram(base::FilePath("python3"));
+  cmdline.AppendArg("-c");
+  cmdline.AppendArg(command);
+  return cmdline;
+}
+
+}  // namespace
+
+TEST(ExecScriptRunner, Run) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  ExecScriptRunner runner;
+
+  ExecScriptRunner::Result result = runner.Run(
+      PythonCommandLine("import sys; print('out'); sys.exit(3)"),
+      temp_dir.GetPath());
+  EXPECT_TRUE(result.launched);
+  EXPECT_EQ("out\n", result.std_out);
+  EXPECT_EQ(3, result.exit_code);
+
+  result = runner.Run(PythonCommandLine("print('again')"), temp_dir.GetPath());
+  EXPECT_TRUE(result.launched);
+  EXPECT_EQ("again\n", result.std_out);
+  EXPECT_EQ(0, result.exit_code);
+}
+
+TEST(ExecScriptRunner, Prefetch) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath record_file =
+      temp_dir.GetPath().AppendASCII(ExecScriptRunner::kRecordFileName);
+
+  // Each run of the script appends a line to a file.
+  base::CommandLine cmdline = PythonCommandLine(
+      "open('runs', 'a').write('run\\n'); print('result')");
+  {
+    ExecScriptRunner runner;
+    EXPECT_EQ("result\n", runner.Run(cmdline, temp_dir.GetPath()).std_out);
+    ASSERT_TRUE(runner.SaveRecord(record_file));
+  }
+
+  std::string runs;
+  base::FilePath runs_file = temp_dir.GetPath().AppendASCII("runs");
+  ASSERT_TRUE(base::ReadFileToString(runs_file, &runs));
+  EXPECT_EQ("run\n", runs);
+
+  // The next runner starts the recorded command, and running it again uses
+  // the result instead of running it a second time. Running it once more
+  // runs it again.
+  {
+    ExecScriptRunner runner;
+    runner.Prefetch(record_file);
+    EXPECT_EQ("result\n", runner.Run(cmdline, temp_dir.GetPath()).std_out);
+    ASSERT_TRUE(base::ReadFileToString(runs_file, &runs));
+    EXPECT_EQ("run\nrun\n", runs);
+
+    EXPECT_EQ("result\n", runner.Run(cmdline, temp_dir.GetPath()).std_out);
+    ASSERT_TRUE(base::ReadFileToString(runs_file, &runs));
+    EXPECT_EQ("run\nrun\nrun\n", runs);
+  }
+
+  // A command run in another directory doesn't use the prefetched one, which
+  // still runs.
+  {
+    base::ScopedTempDir other_dir;
+    ASSERT_TRUE(other_dir.CreateUniqueTempDir());
+    ExecScriptRunner runner;
+    runner.Prefetch(record_file);
+    EXPECT_EQ("result\n", runner.Run(cmdline, other_dir.GetPath()).std_out);
+  }
+  ASSERT_TRUE(base::ReadFileToString(runs_file, &runs));
+  EXPECT_EQ("run\nrun\nrun\nrun\n", runs);
+
+  // Missing or invalid records are ignored.
+  ExecScriptRunner runner;
+  runner.Prefetch(temp_dir.GetPath().AppendASCII("missing"));
+  ASSERT_TRUE(base::WriteFile(record_file, "{\"version\": 1", 13) == 13);
+  runner.Prefetch(record_file);
+  EXPECT_EQ("result\n", runner.Run(cmdline, temp_dir.GetPath()).std_out);
+}
+#endif  // !defined(OS_WIN)
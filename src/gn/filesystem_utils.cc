@@ -359,6 +359,26 @@ bool IsPathSourceAbsolute(std::string_view path) {
   return (path.size() >= 2 && path[0] == '/' && path[1] == '/');
 }
 
+bool IsPathNormalizedRelative(std::string_view path) {
+  if (path.empty() || path[0] == '/' || IsPathAbsolute(path))
+    return false;
+  for (size_t i = 0; i < path.size(); i++) {
+    char c = path[i];
+    if (c == '\\')
+      return false;
+    if (c == '/' && i + 1 < path.size() && path[i + 1] == '/')
+      return false;
+    if (c == '.' && (i == 0 || path[i - 1] == '/')) {
+      size_t end = i + 1;
+      if (end < path.size() && path[end] == '.')
+        end++;
+      if (end == path.size() || path[end] == '/')
+        return false;
+    }
+  }
+  return true;
+}
+
 bool MakeAbsolutePathRelativeIfPossible(std::string_view source_root,
                                         std::string_view path,
                                         std::string* dest) {
@@ -684,6 +704,45 @@ std::string RegulatePathIfAbsolute(std::string_view path) {
 }
 #endif
 
+// Appends the path of |input| relative to the directory |dest| to |result|.
+// The paths must already be in a comparable form, see MakeRelativePath().
+void AppendRelativePath(std::string_view input,
+                        std::string_view dest,
+                        std::string* result) {
+  DCHECK(EndsWithSlash(dest));
+  size_t start = result->size();
+
+  // Skip the common prefixes of the source and dest as long as they end in
+  // a [back]slash or end the string. dest always ends with a (back)slash in
+  // this function, so checking dest for just that is sufficient.
+  size_t common_prefix_len = 0;
+  size_t max_common_length = std::min(input.size(), dest.size());
+  for (size_t i = common_prefix_len; i <= max_common_length; i++) {
+    if (dest.size() == i)
+      break;
+    if ((input.size() == i || IsSlash(input[i])) && IsSlash(dest[i]))
+      common_prefix_len = i + 1;
+    else if (input.size() == i || input[i] != dest[i])
+      break;
+  }
+
+  // Invert the dest dir starting from the end of the common prefix.
+  for (size_t i = common_prefix_len; i < dest.size(); i++) {
+    if (IsSlash(dest[i]))
+      result->append("../");
+  }
+
+  // Append any remaining unique input.
+  if (common_prefix_len <= input.size())
+    result->append(input.begin() + common_prefix_len, input.end());
+  else if (input.back() != '/' && result->size() > start)
+    result->pop_back();
+
+  // If nothing was appended, the paths are the same.
+  if (result->size() == start)
+    result->push_back('.');
+}
+
 std::string MakeRelativePath(std::string_view input,
                              std::string_view dest) {
 #if defined(OS_WIN)
@@ -713,94 +772,104 @@ std::string MakeRelativePath(std::string_view input,
   }
 #endif
 
-  DCHECK(EndsWithSlash(dest));
   std::string ret;
-
-  // Skip the common prefixes of the source and dest as long as they end in
-  // a [back]slash or end the string. dest always ends with a (back)slash in
-  // this function, so checking dest for just that is sufficient.
-  size_t common_prefix_len = 0;
-  size_t max_common_length = std::min(input.size(), dest.size());
-  for (size_t i = common_prefix_len; i <= max_common_length; i++) {
-    if (dest.size() == i)
-      break;
-    if ((input.size() == i || IsSlash(input[i])) && IsSlash(dest[i]))
-      common_prefix_len = i + 1;
-    else if (input.size() == i || input[i] != dest[i])
-      break;
-  }
-
-  // Invert the dest dir starting from the end of the common prefix.
-  for (size_t i = common_prefix_len; i < dest.size(); i++) {
-    if (IsSlash(dest[i]))
-      ret.append("../");
-  }
-
-  // Append any remaining unique input.
-  if (common_prefix_len <= input.size())
-    ret.append(input.begin() + common_prefix_len, input.end());
-  else if (input.back() != '/' && !ret.empty())
-    ret.pop_back();
-
-  // If the result is still empty, the paths are the same.
-  if (ret.empty())
-    ret.push_back('.');
-
+  AppendRelativePath(input, dest, &ret);
   return ret;
 }
 
-std::string RebasePath(const std::string& input,
-                       const SourceDir& dest_dir,
-                       std::string_view source_root) {
-  std::string ret;
+PathRebaser::PathRebaser(const SourceDir& dest_dir,
+                         std::string_view source_root)
+    : dest_dir_(dest_dir), source_root_(source_root) {
   DCHECK(source_root.empty() || !source_root.ends_with("/"));
+  if (source_root.empty())
+    return;
 
-  bool input_is_source_path =
-      (input.size() >= 2 && input[0] == '/' && input[1] == '/');
+  if (dest_dir.is_source_absolute()) {
+    dest_full_.append(source_root);
+    dest_full_.push_back('/');
+    dest_full_.append(dest_dir.value(), 2, std::string::npos);
+  } else {
+#if defined(OS_WIN)
+    // On Windows, SourceDir system-absolute paths start
+    // with /, e.g. "/C:/foo/bar".
+    const std::string& value = dest_dir.value();
+    if (value.size() > 2 && value[2] == ':')
+      dest_full_.append(dest_dir.value().substr(1));
+    else
+      dest_full_.append(dest_dir.value());
+#else
+    dest_full_.append(dest_dir.value());
+#endif
+  }
+}
 
-  if (!source_root.empty() &&
-      (!input_is_source_path || !dest_dir.is_source_absolute())) {
+void PathRebaser::Append(std::string_view input, std::string* result) const {
+  bool input_is_source_path = IsPathSourceAbsolute(input);
+
+  if (!source_root_.empty() &&
+      (!input_is_source_path || !dest_dir_.is_source_absolute())) {
     std::string input_full;
-    std::string dest_full;
     if (input_is_source_path) {
-      input_full.append(source_root);
+      input_full.append(source_root_);
       input_full.push_back('/');
-      input_full.append(input, 2, std::string::npos);
+      input_full.append(input.substr(2));
     } else {
       input_full.append(input);
     }
-    if (dest_dir.is_source_absolute()) {
-      dest_full.append(source_root);
-      dest_full.push_back('/');
-      dest_full.append(dest_dir.value(), 2, std::string::npos);
-    } else {
-#if defined(OS_WIN)
-      // On Windows, SourceDir system-absolute paths start
-      // with /, e.g. "/C:/foo/bar".
-      const std::string& value = dest_dir.value();
-      if (value.size() > 2 && value[2] == ':')
-        dest_full.append(dest_dir.value().substr(1));
-      else
-        dest_full.append(dest_dir.value());
-#else
-      dest_full.append(dest_dir.value());
-#endif
-    }
     bool remove_slash = false;
     if (!EndsWithSlash(input_full)) {
       input_full.push_back('/');
       remove_slash = true;
     }
-    ret = MakeRelativePath(input_full, dest_full);
-    if (remove_slash && ret.size() > 1)
-      ret.pop_back();
-    return ret;
+    size_t start = result->size();
+#if defined(OS_WIN)
+    result->append(MakeRelativePath(input_full, dest_full_));
+#else
+    AppendRelativePath(input_full, dest_full_, result);
+#endif
+    if (remove_slash && result->size() - start > 1)
+      result->pop_back();
+    return;
   }
 
-  ret = MakeRelativePath(input, dest_dir.value());
+#if defined(OS_WIN)
+  result->append(MakeRelativePath(input, dest_dir_.value()));
+#else
+  AppendRelativePath(input, dest_dir_.value(), result);
+#endif
+}
+
+std::string RebasePath(const std::string& input,
+                       const SourceDir& dest_dir,
+                       std::string_view source_root) {
+  // Both paths are already comparable in the common case.
+  if (source_root.empty() ||
+      (IsPathSourceAbsolute(input) && dest_dir.is_source_absolute()))
+    return MakeRelativePath(input, dest_dir.value());
+
+  std::string ret;
+  PathRebaser(dest_dir, source_root).Append(input, &ret);
   return ret;
 }
 
+void AppendRebasedPath(const std::string& input,
+                       const SourceDir& dest_dir,
+                       std::string_view source_root,
+                       std::string* result) {
+#if !defined(OS_WIN)
+  // The common case of both paths being source-absolute needs no temporary
+  // strings, see RebasePath().
+  bool input_is_source_path =
+      (input.size() >= 2 && input[0] == '/' && input[1] == '/');
+  if (source_root.empty() ||
+      (input_is_source_path && dest_dir.is_source_absolute())) {
+    AppendRelativePath(input, dest_dir.value(), result);
+    return;
+  }
+#endif
+  PathRebaser(dest_dir, source_root).Append(input, result);
+}
+
 base::FilePath ResolvePath(const std::string& value,
                            bool as_file,
                            const base::FilePath& source_root) {
@@ -834,6 +903,18 @@ std::string ResolveRelative(std::string_view input,
                             std::string_view source_root) {
   std::string result;
 
+  // Fast path for the most common case, like the names in a "sources" list,
+  // that doesn't need any normalization or source root handling.
+  if (IsPathSourceAbsolute(value) && EndsWithSlash(value) &&
+      IsPathNormalizedRelative(input)) {
+    result.reserve(value.size() + input.size() + 1);
+    result.assign(value);
+    result.append(input.data(), input.size());
+    if (!as_file && !EndsWithSlash(result))
+      result.push_back('/');
+    return result;
+  }
+
   if (input.size() >= 2 && input[0] == '/' && input[1] == '/') {
     // Source-relative.
     result.assign(input.data(), input.size());
@@ -103,6 +103,11 @@ bool IsPathAbsolute(std::string_view path);
 // relative to the source root.
 bool IsPathSourceAbsolute(std::string_view path);
 
+// Returns true if the input string is a relative path that NormalizePath()
+// wouldn't change: it has no "." or ".." components, no backslashes and no
+// repeated slashes.
+bool IsPathNormalizedRelative(std::string_view path);
+
 // Given an absolute path, checks to see if is it is inside the source root.
 // If it is, fills a source-absolute path into the given output and returns
 // true. If it isn't, clears the dest and returns false.
@@ -151,6 +156,35 @@ std::string RebasePath(const std::string& input,
                        const SourceDir& dest_dir,
                        std::string_view source_root = std::string_view());
 
+// Rebases many paths to the same directory, like RebasePath(). The absolute
+// form of the destination directory is computed once, and the results are
+// appended to a string without temporaries when the paths are
+// source-absolute.
+class PathRebaser {
+ public:
+  // See RebasePath() for the parameters.
+  PathRebaser(const SourceDir& dest_dir, std::string_view source_root);
+
+  // Appends the path of |input| relative to the destination directory to
+  // |result|.
+  void Append(std::string_view input, std::string* result) const;
+
+ private:
+  SourceDir dest_dir_;
+  std::string source_root_;
+
+  // The system-absolute path of |dest_dir_|. Only used when there is a
+  // source root.
+  std::string dest_full_;
+};
+
+// Like RebasePath but appends the result to |result|. Avoids the temporary
+// strings RebasePath() needs when both paths are source-absolute.
+void AppendRebasedPath(const std::string& input,
+                       const SourceDir& dest_dir,
+                       std::string_view source_root,
+                       std::string* result);
+
 // Resolves a file or dir name (parameter input) relative to
 // value directory. Will return an empty SourceDir/File on error
 // and set the give *err pointer (required). Empty input is always an error.
@@ -141,6 +141,29 @@ TEST(FilesystemUtils, IsPathAbsolute) {
 #endif
 }
 
+TEST(FilesystemUtils, IsPathNormalizedRelative) {
+  EXPECT_TRUE(IsPathNormalizedRelative("foo"));
+  EXPECT_TRUE(IsPathNormalizedRelative("foo/bar.cc"));
+  EXPECT_TRUE(IsPathNormalizedRelative(".foo/bar..cc"));
+  EXPECT_TRUE(IsPathNormalizedRelative("foo/..."));
+  EXPECT_TRUE(IsPathNormalizedRelative("foo/"));
+
+  EXPECT_FALSE(IsPathNormalizedRelative(""));
+  EXPECT_FALSE(IsPathNormalizedRelative("/foo"));
+  EXPECT_FALSE(IsPathNormalizedRelative("//foo"));
+  EXPECT_FALSE(IsPathNormalizedRelative("."));
+  EXPECT_FALSE(IsPathNormalizedRelative("./foo"));
+  EXPECT_FALSE(IsPathNormalizedRelative("foo/."));
+  EXPECT_FALSE(IsPathNormalizedRelative("../foo"));
+  EXPECT_FALSE(IsPathNormalizedRelative("foo/../bar"));
+  EXPECT_FALSE(IsPathNormalizedRelative("foo/.."));
+  EXPECT_FALSE(IsPathNormalizedRelative("foo//bar"));
+  EXPECT_FALSE(IsPathNormalizedRelative("foo\\bar"));
+#if defined(OS_WIN)
+  EXPECT_FALSE(IsPathNormalizedRelative("C:/foo"));
+#endif
+}
+
 TEST(FilesystemUtils, MakeAbsolutePathRelativeIfPossible) {
   std::string dest;
 
@@ -564,6 +587,35 @@ TEST(FilesystemUtils, RebasePath) {
 #endif
 }
 
+TEST(FilesystemUtils, PathRebaser) {
+  std::string_view source_root("/source/root");
+  const char* inputs[] = {"//",         "//foo",   "//foo/",
+                          "//a/b/foo",  "//a/b/",  "//a/c/d",
+                          "/source/x",  "/other/", "/source/root/a/b/c"};
+  const char* dirs[] = {"//", "//a/b/", "//out/Debug/", "/source/", "/other/"};
+
+  for (const char* dir : dirs) {
+    PathRebaser rebaser(SourceDir(dir), source_root);
+    for (const char* input : inputs) {
+      std::string result = "prefix ";
+      rebaser.Append(input, &result);
+      EXPECT_EQ("prefix " + RebasePath(input, SourceDir(dir), source_root),
+                result)
+          << input << " " << dir;
+    }
+  }
+
+  PathRebaser rebaser(SourceDir("//out/Debug/"), source_root);
+  std::string result;
+  rebaser.Append("//a/b", &result);
+  EXPECT_EQ("../../a/b", result);
+#if !defined(OS_WIN)
+  result.clear();
+  rebaser.Append("/source/other/file", &result);
+  EXPECT_EQ("../../../other/file", result);
+#endif
+}
+
 TEST(FilesystemUtils, DirectoryWithNoLastSlash) {
   EXPECT_EQ("", DirectoryWithNoLastSlash(SourceDir()));
   EXPECT_EQ("/.", DirectoryWithNoLastSlash(SourceDir("/")));
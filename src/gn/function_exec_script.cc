@@ -8,7 +8,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "gn/err.h"
-#include "gn/exec_process.h"
+#include "gn/exec_script_runner.h"
 #include "gn/filesystem_utils.h"
 #include "gn/functions.h"
 #include "gn/input_conversion.h"
@@ -231,18 +231,17 @@ Value RunExecScript(Scope* scope,
 
   // Execute the process.
   // TODO(brettw) set the environment block.
-  std::string output;
-  std::string stderr_output;
-  int exit_code = 0;
-  {
-    if (!internal::ExecProcess(cmdline, startup_dir, &output, &stderr_output,
-                               &exit_code)) {
-      *err = Err(function->function(), "Could not execute interpreter.",
-                 "I was trying to execute \"" +
-                     FilePathToUTF8(interpreter_path) + "\".");
-      return Value();
-    }
+  ExecScriptRunner::Result result =
+      g_scheduler->exec_script_runner()->Run(cmdline, startup_dir);
+  if (!result.launched) {
+    *err = Err(function->function(), "Could not execute interpreter.",
+               "I was trying to execute \"" +
+                   FilePathToUTF8(interpreter_path) + "\".");
+    return Value();
   }
+  const std::string& output = result.std_out;
+  const std::string& stderr_output = result.std_err;
+  int exit_code = result.exit_code;
   if (g_scheduler->verbose_logging()) {
     g_scheduler->Log(
         "Executing",
@@ -4,15 +4,21 @@
 
 #include <stddef.h>
 
+#include <memory>
+#include <optional>
+#include <vector>
+
 #include "gn/build_settings.h"
 #include "gn/filesystem_utils.h"
 #include "gn/functions.h"
+#include "gn/hash_table_base.h"
 #include "gn/parse_tree.h"
 #include "gn/scope.h"
 #include "gn/settings.h"
 #include "gn/source_dir.h"
 #include "gn/source_file.h"
 #include "gn/value.h"
+#include "util/build_config.h"
 
 namespace functions {
 
@@ -53,12 +59,116 @@ bool ValueLooksLikeDir(const std::string& value) {
   return false;
 }
 
+// A cache of the paths converted by rebase_path(), keyed by the input string
+// and the source and destination directories. Build files and templates
+// rebase the same lists of paths, like the sources of a target, over and
+// over. Each thread has its own cache.
+class RebaseCache {
+ public:
+  // Returns the conversion of |input| from |from_dir| to |to_dir|, or null if
+  // it isn't cached. |to_dir| is null for system-absolute conversions.
+  const std::string* Find(const SourceDir& from_dir,
+                          const SourceDir& to_dir,
+                          std::string_view source_root,
+                          std::string_view input) {
+    if (source_root != source_root_) {
+      // Only tests use different source roots in the same process.
+      Clear();
+      source_root_.assign(source_root);
+    }
+    Key key{&from_dir.value(), &to_dir.value(), input};
+    Node* node = set_.Lookup(key.Hash(), key);
+    return node->is_valid() ? &node->entry->result : nullptr;
+  }
+
+  void Add(const SourceDir& from_dir,
+           const SourceDir& to_dir,
+           std::string_view input,
+           const std::string& result) {
+    if (entries_.size() >= kMaxEntries)
+      Clear();
+    Key key{&from_dir.value(), &to_dir.value(), input};
+    size_t hash = key.Hash();
+    Node* node = set_.Lookup(hash, key);
+    if (node->is_valid())
+      return;
+    entries_.push_back(std::make_unique<Entry>(
+        Entry{key.from_dir, key.to_dir, std::string(input), result}));
+    set_.Insert(node, hash, entries_.back().get());
+  }
+
+ private:
+  static constexpr size_t kMaxEntries = 1 << 16;
+
+  struct Key {
+    const std::string* from_dir;
+    const std::string* to_dir;
+    std::string_view input;
+
+    size_t Hash() const {
+      size_t h = std::hash<std::string_view>()(input);
+      h = h * 131 + std::hash<const std::string*>()(from_dir);
+      return h * 131 + std::hash<const std::string*>()(to_dir);
+    }
+  };
+
+  struct Entry {
+    const std::string* from_dir;
+    const std::string* to_dir;
+    std::string input;
+    std::string result;
+  };
+
+  struct Node {
+    size_t hash;
+    Entry* entry;
+
+    // The following methods are required by HashTableBase<>
+    bool is_valid() const { return !is_null(); }
+    bool is_null() const { return !entry; }
+    size_t hash_value() const { return hash; }
+    static constexpr bool is_tombstone() { return false; }
+  };
+
+  struct EntrySet : public HashTableBase<Node> {
+    Node* Lookup(size_t hash, const Key& key) const {
+      return NodeLookup(hash, [&](const Node* node) {
+        const Entry* entry = node->entry;
+        return node->hash == hash && entry->from_dir == key.from_dir &&
+               entry->to_dir == key.to_dir && entry->input == key.input;
+      });
+    }
+
+    void Insert(Node* node, size_t hash, Entry* entry) {
+      node->hash = hash;
+      node->entry = entry;
+      UpdateAfterInsert();
+    }
+
+    void Clear() { NodeClear(); }
+  };
+
+  void Clear() {
+    set_.Clear();
+    entries_.clear();
+  }
+
+  std::string source_root_;
+  EntrySet set_;
+  std::vector<std::unique_ptr<Entry>> entries_;
+};
+
+#if !defined(OS_ZOS)
+thread_local RebaseCache s_rebase_cache;
+#endif
+
+// Converts one path. |rebaser| is null when converting to system-absolute
+// paths.
 Value ConvertOnePath(const Scope* scope,
                      const FunctionCallNode* function,
                      const Value& value,
                      const SourceDir& from_dir,
-                     const SourceDir& to_dir,
-                     bool convert_to_system_absolute,
+                     const PathRebaser* rebaser,
                      Err* err) {
   Value result;  // Ensure return value optimization.
 
@@ -69,7 +179,7 @@ Value ConvertOnePath(const Scope* scope,
   bool looks_like_dir = ValueLooksLikeDir(string_value);
 
   // System-absolute output special case.
-  if (convert_to_system_absolute) {
+  if (!rebaser) {
     base::FilePath system_path;
     if (looks_like_dir) {
       system_path = scope->settings()->build_settings()->GetFullPath(
@@ -93,27 +203,50 @@ Value ConvertOnePath(const Scope* scope,
 
   result = Value(function, Value::STRING);
   if (looks_like_dir) {
-    result.string_value() = RebasePath(
-        from_dir
-            .ResolveRelativeDir(
-                value, err,
-                scope->settings()->build_settings()->root_path_utf8())
-            .value(),
-        to_dir, scope->settings()->build_settings()->root_path_utf8());
+    SourceDir resolved_dir = from_dir.ResolveRelativeDir(
+        value, err, scope->settings()->build_settings()->root_path_utf8());
+    rebaser->Append(resolved_dir.value(), &result.string_value());
     MakeSlashEndingMatchInput(string_value, &result.string_value());
   } else {
     SourceFile resolved_file = from_dir.ResolveRelativeFile(
         value, err, scope->settings()->build_settings()->root_path_utf8());
     if (err->has_error())
       return Value();
-    result.string_value() =
-        RebasePath(resolved_file.value(), to_dir,
-                   scope->settings()->build_settings()->root_path_utf8());
+    rebaser->Append(resolved_file.value(), &result.string_value());
   }
 
   return result;
 }
 
+// Like ConvertOnePath() but uses the thread's cache.
+Value ConvertOnePathCached(const Scope* scope,
+                           const FunctionCallNode* function,
+                           const Value& value,
+                           const SourceDir& from_dir,
+                           const SourceDir& to_dir,
+                           const PathRebaser* rebaser,
+                           Err* err) {
+#if !defined(OS_ZOS)
+  if (value.type() != Value::STRING)
+    return ConvertOnePath(scope, function, value, from_dir, rebaser, err);
+
+  std::string_view source_root =
+      scope->settings()->build_settings()->root_path_utf8();
+  if (const std::string* cached = s_rebase_cache.Find(
+          from_dir, to_dir, source_root, value.string_value()))
+    return Value(function, *cached);
+
+  Value result = ConvertOnePath(scope, function, value, from_dir, rebaser, err);
+  if (!err->has_error()) {
+    s_rebase_cache.Add(from_dir, to_dir, value.string_value(),
+                       result.string_value());
+  }
+  return result;
+#else
+  return ConvertOnePath(scope, function, value, from_dir, rebaser, err);
+#endif
+}
+
 }  // namespace
 
 const char kRebasePath[] = "rebase_path";
@@ -260,10 +393,18 @@ Value RunRebasePath(Scope* scope,
     from_dir = current_dir;
   }
 
-  // Path conversion.
+  // Path conversion. The relation between the directories is computed once
+  // for all the inputs.
+  std::optional<PathRebaser> rebaser;
+  if (!convert_to_system_absolute) {
+    rebaser.emplace(to_dir,
+                    scope->settings()->build_settings()->root_path_utf8());
+  }
+  const PathRebaser* rebaser_ptr = rebaser ? &*rebaser : nullptr;
+
   if (inputs.type() == Value::STRING) {
-    return ConvertOnePath(scope, function, inputs, from_dir, to_dir,
-                          convert_to_system_absolute, err);
+    return ConvertOnePathCached(scope, function, inputs, from_dir, to_dir,
+                                rebaser_ptr, err);
 
   } else if (inputs.type() == Value::LIST) {
     result = Value(function, Value::LIST);
@@ -271,8 +412,8 @@ Value RunRebasePath(Scope* scope,
 
     for (const auto& input : inputs.list_value()) {
       result.list_value().push_back(
-          ConvertOnePath(scope, function, input, from_dir, to_dir,
-                         convert_to_system_absolute, err));
+          ConvertOnePathCached(scope, function, input, from_dir, to_dir,
+                               rebaser_ptr, err));
       if (err->has_error()) {
         result = Value();
         return result;
@@ -171,6 +171,28 @@ TEST(RebasePath, List) {
   EXPECT_EQ("../../gn/bar.txt", ret.list_value()[1].string_value());
 }
 
+// rebase_path() caches its results. Checks that the same inputs are
+// converted correctly with other directories.
+TEST(RebasePath, Repeated) {
+  TestWithScope setup;
+  Scope* scope = setup.scope();
+
+  for (int round = 0; round < 2; round++) {
+    scope->set_source_dir(SourceDir("//a/"));
+    EXPECT_EQ("../../a/foo.txt",
+              RebaseOne(scope, "foo.txt", "//out/Debug", "."));
+    EXPECT_EQ("../a/foo.txt", RebaseOne(scope, "foo.txt", "//out", "."));
+    EXPECT_EQ("../../b/foo.txt",
+              RebaseOne(scope, "foo.txt", "//out/Debug", "//b"));
+    EXPECT_EQ("../../a/dir/", RebaseOne(scope, "dir/", "//out/Debug", "."));
+    EXPECT_EQ("../../a/dir", RebaseOne(scope, "dir", "//out/Debug", "."));
+
+    scope->set_source_dir(SourceDir("//c/"));
+    EXPECT_EQ("../../c/foo.txt",
+              RebaseOne(scope, "foo.txt", "//out/Debug", "."));
+  }
+}
+
 TEST(RebasePath, Errors) {
   TestWithScope setup;
 
@@ -493,13 +493,29 @@ class HashTableBase {
     return false;
   }
 
+  // Grow the table, if needed, so that it can hold |count| keys without
+  // being resized again. Use this before inserting many keys at once.
+  // Return true to indicate that existing iterators were invalidated.
+  bool NodeReserve(size_t count) {
+    size_t new_size = size_ == 1 ? 8 : size_;
+    while (count * 4 >= new_size * 3)
+      new_size *= 2;
+    if (new_size == size_)
+      return false;
+    ResizeBuckets(new_size);
+    return true;
+  }
+
  private:
 #if defined(__GNUC__) || defined(__clang__)
   [[gnu::noinline]]
 #endif
   void GrowBuckets() {
+    ResizeBuckets((size_ == 1) ? 8 : size_ * 2);
+  }
+
+  void ResizeBuckets(size_t new_size) {
     size_t size = size_;
-    size_t new_size = (size == 1) ? 8 : size * 2;
     size_t new_mask = new_size - 1;
 
     // NOTE: Using calloc() since no object constructiopn can or should take
@@ -165,6 +165,9 @@ class TestHashTable : public HashTableBase<TestHashNode> {
     return true;
   }
 
+  // Make room for |count| items. Return true if the table was resized.
+  bool reserve(size_t count) { return NodeReserve(count); }
+
   // Remove all items
   void clear() {
     // Remove all pointed objects, since NodeClear() will not do it.
@@ -231,6 +234,28 @@ TEST(HashTableBaseTest, InsertionsAndLookups) {
   EXPECT_EQ(Int::destruction_counter, 3u);
 }
 
+TEST(HashTableBaseTest, Reserve) {
+  Int::ResetCounters();
+  {
+    TestHashTable table;
+    table.insert(1);
+    EXPECT_TRUE(table.reserve(100));
+    EXPECT_FALSE(table.reserve(100));
+    EXPECT_FALSE(table.reserve(10));
+    EXPECT_TRUE(table.contains(1));
+
+    for (int x = 2; x <= 100; ++x)
+      table.insert(x);
+    EXPECT_EQ(table.size(), 100u);
+    EXPECT_FALSE(table.reserve(100));
+    for (int x = 1; x <= 100; ++x)
+      EXPECT_TRUE(table.contains(x));
+  }
+
+  EXPECT_EQ(Int::creation_counter, 100u);
+  EXPECT_EQ(Int::destruction_counter, 100u);
+}
+
 TEST(HashTableBaseTest, CopyAssignment) {
   Int::ResetCounters();
   {
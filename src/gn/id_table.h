@@ -0,0 +1,107 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_ID_TABLE_H_
+#define TOOLS_GN_ID_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+// Containers indexed by dense integer IDs, such as the ones returned by
+// Item::id(). They replace sets and maps keyed by pointers in graph walks:
+// a lookup is an array access instead of hashing a pointer or walking a
+// tree, and the storage is a flat array.
+//
+// Both grow on demand to hold the largest ID used, so their size is
+// proportional to the number of IDs allocated when they are used for all the
+// items of a build. For walks that only visit a few items, construct them
+// with the ID count up front (see Item::GetIdCount()) to avoid reallocations,
+// or prefer a PointerSet when the graph is large but the walk is short.
+
+// A set of IDs, stored as a bitmap.
+class IdBitSet {
+ public:
+  IdBitSet() = default;
+
+  // Makes room for the IDs below |count|.
+  explicit IdBitSet(size_t count)
+      : words_((count + kWordBits - 1) / kWordBits) {}
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  bool contains(size_t id) const {
+    size_t index = id / kWordBits;
+    return index < words_.size() && (words_[index] & Bit(id)) != 0;
+  }
+
+  // Adds |id| to the set. Returns true if it wasn't already in it.
+  bool add(size_t id) {
+    size_t index = id / kWordBits;
+    if (index >= words_.size())
+      words_.resize(index + 1);
+    uint64_t& word = words_[index];
+    if (word & Bit(id))
+      return false;
+    word |= Bit(id);
+    size_++;
+    return true;
+  }
+
+  // Removes |id| from the set. Returns true if it was in it.
+  bool erase(size_t id) {
+    if (!contains(id))
+      return false;
+    words_[id / kWordBits] &= ~Bit(id);
+    size_--;
+    return true;
+  }
+
+  // Removes all IDs, keeping the storage for reuse.
+  void clear() {
+    std::fill(words_.begin(), words_.end(), 0);
+    size_ = 0;
+  }
+
+ private:
+  static constexpr size_t kWordBits = 64;
+
+  static uint64_t Bit(size_t id) { return uint64_t(1) << (id % kWordBits); }
+
+  std::vector<uint64_t> words_;
+  size_t size_ = 0;
+};
+
+// Maps IDs to values of type T. IDs that were never assigned map to a
+// value-initialized T.
+template <typename T>
+class IdTable {
+ public:
+  IdTable() = default;
+
+  // Makes room for the IDs below |count|.
+  explicit IdTable(size_t count) : values_(count) {}
+
+  // Returns the value of |id|, adding it if needed.
+  T& operator[](size_t id) {
+    if (id >= values_.size())
+      values_.resize(id + 1);
+    return values_[id];
+  }
+
+  // Returns the value of |id|, or a value-initialized T if it was never
+  // assigned.
+  T get(size_t id) const { return id < values_.size() ? values_[id] : T(); }
+
+  // Removes all values, keeping the storage for reuse.
+  void clear() { std::fill(values_.begin(), values_.end(), T()); }
+
+ private:
+  std::vector<T> values_;
+};
+
+#endif  // TOOLS_GN_ID_TABLE_H_
@@ -0,0 +1,74 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/id_table.h"
+
+#include "gn/target.h"
+#include "gn/test_with_scope.h"
+#include "util/test/test.h"
+
+TEST(IdBitSet, AddEraseContains) {
+  IdBitSet set;
+  EXPECT_TRUE(set.empty());
+  EXPECT_FALSE(set.contains(0));
+  EXPECT_FALSE(set.contains(1000));
+
+  EXPECT_TRUE(set.add(3));
+  EXPECT_FALSE(set.add(3));
+  EXPECT_TRUE(set.add(64));
+  EXPECT_TRUE(set.add(1000));
+  EXPECT_EQ(3u, set.size());
+  EXPECT_TRUE(set.contains(3));
+  EXPECT_TRUE(set.contains(64));
+  EXPECT_TRUE(set.contains(1000));
+  EXPECT_FALSE(set.contains(63));
+  EXPECT_FALSE(set.contains(65));
+
+  EXPECT_TRUE(set.erase(64));
+  EXPECT_FALSE(set.erase(64));
+  EXPECT_FALSE(set.erase(5000));
+  EXPECT_FALSE(set.contains(64));
+  EXPECT_EQ(2u, set.size());
+
+  set.clear();
+  EXPECT_TRUE(set.empty());
+  EXPECT_FALSE(set.contains(3));
+  EXPECT_TRUE(set.add(3));
+
+  IdBitSet reserved(100);
+  EXPECT_TRUE(reserved.empty());
+  EXPECT_TRUE(reserved.add(99));
+  EXPECT_TRUE(reserved.add(100));
+}
+
+TEST(IdTable, Values) {
+  IdTable<int> table(4);
+  EXPECT_EQ(0, table.get(2));
+  EXPECT_EQ(0, table.get(100));
+
+  table[2] = 5;
+  table[100] = 7;
+  EXPECT_EQ(5, table.get(2));
+  EXPECT_EQ(7, table.get(100));
+  EXPECT_EQ(0, table.get(99));
+
+  table.clear();
+  EXPECT_EQ(0, table.get(2));
+  EXPECT_EQ(0, table.get(100));
+}
+
+TEST(IdTable, ItemIds) {
+  TestWithScope setup;
+  TestTarget a(setup, "//foo:a", Target::SOURCE_SET);
+  TestTarget b(setup, "//foo:b", Target::SOURCE_SET);
+
+  EXPECT_NE(a.id(), b.id());
+  EXPECT_LT(a.id(), Item::GetIdCount());
+  EXPECT_LT(b.id(), Item::GetIdCount());
+
+  IdBitSet seen;
+  EXPECT_TRUE(seen.add(a.id()));
+  EXPECT_TRUE(seen.contains(a.id()));
+  EXPECT_FALSE(seen.contains(b.id()));
+}
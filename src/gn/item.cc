@@ -4,19 +4,33 @@
 
 #include "gn/item.h"
 
+#include <atomic>
+
 #include "base/logging.h"
 #include "gn/settings.h"
 
+namespace {
+
+std::atomic<uint32_t> g_next_item_id;
+
+}  // namespace
+
 Item::Item(const Settings* settings,
            const Label& label,
            const SourceFileSet& build_dependency_files)
     : settings_(settings),
+      id_(g_next_item_id.fetch_add(1, std::memory_order_relaxed)),
       label_(label),
       build_dependency_files_(build_dependency_files),
       defined_from_(nullptr) {}
 
 Item::~Item() = default;
 
+// static
+size_t Item::GetIdCount() {
+  return g_next_item_id.load(std::memory_order_relaxed);
+}
+
 Config* Item::AsConfig() {
   return nullptr;
 }
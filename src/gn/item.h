@@ -5,6 +5,9 @@
 #ifndef TOOLS_GN_ITEM_H_
 #define TOOLS_GN_ITEM_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <set>
 #include <string>
 
@@ -31,6 +34,17 @@ class Item {
 
   const Settings* settings() const { return settings_; }
 
+  // A small integer identifying this item, assigned in creation order and
+  // unique across all the items of the process. Use it to index IdBitSet
+  // and IdTable (see id_table.h) instead of keying containers by pointer.
+  // The order depends on thread scheduling, so it must not be used to order
+  // any output.
+  uint32_t id() const { return id_; }
+
+  // Returns an upper bound of the IDs of the items created so far, to size
+  // ID-indexed tables.
+  static size_t GetIdCount();
+
   // This is guaranteed to never change after construction so this can be
   // accessed from any thread with no locking once the item is constructed.
   const Label& label() const { return label_; }
@@ -75,12 +89,16 @@ class Item {
   bool CheckTestonly(Err* err) const;
 
   const Settings* settings_;
+  const uint32_t id_;
   Label label_;
   SourceFileSet build_dependency_files_;
   const ParseNode* defined_from_;
 
   bool testonly_ = false;
   Visibility visibility_;
+
+  Item(const Item&) = delete;
+  Item& operator=(const Item&) = delete;
 };
 
 #endif  // TOOLS_GN_ITEM_H_
@@ -5,14 +5,18 @@
 #include "gn/json_project_writer.h"
 
 #include <algorithm>
+#include <functional>
+#include <map>
 #include <memory>
-#include <unordered_map>
+#include <set>
+#include <utility>
 #include <vector>
 
 #include "base/command_line.h"
+#include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
+#include "base/files/file_util.h"
 #include "base/json/json_writer.h"
-#include "base/json/string_escape.h"
 #include "gn/builder.h"
 #include "gn/commands.h"
 #include "gn/deps_iterator.h"
@@ -21,7 +25,9 @@
 #include "gn/invoke_python.h"
 #include "gn/scheduler.h"
 #include "gn/settings.h"
+#include "gn/simple_json_writer.h"
 #include "gn/string_output_buffer.h"
+#include "util/worker_pool.h"
 
 // Structure of JSON output file
 // {
@@ -35,7 +41,20 @@
 //      "target y full label" : { target y properties },
 //      ...
 //    }
+//   "toolchains" : {
+//      "toolchain x full label" : { tools of toolchain x },
+//      ...
+//    }
 // }
+//
+// When the targets are split by directory, "targets" is replaced by
+//   "target_files" : {
+//      "directory" : "file listing the targets of the directory
+//                     (relative to build_dir)",
+//      ...
+//    }
+// and each of these files holds the "targets" of its directory.
+//
 // See desc_builder.cc for overview of target properties
 
 namespace {
@@ -83,261 +102,87 @@ bool FilterTargets(const BuildSettings* build_settings,
   return true;
 }
 
-}  // namespace
-
-bool JSONProjectWriter::RunAndWriteFiles(
-    const BuildSettings* build_settings,
-    const Builder& builder,
-    const std::string& file_name,
-    const std::string& exec_script,
-    const std::string& exec_script_extra_args,
-    const std::string& dir_filter_string,
-    bool quiet,
-    Err* err) {
-  SourceFile output_file = build_settings->build_dir().ResolveRelativeFile(
-      Value(nullptr, file_name), err);
-  if (output_file.is_null()) {
-    return false;
-  }
-
-  base::FilePath output_path = build_settings->GetFullPath(output_file);
+// Number of targets whose descriptions are rendered by one task. Chunks are
+// rendered in parallel, a window of them at a time so that only that much of
+// the output is held in memory before being added to the file.
+constexpr size_t kTargetsPerChunk = 16;
+constexpr size_t kChunksPerWindow = 256;
 
-  std::vector<const Target*> all_targets = builder.GetAllResolvedTargets();
-  std::vector<const Target*> targets;
-  if (!FilterTargets(build_settings, all_targets, &targets, dir_filter_string,
-                     err)) {
-    return false;
-  }
-
-  StringOutputBuffer json = GenerateJSON(build_settings, targets);
-  if (!json.ContentsEqual(output_path)) {
-    if (!json.WriteToFile(output_path, err)) {
-      return false;
-    }
+// A target with its user-visible label, which is its key in the output.
+struct LabeledTarget {
+  std::string label;
+  const Target* target;
+};
 
-    if (!exec_script.empty()) {
-      SourceFile script_file;
-      if (exec_script[0] != '/') {
-        // Relative path, assume the base is in build_dir.
-        script_file = build_settings->build_dir().ResolveRelativeFile(
-            Value(nullptr, exec_script), err);
-        if (script_file.is_null()) {
-          return false;
-        }
-      } else {
-        script_file = SourceFile(exec_script);
-      }
-      base::FilePath script_path = build_settings->GetFullPath(script_file);
-      return internal::InvokePython(build_settings, script_path,
-                                    exec_script_extra_args, output_path, quiet,
-                                    err);
-    }
+// Returns |targets| sorted according to their human visible labels.
+std::vector<LabeledTarget> SortTargets(
+    const std::vector<const Target*>& targets,
+    const Label& default_toolchain_label) {
+  std::vector<LabeledTarget> result;
+  result.reserve(targets.size());
+  for (const Target* target : targets) {
+    result.push_back(
+        {target->label().GetUserVisibleName(default_toolchain_label), target});
   }
-
-  return true;
+  std::sort(result.begin(), result.end(),
+            [](const LabeledTarget& a, const LabeledTarget& b) {
+              return a.label < b.label;
+            });
+  return result;
 }
 
-namespace {
-
-// NOTE: Intentional macro definition allows compile-time string concatenation.
-// (see usage below).
-#if defined(OS_WINDOWS)
-#define LINE_ENDING "\r\n"
-#else
-#define LINE_ENDING "\n"
-#endif
-
-// Helper class to output a, potentially very large, JSON file to a
-// StringOutputBuffer. Note that sorting the keys, if desired, is left to
-// the user (unlike base::JSONWriter). This allows rendering to be performed
-// in series of incremental steps. Usage is:
-//
-//   1) Create instance, passing a StringOutputBuffer reference as the
-//      destination.
-//
-//   2) Add keys and values using one of the following:
-//
-//       a) AddString(key, string_value) to add one string value.
-//
-//       b) BeginList(key), AddListItem(), EndList() to add a string list.
-//          NOTE: Only lists of strings are supported here.
-//
-//       c) BeginDict(key), ... add other keys, followed by EndDict() to add
-//          a dictionary key.
-//
-//   3) Call Close() or destroy the instance to finalize the output.
-//
-class SimpleJSONWriter {
- public:
-  // Constructor.
-  SimpleJSONWriter(StringOutputBuffer& out) : out_(out) {
-    out_ << "{" LINE_ENDING;
-    SetIndentation(1u);
-  }
-
-  // Destructor.
-  ~SimpleJSONWriter() { Close(); }
-
-  // Closing finalizes the output.
-  void Close() {
-    if (indentation_ > 0) {
-      DCHECK(indentation_ == 1u);
-      if (comma_.size())
-        out_ << LINE_ENDING;
-
-      out_ << "}" LINE_ENDING;
-      SetIndentation(0);
-    }
-  }
-
-  // Add new string-valued key.
-  void AddString(std::string_view key, std::string_view value) {
-    if (comma_.size()) {
-      out_ << comma_;
-    }
-    AddMargin() << Escape(key) << ": " << Escape(value);
-    comma_ = "," LINE_ENDING;
-  }
-
-  // Begin a new list. Must be followed by zero or more AddListItem() calls,
-  // then by EndList().
-  void BeginList(std::string_view key) {
-    if (comma_.size())
-      out_ << comma_;
-    AddMargin() << Escape(key) << ": [ ";
-    comma_ = {};
-  }
-
-  // Add a new list item. For now only string values are supported.
-  void AddListItem(std::string_view item) {
-    if (comma_.size())
-      out_ << comma_;
-    out_ << Escape(item);
-    comma_ = ", ";
-  }
-
-  // End current list.
-  void EndList() {
-    out_ << " ]";
-    comma_ = "," LINE_ENDING;
-  }
-
-  // Begin new dictionaary. Must be followed by zero or more other key
-  // additions, then a call to EndDict().
-  void BeginDict(std::string_view key) {
-    if (comma_.size())
-      out_ << comma_;
-
-    AddMargin() << Escape(key) << ": {";
-    SetIndentation(indentation_ + 1);
-    comma_ = LINE_ENDING;
-  }
-
-  // End current dictionary.
-  void EndDict() {
-    if (comma_.size())
-      out_ << LINE_ENDING;
-
-    SetIndentation(indentation_ - 1);
-    AddMargin() << "}";
-    comma_ = "," LINE_ENDING;
-  }
-
-  // Add a dictionary-valued key, whose value is already formatted as a valid
-  // JSON string. Useful to insert the output of base::JSONWriter::Write()
-  // into the target buffer.
-  void AddJSONDict(std::string_view key, std::string_view json) {
-    if (comma_.size())
-      out_ << comma_;
-    AddMargin() << Escape(key) << ": ";
-    if (json.empty()) {
-      out_ << "{ }";
-    } else {
-      DCHECK(json[0] == '{');
-      bool first_line = true;
-      do {
-        size_t line_end = json.find('\n');
-
-        // NOTE: Do not add margin if original input line is empty.
-        // This needs to deal with CR/LF which are part of |json| on Windows
-        // only, due to the way base::JSONWriter::Write() is implemented.
-        bool line_empty = (line_end == 0 || (line_end == 1 && json[0] == '\r'));
-        if (!first_line && !line_empty)
-          AddMargin();
-
-        if (line_end == std::string_view::npos) {
-          out_ << json;
-          comma_ = {};
-          return;
-        }
-        // Important: do not add the final newline.
-        out_ << json.substr(
-            0, (line_end == json.size() - 1) ? line_end : line_end + 1);
-        json.remove_prefix(line_end + 1);
-        first_line = false;
-      } while (!json.empty());
-    }
-    comma_ = "," LINE_ENDING;
+// Returns the pretty-printed JSON description of |target|.
+std::string RenderTargetJSON(const Target* target) {
+  auto description =
+      DescBuilder::DescriptionForTarget(target, "", false, false, false);
+  // Outputs need to be asked for separately.
+  auto outputs = DescBuilder::DescriptionForTarget(target, "source_outputs",
+                                                   false, false, false);
+  base::DictionaryValue* outputs_value = nullptr;
+  if (outputs->GetDictionary("source_outputs", &outputs_value) &&
+      !outputs_value->empty()) {
+    description->MergeDictionary(outputs.get());
   }
 
- private:
-  // Return the JSON-escape version of |str|.
-  static std::string Escape(std::string_view str) {
-    std::string result;
-    base::EscapeJSONString(str, true, &result);
-    return result;
-  }
+  std::string json_dict;
+  base::JSONWriter::WriteWithOptions(
+      *description.get(), base::JSONWriter::OPTIONS_PRETTY_PRINT, &json_dict);
+  return json_dict;
+}
 
-  // Adjust indentation level.
-  void SetIndentation(size_t indentation) { indentation_ = indentation; }
-
-  // Append margin, and return reference to output buffer.
-  StringOutputBuffer& AddMargin() const {
-    static const char kMargin[17] = "                ";
-    size_t margin_len = indentation_ * 3;
-    while (margin_len > 0) {
-      size_t span = (margin_len > 16u) ? 16u : margin_len;
-      out_.Append(kMargin, span);
-      margin_len -= span;
+// Renders the descriptions of |targets| and calls |add| with each of them, in
+// order. Rendering the descriptions dominates, so it is done in parallel.
+void RenderTargets(
+    const std::vector<LabeledTarget>& targets,
+    const std::function<void(const LabeledTarget&, const std::string&)>& add) {
+  size_t chunk_count =
+      (targets.size() + kTargetsPerChunk - 1) / kTargetsPerChunk;
+  for (size_t window_begin = 0; window_begin < chunk_count;
+       window_begin += kChunksPerWindow) {
+    size_t window_size =
+        std::min(kChunksPerWindow, chunk_count - window_begin);
+    size_t first = window_begin * kTargetsPerChunk;
+    size_t count =
+        std::min(window_size * kTargetsPerChunk, targets.size() - first);
+    std::vector<std::string> rendered(count);
+    WorkerPool::GetShared().ParallelFor(window_size, [&](size_t i) {
+      size_t begin = i * kTargetsPerChunk;
+      size_t end = std::min(begin + kTargetsPerChunk, count);
+      for (size_t j = begin; j < end; j++)
+        rendered[j] = RenderTargetJSON(targets[first + j].target);
+    });
+
+    for (size_t i = 0; i < count; i++) {
+      add(targets[first + i], rendered[i]);
+      // Release the memory as soon as possible.
+      std::string().swap(rendered[i]);
     }
-    return out_;
   }
+}
 
-  size_t indentation_ = 0;
-  std::string_view comma_;
-  StringOutputBuffer& out_;
-};
-
-}  // namespace
-
-StringOutputBuffer JSONProjectWriter::GenerateJSON(
-    const BuildSettings* build_settings,
-    std::vector<const Target*>& all_targets) {
-  Label default_toolchain_label;
-  if (!all_targets.empty())
-    default_toolchain_label =
-        all_targets[0]->settings()->default_toolchain_label();
-
-  StringOutputBuffer out;
-
-  // Sort the targets according to their human visible labels first.
-  std::unordered_map<const Target*, std::string> target_labels;
-  for (const Target* target : all_targets) {
-    target_labels[target] =
-        target->label().GetUserVisibleName(default_toolchain_label);
-  }
-
-  std::vector<const Target*> sorted_targets(all_targets.begin(),
-                                            all_targets.end());
-  std::sort(sorted_targets.begin(), sorted_targets.end(),
-            [&target_labels](const Target* a, const Target* b) {
-              return target_labels[a] < target_labels[b];
-            });
-
-  SimpleJSONWriter json_writer(out);
-
-  // IMPORTANT: Keep the keys sorted when adding them to |json_writer|.
-
+void WriteBuildSettings(const BuildSettings* build_settings,
+                        const Label& default_toolchain_label,
+                        SimpleJSONWriter& json_writer) {
   json_writer.BeginDict("build_settings");
   {
     json_writer.AddString("build_dir", build_settings->build_dir().value());
@@ -376,31 +221,15 @@ StringOutputBuffer JSONProjectWriter::GenerateJSON(
     json_writer.AddString("root_path", build_settings->root_path_utf8());
   }
   json_writer.EndDict();  // build_settings
+}
 
+void WriteToolchains(const std::vector<LabeledTarget>& targets,
+                     SimpleJSONWriter& json_writer) {
   std::map<Label, const Toolchain*> toolchains;
-  json_writer.BeginDict("targets");
-  {
-    for (const auto* target : sorted_targets) {
-      auto description =
-          DescBuilder::DescriptionForTarget(target, "", false, false, false);
-      // Outputs need to be asked for separately.
-      auto outputs = DescBuilder::DescriptionForTarget(target, "source_outputs",
-                                                       false, false, false);
-      base::DictionaryValue* outputs_value = nullptr;
-      if (outputs->GetDictionary("source_outputs", &outputs_value) &&
-          !outputs_value->empty()) {
-        description->MergeDictionary(outputs.get());
-      }
-
-      std::string json_dict;
-      base::JSONWriter::WriteWithOptions(*description.get(),
-                                         base::JSONWriter::OPTIONS_PRETTY_PRINT,
-                                         &json_dict);
-      json_writer.AddJSONDict(target_labels[target], json_dict);
-      toolchains[target->toolchain()->label()] = target->toolchain();
-    }
+  for (const LabeledTarget& labeled : targets) {
+    toolchains[labeled.target->toolchain()->label()] =
+        labeled.target->toolchain();
   }
-  json_writer.EndDict();  // targets
 
   json_writer.BeginDict("toolchains");
   {
@@ -455,6 +284,220 @@ StringOutputBuffer JSONProjectWriter::GenerateJSON(
     }
   }
   json_writer.EndDict();  // toolchains
+}
+
+// Returns the path of the file listing the targets of |dir| in split mode,
+// relative to the directory holding these files.
+std::string GetSplitFileForDir(const SourceDir& dir) {
+  std::string result;
+  const std::string& value = dir.value();
+  if (dir.is_source_absolute()) {
+    result.assign(value, 2, std::string::npos);
+  } else {
+    // System-absolute directories are put aside, without the drive letter
+    // colon on Windows.
+    result = "_absolute/";
+    for (size_t i = 1; i < value.size(); i++) {
+      if (value[i] != ':')
+        result.push_back(value[i]);
+    }
+  }
+  result.append("targets.json");
+  return result;
+}
+
+Label GetDefaultToolchainLabel(const std::vector<const Target*>& targets) {
+  if (targets.empty())
+    return Label();
+  return targets[0]->settings()->default_toolchain_label();
+}
+
+}  // namespace
+
+bool JSONProjectWriter::RemoveStaleFiles(
+    const base::FilePath& dir,
+    const std::set<base::FilePath>& kept_files) {
+  bool removed = false;
+  base::FileEnumerator files(dir, true, base::FileEnumerator::FILES);
+  for (base::FilePath path = files.Next(); !path.empty(); path = files.Next()) {
+    // The enumerator appends names with the native separator.
+    if (!kept_files.count(path.NormalizePathSeparatorsTo('/'))) {
+      base::DeleteFile(path, false);
+      removed = true;
+    }
+  }
+  return removed;
+}
+
+bool JSONProjectWriter::RunAndWriteFiles(
+    const BuildSettings* build_settings,
+    const Builder& builder,
+    const std::string& file_name,
+    const std::string& exec_script,
+    const std::string& exec_script_extra_args,
+    const std::string& dir_filter_string,
+    bool split_by_dir,
+    bool quiet,
+    Err* err) {
+  SourceFile output_file = build_settings->build_dir().ResolveRelativeFile(
+      Value(nullptr, file_name), err);
+  if (output_file.is_null()) {
+    return false;
+  }
+
+  base::FilePath output_path = build_settings->GetFullPath(output_file);
+
+  std::vector<const Target*> all_targets = builder.GetAllResolvedTargets();
+  std::vector<const Target*> targets;
+  if (!FilterTargets(build_settings, all_targets, &targets, dir_filter_string,
+                     err)) {
+    return false;
+  }
+
+  bool written;
+  if (split_by_dir) {
+    // The directory files go next to the index file, in a directory named
+    // after it. The suffix keeps the two apart when the file name has no
+    // extension.
+    std::string split_dir = file_name + ".d/";
+
+    DirFiles dir_files;
+    StringOutputBuffer json =
+        GenerateSplitJSON(build_settings, targets, split_dir, &dir_files);
+    if (!json.WriteToFileIfChanged(output_path, err, &written))
+      return false;
+    std::set<base::FilePath> dir_file_paths;
+    for (auto& pair : dir_files) {
+      SourceFile dir_file = build_settings->build_dir().ResolveRelativeFile(
+          Value(nullptr, pair.first), err);
+      if (dir_file.is_null())
+        return false;
+      base::FilePath dir_file_path = build_settings->GetFullPath(dir_file);
+      bool dir_file_written;
+      if (!pair.second->WriteToFileIfChanged(dir_file_path, err,
+                                             &dir_file_written))
+        return false;
+      written |= dir_file_written;
+      dir_file_paths.insert(std::move(dir_file_path));
+    }
+
+    // Remove the files of the directories which no longer have targets.
+    SourceDir split_source_dir =
+        build_settings->build_dir().ResolveRelativeDir(
+            Value(nullptr, split_dir), err);
+    if (split_source_dir.is_null())
+      return false;
+    if (RemoveStaleFiles(build_settings->GetFullPath(split_source_dir),
+                         dir_file_paths))
+      written = true;
+  } else {
+    StringOutputBuffer json = GenerateJSON(build_settings, targets);
+    if (!json.WriteToFileIfChanged(output_path, err, &written))
+      return false;
+  }
+
+  if (written && !exec_script.empty()) {
+    SourceFile script_file;
+    if (exec_script[0] != '/') {
+      // Relative path, assume the base is in build_dir.
+      script_file = build_settings->build_dir().ResolveRelativeFile(
+          Value(nullptr, exec_script), err);
+      if (script_file.is_null()) {
+        return false;
+      }
+    } else {
+      script_file = SourceFile(exec_script);
+    }
+    base::FilePath script_path = build_settings->GetFullPath(script_file);
+    return internal::InvokePython(build_settings, script_path,
+                                  exec_script_extra_args, output_path, quiet,
+                                  err);
+  }
+
+  return true;
+}
+
+StringOutputBuffer JSONProjectWriter::GenerateJSON(
+    const BuildSettings* build_settings,
+    std::vector<const Target*>& all_targets) {
+  Label default_toolchain_label = GetDefaultToolchainLabel(all_targets);
+  std::vector<LabeledTarget> sorted_targets =
+      SortTargets(all_targets, default_toolchain_label);
+
+  StringOutputBuffer out;
+  SimpleJSONWriter json_writer(out);
+
+  // IMPORTANT: Keep the keys sorted when adding them to |json_writer|.
+
+  WriteBuildSettings(build_settings, default_toolchain_label, json_writer);
+
+  json_writer.BeginDict("targets");
+  RenderTargets(sorted_targets, [&json_writer](const LabeledTarget& labeled,
+                                               const std::string& json) {
+    json_writer.AddJSONDict(labeled.label, json);
+  });
+  json_writer.EndDict();  // targets
+
+  WriteToolchains(sorted_targets, json_writer);
+
+  json_writer.Close();
+
+  return out;
+}
+
+StringOutputBuffer JSONProjectWriter::GenerateSplitJSON(
+    const BuildSettings* build_settings,
+    std::vector<const Target*>& all_targets,
+    const std::string& split_dir,
+    DirFiles* dir_files) {
+  Label default_toolchain_label = GetDefaultToolchainLabel(all_targets);
+  std::vector<LabeledTarget> sorted_targets =
+      SortTargets(all_targets, default_toolchain_label);
+
+  // Labels starting with their directory, the targets of a directory are
+  // contiguous in |sorted_targets| (targets in other toolchains included).
+  // Each directory file is completed before starting the next one.
+  std::map<std::string, std::string> target_files;
+  const SourceDir* current_dir = nullptr;
+  std::unique_ptr<StringOutputBuffer> current;
+  std::unique_ptr<SimpleJSONWriter> writer;
+  auto finish_dir_file = [&]() {
+    writer->EndDict();  // targets
+    writer->Close();
+    writer.reset();
+    std::string file = split_dir + GetSplitFileForDir(*current_dir);
+    target_files[current_dir->value()] = file;
+    dir_files->emplace_back(std::move(file), std::move(current));
+  };
+  RenderTargets(sorted_targets, [&](const LabeledTarget& labeled,
+                                    const std::string& json) {
+    const SourceDir& dir = labeled.target->label().dir();
+    if (!current_dir || *current_dir != dir) {
+      if (writer)
+        finish_dir_file();
+      current_dir = &dir;
+      current = std::make_unique<StringOutputBuffer>();
+      writer = std::make_unique<SimpleJSONWriter>(*current);
+      writer->BeginDict("targets");
+    }
+    writer->AddJSONDict(labeled.label, json);
+  });
+  if (writer)
+    finish_dir_file();
+
+  StringOutputBuffer out;
+  SimpleJSONWriter json_writer(out);
+
+  // IMPORTANT: Keep the keys sorted when adding them to |json_writer|.
+
+  WriteBuildSettings(build_settings, default_toolchain_label, json_writer);
+
+  json_writer.BeginDict("target_files");
+  for (const auto& pair : target_files)
+    json_writer.AddString(pair.first, pair.second);
+  json_writer.EndDict();  // target_files
+
+  WriteToolchains(sorted_targets, json_writer);
 
   json_writer.Close();
 
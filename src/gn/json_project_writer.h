@@ -5,6 +5,13 @@
 #ifndef TOOLS_GN_JSON_WRITER_H_
 #define TOOLS_GN_JSON_WRITER_H_
 
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
 #include "gn/err.h"
 #include "gn/target.h"
 
@@ -20,6 +27,7 @@ class JSONProjectWriter {
                                const std::string& exec_script,
                                const std::string& exec_script_extra_args,
                                const std::string& dir_filter_string,
+                               bool split_by_dir,
                                bool quiet,
                                Err* err);
 
@@ -27,11 +35,32 @@ class JSONProjectWriter {
   FRIEND_TEST_ALL_PREFIXES(JSONWriter, ActionWithResponseFile);
   FRIEND_TEST_ALL_PREFIXES(JSONWriter, ForEachWithResponseFile);
   FRIEND_TEST_ALL_PREFIXES(JSONWriter, RustTarget);
+  FRIEND_TEST_ALL_PREFIXES(JSONWriter, SplitByDir);
+  FRIEND_TEST_ALL_PREFIXES(JSONWriter, RemoveStaleFiles);
+
+  // The files of the targets of each directory, with their paths.
+  using DirFiles =
+      std::vector<std::pair<std::string, std::unique_ptr<StringOutputBuffer>>>;
 
   static StringOutputBuffer GenerateJSON(
       const BuildSettings* build_settings,
       std::vector<const Target*>& all_targets);
 
+  // Like GenerateJSON(), but the descriptions of the targets of each
+  // directory are added to |dir_files| instead, with the paths of their files
+  // relative to the build directory, in |split_dir|. The returned index lists
+  // these paths.
+  static StringOutputBuffer GenerateSplitJSON(
+      const BuildSettings* build_settings,
+      std::vector<const Target*>& all_targets,
+      const std::string& split_dir,
+      DirFiles* dir_files);
+
+  // Deletes the files under |dir| which are not in |kept_files|, whose paths
+  // use '/' separators. Returns whether any file was deleted.
+  static bool RemoveStaleFiles(const base::FilePath& dir,
+                               const std::set<base::FilePath>& kept_files);
+
   static std::string RenderJSON(const BuildSettings* build_settings,
                                 std::vector<const Target*>& all_targets);
 };
@@ -3,7 +3,16 @@
 // found in the LICENSE file.
 
 #include "gn/json_project_writer.h"
+
+#include <memory>
+#include <set>
+#include <utility>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "gn/string_output_buffer.h"
 #include "gn/substitution_list.h"
 #include "gn/target.h"
 #include "gn/test_with_scheduler.h"
@@ -753,3 +762,95 @@ TEST_F(JSONWriter, ForEachWithResponseFile) {
 )_";
   EXPECT_EQ(expected_json, out) << out;
 }
+
+TEST_F(JSONWriter, SplitByDir) {
+  Err err;
+  TestWithScope setup;
+
+  // Enough targets for their descriptions to be rendered by several tasks.
+  const char* const kDirs[] = {"//foo/", "//foo/bar/", "//baz/"};
+  std::vector<std::unique_ptr<Target>> storage;
+  std::vector<const Target*> targets;
+  for (int i = 0; i < 20; i++) {
+    for (const char* dir : kDirs) {
+      auto target = std::make_unique<Target>(
+          setup.settings(),
+          Label(SourceDir(dir), "t" + base::IntToString(i)));
+      target->set_output_type(Target::GROUP);
+      target->SetToolchain(setup.toolchain());
+      ASSERT_TRUE(target->OnResolved(&err));
+      targets.push_back(target.get());
+      storage.push_back(std::move(target));
+    }
+  }
+
+  std::string whole =
+      JSONProjectWriter::RenderJSON(setup.build_settings(), targets);
+
+  JSONProjectWriter::DirFiles dir_files;
+  std::string index = JSONProjectWriter::GenerateSplitJSON(
+                          setup.build_settings(), targets, "project/",
+                          &dir_files)
+                          .str();
+#if defined(OS_WIN)
+  base::ReplaceSubstringsAfterOffset(&whole, 0, "\r\n", "\n");
+  base::ReplaceSubstringsAfterOffset(&index, 0, "\r\n", "\n");
+#endif
+
+  // The index lists the files instead of the targets.
+  EXPECT_EQ(std::string::npos, index.find("\"targets\""));
+  EXPECT_NE(std::string::npos, index.find(R"_(   "target_files": {
+      "//baz/": "project/baz/targets.json",
+      "//foo/": "project/foo/targets.json",
+      "//foo/bar/": "project/foo/bar/targets.json"
+   },
+   "toolchains": {
+)_"));
+
+  // The files hold the same descriptions as the whole file, in the same
+  // order ("//foo/bar:" sorts before "//foo:").
+  ASSERT_EQ(3u, dir_files.size());
+  EXPECT_EQ("project/baz/targets.json", dir_files[0].first);
+  EXPECT_EQ("project/foo/bar/targets.json", dir_files[1].first);
+  EXPECT_EQ("project/foo/targets.json", dir_files[2].first);
+  std::string targets_json;
+  for (const auto& pair : dir_files) {
+    std::string file = pair.second->str();
+#if defined(OS_WIN)
+    base::ReplaceSubstringsAfterOffset(&file, 0, "\r\n", "\n");
+#endif
+    const std::string kBegin = "{\n   \"targets\": {\n";
+    const std::string kEnd = "\n   }\n}\n";
+    ASSERT_GT(file.size(), kBegin.size() + kEnd.size());
+    EXPECT_EQ(kBegin, file.substr(0, kBegin.size()));
+    EXPECT_EQ(kEnd, file.substr(file.size() - kEnd.size()));
+    if (!targets_json.empty())
+      targets_json += ",\n";
+    targets_json += file.substr(kBegin.size(),
+                                file.size() - kBegin.size() - kEnd.size());
+  }
+  EXPECT_NE(std::string::npos,
+            whole.find("   \"targets\": {\n" + targets_json + "\n   },\n"));
+}
+
+TEST_F(JSONWriter, RemoveStaleFiles) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath dir = temp_dir.GetPath().AppendASCII("project");
+  base::FilePath live = dir.AppendASCII("foo").AppendASCII("targets.json");
+  base::FilePath stale = dir.AppendASCII("bar").AppendASCII("targets.json");
+  ASSERT_TRUE(base::CreateDirectory(live.DirName()));
+  ASSERT_TRUE(base::CreateDirectory(stale.DirName()));
+  ASSERT_EQ(2, base::WriteFile(live, "{}", 2));
+  ASSERT_EQ(2, base::WriteFile(stale, "{}", 2));
+
+  // The kept paths use '/' separators, like BuildSettings::GetFullPath().
+  std::set<base::FilePath> kept_files = {live.NormalizePathSeparatorsTo('/')};
+  EXPECT_TRUE(JSONProjectWriter::RemoveStaleFiles(dir, kept_files));
+  EXPECT_TRUE(base::PathExists(live));
+  EXPECT_FALSE(base::PathExists(stale));
+
+  // Nothing is left to remove.
+  EXPECT_FALSE(JSONProjectWriter::RemoveStaleFiles(dir, kept_files));
+  EXPECT_TRUE(base::PathExists(live));
+}
@@ -4,10 +4,14 @@
 
 #include "gn/label.h"
 
+#include <memory>
+#include <vector>
+
 #include "base/logging.h"
 #include "base/strings/string_util.h"
 #include "gn/err.h"
 #include "gn/filesystem_utils.h"
+#include "gn/hash_table_base.h"
 #include "gn/parse_tree.h"
 #include "gn/value.h"
 #include "util/build_config.h"
@@ -196,6 +200,128 @@ bool Resolve(const SourceDir& current_dir,
   return true;
 }
 
+// Returns true if resolving |input| doesn't depend on the current directory.
+// This is the case of source-absolute labels, unless they contain ".." which
+// may go above the source root, or a toolchain that may be relative.
+bool IsIndependentOfCurrentDir(std::string_view input) {
+  return input.size() >= 2 && input[0] == '/' && input[1] == '/' &&
+         input.find("..") == std::string_view::npos &&
+         input.find('(') == std::string_view::npos;
+}
+
+// A cache of the labels returned by Label::Resolve(), keyed by the current
+// directory, the current toolchain and the input string. The same label
+// strings, like "//base", are resolved over and over in the deps of the
+// targets of a build, and each resolution normalizes the directory and looks
+// up its parts in the StringAtom tables.
+//
+// Each thread has its own cache, so no locking is needed. Failures aren't
+// cached, their errors refer to the input value.
+class ResolveCache {
+ public:
+  // Returns the cached label for these arguments, or null.
+  const Label* Find(const SourceDir& current_dir,
+                    std::string_view source_root,
+                    const Label& current_toolchain,
+                    std::string_view input) {
+    if (source_root != source_root_) {
+      // Only tests use different source roots in the same process.
+      Clear();
+      source_root_.assign(source_root);
+    }
+    const std::string* dir = GetDirKey(current_dir, input);
+    size_t hash = Hash(dir, current_toolchain, input);
+    Node* node = set_.Lookup(hash, dir, current_toolchain, input);
+    return node->is_valid() ? &node->entry->label : nullptr;
+  }
+
+  void Add(const SourceDir& current_dir,
+           const Label& current_toolchain,
+           std::string_view input,
+           const Label& label) {
+    if (entries_.size() >= kMaxEntries)
+      Clear();
+    const std::string* dir = GetDirKey(current_dir, input);
+    size_t hash = Hash(dir, current_toolchain, input);
+    Node* node = set_.Lookup(hash, dir, current_toolchain, input);
+    if (node->is_valid())
+      return;
+    entries_.push_back(std::make_unique<Entry>(
+        Entry{dir, current_toolchain, std::string(input), label}));
+    set_.Insert(node, hash, entries_.back().get());
+  }
+
+ private:
+  // Bounds the memory used by each thread. Real builds have fewer distinct
+  // label strings per directory than this, so the cache is rarely cleared.
+  static constexpr size_t kMaxEntries = 1 << 16;
+
+  struct Entry {
+    const std::string* dir;  // Null when the input doesn't depend on it.
+    Label toolchain;
+    std::string input;
+    Label label;
+  };
+
+  struct Node {
+    size_t hash;
+    Entry* entry;
+
+    // The following methods are required by HashTableBase<>
+    bool is_valid() const { return !is_null(); }
+    bool is_null() const { return !entry; }
+    size_t hash_value() const { return hash; }
+    static constexpr bool is_tombstone() { return false; }
+  };
+
+  struct EntrySet : public HashTableBase<Node> {
+    Node* Lookup(size_t hash,
+                 const std::string* dir,
+                 const Label& toolchain,
+                 std::string_view input) const {
+      return NodeLookup(hash, [&](const Node* node) {
+        const Entry* entry = node->entry;
+        return node->hash == hash && entry->dir == dir &&
+               entry->toolchain == toolchain && entry->input == input;
+      });
+    }
+
+    void Insert(Node* node, size_t hash, Entry* entry) {
+      node->hash = hash;
+      node->entry = entry;
+      UpdateAfterInsert();
+    }
+
+    void Clear() { NodeClear(); }
+  };
+
+  static const std::string* GetDirKey(const SourceDir& current_dir,
+                                      std::string_view input) {
+    return IsIndependentOfCurrentDir(input) ? nullptr : &current_dir.value();
+  }
+
+  static size_t Hash(const std::string* dir,
+                     const Label& toolchain,
+                     std::string_view input) {
+    size_t h = std::hash<std::string_view>()(input);
+    h = h * 131 + std::hash<const std::string*>()(dir);
+    return h * 131 + toolchain.hash();
+  }
+
+  void Clear() {
+    set_.Clear();
+    entries_.clear();
+  }
+
+  std::string source_root_;
+  EntrySet set_;
+  std::vector<std::unique_ptr<Entry>> entries_;
+};
+
+#if !defined(OS_ZOS)
+thread_local ResolveCache s_resolve_cache;
+#endif
+
 }  // namespace
 
 const char kLabels_Help[] =
@@ -285,12 +411,22 @@ Label Label::Resolve(const SourceDir& current_dir,
     return ret;
   }
 
+#if !defined(OS_ZOS)
+  if (const Label* cached = s_resolve_cache.Find(current_dir, source_root,
+                                                 current_toolchain,
+                                                 input_string))
+    return *cached;
+#endif
+
   if (!::Resolve(current_dir, source_root, current_toolchain, input,
                  input_string, &ret.dir_, &ret.name_, &ret.toolchain_dir_,
                  &ret.toolchain_name_, err))
     return Label();
 
   ret.hash_ = ret.ComputeHash();
+#if !defined(OS_ZOS)
+  s_resolve_cache.Add(current_dir, current_toolchain, input_string, ret);
+#endif
   return ret;
 }
 
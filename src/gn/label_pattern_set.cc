@@ -0,0 +1,136 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/label_pattern_set.h"
+
+#include <string_view>
+#include <utility>
+
+LabelPatternSet::Node::Node() = default;
+LabelPatternSet::Node::~Node() = default;
+
+LabelPatternSet::LabelPatternSet() = default;
+
+LabelPatternSet::LabelPatternSet(std::vector<LabelPattern> patterns)
+    : patterns_(std::move(patterns)) {
+  if (patterns_.size() >= kMinIndexedPatterns)
+    BuildIndex();
+}
+
+LabelPatternSet::LabelPatternSet(LabelPatternSet&& other) = default;
+
+LabelPatternSet::~LabelPatternSet() = default;
+
+LabelPatternSet& LabelPatternSet::operator=(LabelPatternSet&& other) = default;
+
+bool LabelPatternSet::Matches(const Label& label) const {
+  return FindMatch(label, false) != kNoMatch;
+}
+
+const LabelPattern* LabelPatternSet::FirstMatch(const Label& label) const {
+  size_t index = FindMatch(label, true);
+  return index == kNoMatch ? nullptr : &patterns_[index];
+}
+
+void LabelPatternSet::BuildIndex() {
+  root_ = std::make_unique<Node>();
+  for (size_t i = 0; i < patterns_.size(); i++) {
+    const LabelPattern& pattern = patterns_[i];
+    std::string_view dir = pattern.dir().value();
+    if (!dir.empty() && dir.back() != '/') {
+      unindexed_.push_back(i);
+      continue;
+    }
+
+    Node* node = root_.get();
+    while (!dir.empty()) {
+      size_t slash = dir.find('/');
+      std::string_view component = dir.substr(0, slash);
+      auto found = node->children.find(component);
+      if (found == node->children.end()) {
+        found = node->children
+                    .emplace(std::string(component), std::make_unique<Node>())
+                    .first;
+      }
+      node = found->second.get();
+      dir.remove_prefix(slash + 1);
+    }
+
+    switch (pattern.type()) {
+      case LabelPattern::MATCH: {
+        auto found = node->names.find(pattern.name());
+        if (found == node->names.end())
+          found = node->names.emplace(pattern.name(), std::vector<size_t>())
+                      .first;
+        found->second.push_back(i);
+        break;
+      }
+      case LabelPattern::DIRECTORY:
+        node->directory.push_back(i);
+        break;
+      case LabelPattern::RECURSIVE_DIRECTORY:
+        node->recursive.push_back(i);
+        break;
+    }
+  }
+}
+
+size_t LabelPatternSet::FindMatch(const Label& label, bool first) const {
+  if (!root_) {
+    for (size_t i = 0; i < patterns_.size(); i++) {
+      if (patterns_[i].Matches(label))
+        return i;
+    }
+    return kNoMatch;
+  }
+
+  size_t match = kNoMatch;
+  if (CheckCandidates(unindexed_, label, first, &match))
+    return match;
+
+  // A RECURSIVE_DIRECTORY pattern matches the labels in any directory its
+  // directory is a prefix of. Since directories end with a slash, these are
+  // the ones on the path to the label's directory.
+  const Node* node = root_.get();
+  std::string_view dir = label.dir().value();
+  while (true) {
+    if (CheckCandidates(node->recursive, label, first, &match))
+      return match;
+    if (dir.empty())
+      break;
+
+    size_t slash = dir.find('/');
+    if (slash == std::string_view::npos)
+      return match;  // Not a directory any indexed pattern can match exactly.
+    auto found = node->children.find(dir.substr(0, slash));
+    if (found == node->children.end())
+      return match;
+    node = found->second.get();
+    dir.remove_prefix(slash + 1);
+  }
+
+  if (CheckCandidates(node->directory, label, first, &match))
+    return match;
+  auto found = node->names.find(label.name());
+  if (found != node->names.end())
+    CheckCandidates(found->second, label, first, &match);
+  return match;
+}
+
+bool LabelPatternSet::CheckCandidates(const std::vector<size_t>& candidates,
+                                      const Label& label,
+                                      bool first,
+                                      size_t* match) const {
+  for (size_t index : candidates) {
+    // The candidates are sorted, so later ones can't be a better match.
+    if (index >= *match)
+      break;
+    // For indexed candidates this only needs to check the toolchain.
+    if (patterns_[index].Matches(label)) {
+      *match = index;
+      return !first || index == 0;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,104 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_LABEL_PATTERN_SET_H_
+#define TOOLS_GN_LABEL_PATTERN_SET_H_
+
+#include <stddef.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gn/label_pattern.h"
+
+// A list of label patterns compiled for matching many labels against it, as
+// done for visibility, assert_no_deps and the various label filters.
+//
+// Matching a label against a vector of patterns with
+// LabelPattern::VectorMatches() tests every pattern in turn. Here, the
+// patterns are indexed in a tree of the directory components of their
+// SourceDir, so matching only walks the components of the label's directory
+// and tests the patterns attached to those directories. The cost is
+// proportional to the directory depth of the label rather than to the number
+// of patterns.
+//
+// Small sets, like the default visibility of most items, are not indexed
+// since a linear scan is cheaper than walking the tree for them.
+class LabelPatternSet {
+ public:
+  LabelPatternSet();
+  explicit LabelPatternSet(std::vector<LabelPattern> patterns);
+  LabelPatternSet(LabelPatternSet&& other);
+  ~LabelPatternSet();
+
+  LabelPatternSet& operator=(LabelPatternSet&& other);
+
+  const std::vector<LabelPattern>& patterns() const { return patterns_; }
+  bool empty() const { return patterns_.empty(); }
+
+  // Returns true if any of the patterns match the label. Same as
+  // LabelPattern::VectorMatches() for patterns().
+  bool Matches(const Label& label) const;
+
+  // Returns the first pattern, in the order of patterns(), that matches the
+  // label, or null if none does.
+  const LabelPattern* FirstMatch(const Label& label) const;
+
+ private:
+  // Sets with fewer patterns are matched with a linear scan.
+  static constexpr size_t kMinIndexedPatterns = 8;
+
+  static constexpr size_t kNoMatch = static_cast<size_t>(-1);
+
+  // A directory of the tree. The root is the empty directory, and each child
+  // adds one component, including its trailing slash, to the directory of
+  // its parent. Patterns are referenced by their index in |patterns_|, in
+  // increasing order.
+  struct Node {
+    Node();
+    ~Node();
+
+    std::map<std::string, std::unique_ptr<Node>, std::less<>> children;
+
+    // RECURSIVE_DIRECTORY patterns for this directory.
+    std::vector<size_t> recursive;
+
+    // DIRECTORY patterns for this directory.
+    std::vector<size_t> directory;
+
+    // MATCH patterns in this directory, by target name.
+    std::map<std::string, std::vector<size_t>, std::less<>> names;
+  };
+
+  void BuildIndex();
+
+  // Returns the index of a pattern matching the label, or kNoMatch. When
+  // |first| is set, this is the lowest such index, otherwise any of them.
+  size_t FindMatch(const Label& label, bool first) const;
+
+  // Looks for a pattern matching the label among |candidates|, and updates
+  // |*match| if it comes before the current match. Returns true if the search
+  // can stop there.
+  bool CheckCandidates(const std::vector<size_t>& candidates,
+                       const Label& label,
+                       bool first,
+                       size_t* match) const;
+
+  std::vector<LabelPattern> patterns_;
+
+  // Null when the set isn't indexed.
+  std::unique_ptr<Node> root_;
+
+  // Indexed sets also need a linear scan of these patterns, whose directory
+  // can't be split in components.
+  std::vector<size_t> unindexed_;
+
+  LabelPatternSet(const LabelPatternSet&) = delete;
+  LabelPatternSet& operator=(const LabelPatternSet&) = delete;
+};
+
+#endif  // TOOLS_GN_LABEL_PATTERN_SET_H_
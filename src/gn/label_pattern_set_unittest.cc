@@ -0,0 +1,130 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/label_pattern_set.h"
+
+#include <stddef.h>
+
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "util/test/test.h"
+
+namespace {
+
+const char* const kDirs[] = {
+    "",         "/",          "//",          "//a/",     "//a/b/",
+    "//a/b/c/", "//a/bc/",    "//ab/",       "//b/",     "//b/a/",
+    "/a/",      "/C:/a/",     "//a/b/c/d/",  "//x/y/z/", "//a/b/x/",
+};
+
+const char* const kNames[] = {"a", "b", "c", "foo"};
+
+const char* const kToolchains[] = {"", "//tc:gcc", "//tc:clang"};
+
+Label MakeToolchain(std::string_view label) {
+  if (label.empty())
+    return Label();
+  size_t colon = label.find(':');
+  return Label(SourceDir(std::string(label.substr(0, colon)) + "/"),
+               label.substr(colon + 1));
+}
+
+}  // namespace
+
+TEST(LabelPatternSet, Matches) {
+  Label gcc = MakeToolchain("//tc:gcc");
+  std::vector<LabelPattern> patterns = {
+      LabelPattern(LabelPattern::MATCH, SourceDir("//a/"), "foo", Label()),
+      LabelPattern(LabelPattern::DIRECTORY, SourceDir("//b/"), "", Label()),
+      LabelPattern(LabelPattern::RECURSIVE_DIRECTORY, SourceDir("//c/"), "",
+                   gcc),
+      LabelPattern(LabelPattern::MATCH, SourceDir("//d/e/"), "bar", Label()),
+      LabelPattern(LabelPattern::RECURSIVE_DIRECTORY, SourceDir("//d/"), "",
+                   Label()),
+      LabelPattern(LabelPattern::MATCH, SourceDir("//a/"), "baz", Label()),
+      LabelPattern(LabelPattern::DIRECTORY, SourceDir("//f/"), "", gcc),
+      LabelPattern(LabelPattern::MATCH, SourceDir("//g/"), "g", Label()),
+  };
+  LabelPatternSet set(patterns);
+  EXPECT_EQ(patterns.size(), set.patterns().size());
+
+  EXPECT_TRUE(set.Matches(Label(SourceDir("//a/"), "foo")));
+  EXPECT_FALSE(set.Matches(Label(SourceDir("//a/"), "bar")));
+  EXPECT_FALSE(set.Matches(Label(SourceDir("//a/b/"), "foo")));
+  EXPECT_TRUE(set.Matches(Label(SourceDir("//b/"), "anything")));
+  EXPECT_FALSE(set.Matches(Label(SourceDir("//b/c/"), "anything")));
+
+  // Toolchain constraints.
+  EXPECT_TRUE(
+      set.Matches(Label(SourceDir("//c/x/"), "x", gcc.dir(), gcc.name())));
+  EXPECT_FALSE(set.Matches(Label(SourceDir("//c/x/"), "x")));
+  EXPECT_TRUE(set.Matches(Label(SourceDir("//f/"), "x", gcc.dir(), "gcc")));
+  EXPECT_FALSE(set.Matches(Label(SourceDir("//f/"), "x", gcc.dir(), "clang")));
+
+  // The first matching pattern is reported.
+  EXPECT_EQ(&set.patterns()[3],
+            set.FirstMatch(Label(SourceDir("//d/e/"), "bar")));
+  EXPECT_EQ(&set.patterns()[4],
+            set.FirstMatch(Label(SourceDir("//d/e/"), "baz")));
+  EXPECT_FALSE(set.FirstMatch(Label(SourceDir("//e/"), "bar")));
+
+  // Empty sets match nothing.
+  EXPECT_FALSE(LabelPatternSet().Matches(Label(SourceDir("//a/"), "foo")));
+}
+
+// Compares the set with LabelPattern::VectorMatches() for many random
+// patterns and labels, for sets both below and above the size at which they
+// are indexed.
+TEST(LabelPatternSet, MatchesLinearScan) {
+  std::mt19937 rng(42);
+  auto pick = [&rng](const auto& array) {
+    return array[rng() % std::size(array)];
+  };
+
+  std::vector<Label> labels;
+  for (const char* dir : kDirs) {
+    for (const char* name : kNames) {
+      for (const char* toolchain : kToolchains) {
+        Label toolchain_label = MakeToolchain(toolchain);
+        labels.push_back(Label(SourceDir(dir), name, toolchain_label.dir(),
+                               toolchain_label.name()));
+      }
+    }
+  }
+
+  for (size_t size : {1, 3, 8, 20, 60}) {
+    for (int round = 0; round < 20; round++) {
+      std::vector<LabelPattern> patterns;
+      for (size_t i = 0; i < size; i++) {
+        LabelPattern::Type type = static_cast<LabelPattern::Type>(
+            LabelPattern::MATCH + rng() % 3);
+        patterns.push_back(LabelPattern(
+            type, SourceDir(pick(kDirs)),
+            type == LabelPattern::MATCH ? pick(kNames) : "",
+            MakeToolchain(pick(kToolchains))));
+      }
+      LabelPatternSet set(patterns);
+
+      for (const Label& label : labels) {
+        EXPECT_EQ(LabelPattern::VectorMatches(patterns, label),
+                  set.Matches(label));
+
+        const LabelPattern* expected = nullptr;
+        for (const LabelPattern& pattern : patterns) {
+          if (pattern.Matches(label)) {
+            expected = &pattern;
+            break;
+          }
+        }
+        const LabelPattern* first = set.FirstMatch(label);
+        ptrdiff_t expected_index = expected ? expected - &patterns[0] : -1;
+        ptrdiff_t first_index = first ? first - &set.patterns()[0] : -1;
+        EXPECT_EQ(expected_index, first_index);
+      }
+    }
+  }
+}
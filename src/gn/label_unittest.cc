@@ -141,3 +141,48 @@ TEST(Label, ResolveAboveRootBuildDir) {
   EXPECT_EQ("/foo/", result.dir().value()) << result.dir().value();
   EXPECT_EQ("foo", result.name());
 }
+
+// Resolve() caches its results. Checks that the same strings resolve
+// correctly in other contexts.
+TEST(Label, ResolveRepeated) {
+  Label tc1(SourceDir("//t/"), "one");
+  Label tc2(SourceDir("//t/"), "two");
+  SourceDir a("//a/");
+  SourceDir b("//b/");
+  Err err;
+
+  struct Case {
+    const SourceDir& dir;
+    const Label& toolchain;
+    const char* str;
+    const char* expected;
+  } cases[] = {
+      {a, tc1, ":x", "//a:x(//t:one)"},
+      {b, tc1, ":x", "//b:x(//t:one)"},
+      {a, tc2, ":x", "//a:x(//t:two)"},
+      {a, tc1, "//base", "//base:base(//t:one)"},
+      {b, tc1, "//base", "//base:base(//t:one)"},
+      {b, tc2, "//base", "//base:base(//t:two)"},
+      {a, tc1, "//base(foo)", "//base:base(//a/foo:foo)"},
+      {b, tc1, "//base(foo)", "//base:base(//b/foo:foo)"},
+      {a, tc1, "//base/../c", "//c:c(//t:one)"},
+      {a, tc1, "../c", "//c:c(//t:one)"},
+      {SourceDir("//a/b/"), tc1, "../c", "//a/c:c(//t:one)"},
+  };
+
+  for (int round = 0; round < 2; round++) {
+    for (const Case& cur : cases) {
+      Label result = Label::Resolve(cur.dir, std::string_view(), cur.toolchain,
+                                    Value(nullptr, cur.str), &err);
+      EXPECT_FALSE(err.has_error()) << cur.str;
+      EXPECT_EQ(cur.expected, result.GetUserVisibleName(true)) << cur.str;
+    }
+  }
+
+  // Errors are reported every time.
+  for (int round = 0; round < 2; round++) {
+    Err bad;
+    Label::Resolve(a, std::string_view(), tc1, Value(nullptr, "//"), &bad);
+    EXPECT_TRUE(bad.has_error());
+  }
+}
@@ -278,8 +278,7 @@ void LoaderImpl::BackgroundLoadFile(const Settings* settings,
   }
 
   // Pass all of the items that were defined off to the builder.
-  for (auto& item : collected_items)
-    settings->build_settings()->ItemDefined(std::move(item));
+  settings->build_settings()->ItemsDefined(std::move(collected_items));
 
   trace.Done();
 
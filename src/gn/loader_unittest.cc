@@ -243,9 +243,10 @@ TEST_F(LoaderTest, BuildDependencyFilesAreCollected) {
   SourceFile build_config("//build/config/BUILDCONFIG.gn");
   SourceFile root_build("//BUILD.gn");
   build_settings_.set_build_config_file(build_config);
-  build_settings_.set_item_defined_callback(
-      [builder = &mock_builder_](std::unique_ptr<Item> item) {
-        builder->OnItemDefined(std::move(item));
+  build_settings_.set_items_defined_callback(
+      [builder = &mock_builder_](std::vector<std::unique_ptr<Item>> items) {
+        for (auto& item : items)
+          builder->OnItemDefined(std::move(item));
       });
 
   scoped_refptr<LoaderImpl> loader(new LoaderImpl(&build_settings_));
@@ -292,9 +293,10 @@ TEST_F(LoaderTest, TemplateBuildDependencyFilesAreCollected) {
   SourceFile build_config("//build/config/BUILDCONFIG.gn");
   SourceFile root_build("//BUILD.gn");
   build_settings_.set_build_config_file(build_config);
-  build_settings_.set_item_defined_callback(
-      [builder = &mock_builder_](std::unique_ptr<Item> item) {
-        builder->OnItemDefined(std::move(item));
+  build_settings_.set_items_defined_callback(
+      [builder = &mock_builder_](std::vector<std::unique_ptr<Item>> items) {
+        for (auto& item : items)
+          builder->OnItemDefined(std::move(item));
       });
 
   scoped_refptr<LoaderImpl> loader(new LoaderImpl(&build_settings_));
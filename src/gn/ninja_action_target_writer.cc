@@ -22,7 +22,41 @@ NinjaActionTargetWriter::NinjaActionTargetWriter(const Target* target,
       path_output_no_escaping_(
           target->settings()->build_settings()->build_dir(),
           target->settings()->build_settings()->root_path_utf8(),
-          ESCAPE_NONE) {}
+          ESCAPE_NONE) {
+  const ActionValues& action_values = target->action_values();
+  for (const auto& pattern : action_values.outputs().list()) {
+    output_plans_.push_back(std::make_unique<SourceSubstitutionPlan>(
+        target, settings_, pattern, SubstitutionWriter::OUTPUT_ABSOLUTE,
+        SourceDir()));
+  }
+  if (action_values.has_depfile()) {
+    depfile_plan_ = std::make_unique<SourceSubstitutionPlan>(
+        target, settings_, action_values.depfile(),
+        SubstitutionWriter::OUTPUT_ABSOLUTE, SourceDir());
+  }
+
+  // The required types is the union of the args and response file. This
+  // might theoretically duplicate a definition if the same substitution is
+  // used in both the args and the response file. However, this should be
+  // very unusual (normally the substitutions will go in one place or the
+  // other) and the redundant assignment won't bother Ninja.
+  //
+  // As in SubstitutionWriter::WriteNinjaVariablesForSource(), SOURCE maps to
+  // Ninja's implicit $in variable and RESPONSE_FILE_NAME is never written
+  // per source.
+  for (const SubstitutionList* list :
+       {&action_values.args(), &action_values.rsp_file_contents()}) {
+    for (const Substitution* type : list->required_types()) {
+      if (type == &SubstitutionSource || type == &SubstitutionRspFileName)
+        continue;
+      variable_plans_.emplace_back(
+          type, std::make_unique<SourceSubstitutionPlan>(
+                    target, settings_, type,
+                    SubstitutionWriter::OUTPUT_RELATIVE,
+                    settings_->build_settings()->build_dir()));
+    }
+  }
+}
 
 NinjaActionTargetWriter::~NinjaActionTargetWriter() = default;
 
@@ -241,19 +275,11 @@ void NinjaActionTargetWriter::WriteSourceRules(
     if (target_->action_values().uses_rsp_file())
       out_ << "  unique_name = " << i << std::endl;
 
-    // The required types is the union of the args and response file. This
-    // might theoretically duplicate a definition if the same substitution is
-    // used in both the args and the response file. However, this should be
-    // very unusual (normally the substitutions will go in one place or the
-    // other) and the redundant assignment won't bother Ninja.
-    SubstitutionWriter::WriteNinjaVariablesForSource(
-        target_, settings_, sources[i],
-        target_->action_values().args().required_types(), args_escape_options,
-        out_);
-    SubstitutionWriter::WriteNinjaVariablesForSource(
-        target_, settings_, sources[i],
-        target_->action_values().rsp_file_contents().required_types(),
-        args_escape_options, out_);
+    for (const auto& [type, plan] : variable_plans_) {
+      out_ << "  " << type->ninja_name << " = ";
+      plan->WriteForSource(sources[i], args_escape_options, out_);
+      out_ << std::endl;
+    }
     WriteNinjaVariablesForAction();
 
     if (target_->action_values().has_depfile()) {
@@ -273,9 +299,8 @@ void NinjaActionTargetWriter::WriteOutputFilesForBuildLine(
     std::vector<OutputFile>* output_files) {
   size_t first_output_index = output_files->size();
 
-  SubstitutionWriter::ApplyListToSourceAsOutputFile(
-      target_, settings_, target_->action_values().outputs(), source,
-      output_files);
+  for (const auto& plan : output_plans_)
+    output_files->push_back(plan->GetOutputFileForSource(source));
 
   for (size_t i = first_output_index; i < output_files->size(); i++) {
     out_ << " ";
@@ -285,10 +310,7 @@ void NinjaActionTargetWriter::WriteOutputFilesForBuildLine(
 
 void NinjaActionTargetWriter::WriteDepfile(const SourceFile& source) {
   out_ << "  depfile = ";
-  path_output_.WriteFile(
-      out_,
-      SubstitutionWriter::ApplyPatternToSourceAsOutputFile(
-          target_, settings_, target_->action_values().depfile(), source));
+  path_output_.WriteFile(out_, depfile_plan_->GetOutputFileForSource(source));
   out_ << std::endl;
   // Using "deps = gcc" allows Ninja to read and store the depfile content in
   // its internal database which improves performance, especially for large
@@ -5,10 +5,13 @@
 #ifndef TOOLS_GN_NINJA_ACTION_TARGET_WRITER_H_
 #define TOOLS_GN_NINJA_ACTION_TARGET_WRITER_H_
 
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "base/gtest_prod_util.h"
 #include "gn/ninja_target_writer.h"
+#include "gn/substitution_writer.h"
 
 class OutputFile;
 
@@ -60,6 +63,14 @@ class NinjaActionTargetWriter : public NinjaTargetWriter {
   // computing intermediate strings.
   PathOutput path_output_no_escaping_;
 
+  // Per-source expansions of the outputs, the depfile and the Ninja variables
+  // used by the args and response file, prepared once for all sources.
+  std::vector<std::unique_ptr<SourceSubstitutionPlan>> output_plans_;
+  std::unique_ptr<SourceSubstitutionPlan> depfile_plan_;
+  std::vector<
+      std::pair<const Substitution*, std::unique_ptr<SourceSubstitutionPlan>>>
+      variable_plans_;
+
   NinjaActionTargetWriter(const NinjaActionTargetWriter&) = delete;
   NinjaActionTargetWriter& operator=(const NinjaActionTargetWriter&) = delete;
 };
@@ -6,7 +6,9 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <map>
 #include <set>
 #include <sstream>
@@ -32,6 +34,7 @@
 #include "util/atomic_write.h"
 #include "util/build_config.h"
 #include "util/exe_path.h"
+#include "util/worker_pool.h"
 
 #if defined(OS_WIN)
 #include <windows.h>
@@ -39,6 +42,11 @@
 
 namespace {
 
+// Number of phony rules or "all" inputs rendered by a single worker task.
+// Large enough that task overhead is negligible, small enough that big builds
+// spread over all threads.
+constexpr size_t kItemsPerChunk = 4096;
+
 struct Counts {
   Counts() : count(0), last_seen(nullptr) {}
 
@@ -190,6 +198,35 @@ Err GetDuplicateToolchainError(const SourceFile& source_file,
   return result;
 }
 
+// Calls |render_item| for each index in [0, count) and appends everything it
+// writes to |out| in index order. Large inputs are split into chunks that are
+// rendered concurrently into separate buffers and then concatenated, so the
+// output is identical to rendering them serially.
+void RenderInChunks(
+    size_t count,
+    std::ostream& out,
+    const std::function<void(size_t, std::ostream&)>& render_item) {
+  const size_t chunk_count = (count + kItemsPerChunk - 1) / kItemsPerChunk;
+  if (chunk_count <= 1) {
+    for (size_t i = 0; i < count; i++)
+      render_item(i, out);
+    return;
+  }
+
+  std::vector<std::string> chunks(chunk_count);
+  WorkerPool::GetShared().ParallelFor(
+      chunk_count, [count, &chunks, &render_item](size_t chunk) {
+        std::ostringstream chunk_out;
+        size_t end = std::min(count, (chunk + 1) * kItemsPerChunk);
+        for (size_t i = chunk * kItemsPerChunk; i < end; i++)
+          render_item(i, chunk_out);
+        chunks[chunk] = chunk_out.str();
+      });
+
+  for (const std::string& chunk : chunks)
+    out << chunk;
+}
+
 }  // namespace
 
 NinjaBuildWriter::NinjaBuildWriter(
@@ -416,41 +453,44 @@ void NinjaBuildWriter::WriteAllPools() {
 }
 
 bool NinjaBuildWriter::WriteSubninjas(Err* err) {
+  // Compute the file of each toolchain once rather than in every comparison.
+  struct Subninja {
+    SourceFile file;
+    const Toolchain* toolchain;
+  };
+  std::vector<Subninja> subninjas;
+  subninjas.reserve(used_toolchains_.size());
+  for (const auto& pair : used_toolchains_)
+    subninjas.push_back({GetNinjaFileForToolchain(pair.first), pair.second});
+
   // Write toolchains sorted by their name, to make output deterministic.
-  std::vector<std::pair<const Settings*, const Toolchain*>> sorted_settings(
-      used_toolchains_.begin(), used_toolchains_.end());
-  std::sort(sorted_settings.begin(), sorted_settings.end(),
-            [this](const std::pair<const Settings*, const Toolchain*>& a,
-                   const std::pair<const Settings*, const Toolchain*>& b) {
+  std::sort(subninjas.begin(), subninjas.end(),
+            [this](const Subninja& a, const Subninja& b) {
               // Always put the default toolchain first.
-              if (b.second == default_toolchain_)
+              if (b.toolchain == default_toolchain_)
                 return false;
-              if (a.second == default_toolchain_)
+              if (a.toolchain == default_toolchain_)
                 return true;
-              return GetNinjaFileForToolchain(a.first) <
-                     GetNinjaFileForToolchain(b.first);
+              return a.file < b.file;
             });
 
-  SourceFile previous_subninja;
-  const Toolchain* previous_toolchain = nullptr;
-
-  for (const auto& pair : sorted_settings) {
-    SourceFile subninja = GetNinjaFileForToolchain(pair.first);
-
-    // Since the toolchains are sorted, comparing to the previous subninja is
-    // enough to find duplicates.
-    if (subninja == previous_subninja) {
-      *err =
-          GetDuplicateToolchainError(subninja, previous_toolchain, pair.second);
+  // Since the toolchains are sorted, comparing to the previous subninja is
+  // enough to find duplicates.
+  for (size_t i = 1; i < subninjas.size(); i++) {
+    if (subninjas[i].file == subninjas[i - 1].file) {
+      *err = GetDuplicateToolchainError(subninjas[i].file,
+                                        subninjas[i - 1].toolchain,
+                                        subninjas[i].toolchain);
       return false;
     }
-
-    out_ << "subninja ";
-    path_output_.WriteFile(out_, subninja);
-    out_ << std::endl;
-    previous_subninja = subninja;
-    previous_toolchain = pair.second;
   }
+
+  RenderInChunks(subninjas.size(), out_,
+                 [this, &subninjas](size_t i, std::ostream& out) {
+                   out << "subninja ";
+                   path_output_.WriteFile(out, subninjas[i].file);
+                   out << std::endl;
+                 });
   out_ << std::endl;
   return true;
 }
@@ -529,6 +569,11 @@ bool NinjaBuildWriter::WritePhonyAndAllRules(Err* err) {
   std::map<std::string, Counts> short_names;
   std::map<std::string, Counts> exes;
 
+  // The phony rules to write, in order. Deciding which names are written
+  // must be done serially since earlier rules take precedence, but the rules
+  // themselves are rendered in parallel once the list is known.
+  std::vector<std::pair<const Target*, StringAtom>> phony_rules;
+
   // ----------------------------------------------------
   // If you change this algorithm, update the help above!
   // ----------------------------------------------------
@@ -596,13 +641,13 @@ bool NinjaBuildWriter::WritePhonyAndAllRules(Err* err) {
   // First prefer the short names of toplevel targets.
   for (const Target* target : toplevel_targets) {
     if (written_rules.insert(target->label().name_atom()).second)
-      WritePhonyRule(target, target->label().name_atom());
+      phony_rules.emplace_back(target, target->label().name_atom());
   }
 
   // Next prefer short names of toplevel dir targets.
   for (const Target* target : toplevel_dir_targets) {
     if (written_rules.insert(target->label().name_atom()).second)
-      WritePhonyRule(target, target->label().name_atom());
+      phony_rules.emplace_back(target, target->label().name_atom());
   }
 
   // Write out the names labels of executables. Many toolchains will produce
@@ -619,7 +664,7 @@ bool NinjaBuildWriter::WritePhonyAndAllRules(Err* err) {
     const Counts& counts = pair.second;
     const StringAtom& short_name = counts.last_seen->label().name_atom();
     if (counts.count == 1 && written_rules.insert(short_name).second)
-      WritePhonyRule(counts.last_seen, short_name);
+      phony_rules.emplace_back(counts.last_seen, short_name);
   }
 
   // Write short names when those names are unique and not already taken.
@@ -627,7 +672,7 @@ bool NinjaBuildWriter::WritePhonyAndAllRules(Err* err) {
     const Counts& counts = pair.second;
     const StringAtom& short_name = counts.last_seen->label().name_atom();
     if (counts.count == 1 && written_rules.insert(short_name).second)
-      WritePhonyRule(counts.last_seen, short_name);
+      phony_rules.emplace_back(counts.last_seen, short_name);
   }
 
   // Write the label variants of the target name.
@@ -639,7 +684,7 @@ bool NinjaBuildWriter::WritePhonyAndAllRules(Err* err) {
     base::TrimString(long_name, "/", &long_name);
     const StringAtom long_name_atom(long_name);
     if (written_rules.insert(long_name_atom).second)
-      WritePhonyRule(target, long_name_atom);
+      phony_rules.emplace_back(target, long_name_atom);
 
     // Write the directory name with no target name if they match
     // (e.g. "//foo/bar:bar" -> "foo/bar").
@@ -652,22 +697,29 @@ bool NinjaBuildWriter::WritePhonyAndAllRules(Err* err) {
       // target which we already wrote.
       if (medium_name != label.name() &&
           written_rules.insert(medium_name_atom).second)
-        WritePhonyRule(target, medium_name_atom);
+        phony_rules.emplace_back(target, medium_name_atom);
     }
   }
 
+  RenderInChunks(phony_rules.size(), out_,
+                 [this, &phony_rules](size_t i, std::ostream& out) {
+                   WritePhonyRule(out, phony_rules[i].first,
+                                  phony_rules[i].second);
+                 });
+
   // Write the autogenerated "all" rule.
   if (!default_toolchain_targets_.empty()) {
     out_ << "\nbuild all: phony";
 
-    EscapeOptions ninja_escape;
-    ninja_escape.mode = ESCAPE_NINJA;
-    for (const Target* target : default_toolchain_targets_) {
-      if (target->has_dependency_output()) {
-        out_ << " $\n    ";
-        path_output_.WriteFile(out_, target->dependency_output());
-      }
-    }
+    RenderInChunks(default_toolchain_targets_.size(), out_,
+                   [this](size_t i, std::ostream& out) {
+                     const Target* target = default_toolchain_targets_[i];
+                     if (target->has_dependency_output()) {
+                       out << " $\n    ";
+                       path_output_.WriteFile(out,
+                                              target->dependency_output());
+                     }
+                   });
   }
   out_ << std::endl;
 
@@ -690,8 +742,9 @@ bool NinjaBuildWriter::WritePhonyAndAllRules(Err* err) {
   return true;
 }
 
-void NinjaBuildWriter::WritePhonyRule(const Target* target,
-                                      std::string_view phony_name) {
+void NinjaBuildWriter::WritePhonyRule(std::ostream& out,
+                                      const Target* target,
+                                      std::string_view phony_name) const {
   EscapeOptions ninja_escape;
   ninja_escape.mode = ESCAPE_NINJA;
 
@@ -701,9 +754,9 @@ void NinjaBuildWriter::WritePhonyRule(const Target* target,
   // If the target doesn't have a dependency_output(), we should
   // still emit the phony rule, but with no dependencies. This allows users to
   // continue to use the phony rule, but it will effectively be a no-op.
-  out_ << "build " << escaped << ": phony ";
+  out << "build " << escaped << ": phony ";
   if (target->has_dependency_output()) {
-    path_output_.WriteFile(out_, target->dependency_output());
+    path_output_.WriteFile(out, target->dependency_output());
   }
-  out_ << std::endl;
+  out << std::endl;
 }
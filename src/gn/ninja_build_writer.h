@@ -83,7 +83,11 @@ class NinjaBuildWriter {
   bool WriteSubninjas(Err* err);
   bool WritePhonyAndAllRules(Err* err);
 
-  void WritePhonyRule(const Target* target, std::string_view phony_name);
+  // Writes a single phony rule to |out|. This is called concurrently from
+  // several threads so must not modify any state.
+  void WritePhonyRule(std::ostream& out,
+                      const Target* target,
+                      std::string_view phony_name) const;
 
   const BuildSettings* build_settings_;
 
@@ -2,7 +2,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <fstream>
+#include <memory>
 #include <sstream>
 
 #include "base/command_line.h"
@@ -188,6 +190,59 @@ TEST_F(NinjaBuildWriterTest, TwoTargets) {
   EXPECT_EQ(std::string::npos, out_str.find("pool console"));
 }
 
+// Enough targets that the phony rules are rendered in several chunks. The
+// output must be the same as when written serially.
+TEST_F(NinjaBuildWriterTest, ManyTargets) {
+  TestWithScope setup;
+  Err err;
+
+  const size_t kTargetCount = 10000;
+  std::vector<std::unique_ptr<Target>> owned_targets;
+  std::vector<const Target*> targets;
+  for (size_t i = 0; i < kTargetCount; i++) {
+    std::string name = "t" + std::to_string(i);
+    auto target = std::make_unique<Target>(
+        setup.settings(), Label(SourceDir("//dir/"), name));
+    target->set_output_type(Target::ACTION);
+    target->action_values().set_script(SourceFile("//dir/script.py"));
+    std::string output = "//out/Debug/" + name + ".out";
+    target->action_values().outputs() =
+        SubstitutionList::MakeForTest(output.c_str());
+    target->SetToolchain(setup.toolchain());
+    ASSERT_TRUE(target->OnResolved(&err));
+    targets.push_back(target.get());
+    owned_targets.push_back(std::move(target));
+  }
+
+  std::unordered_map<const Settings*, const Toolchain*> used_toolchains;
+  used_toolchains[setup.settings()] = setup.toolchain();
+  std::ostringstream ninja_out;
+  std::ostringstream depfile_out;
+  NinjaBuildWriter writer(setup.build_settings(), used_toolchains, targets,
+                          setup.toolchain(), targets, ninja_out, depfile_out);
+  ASSERT_TRUE(writer.Run(&err));
+
+  // Short names come first in name order, then the long names in target
+  // order.
+  std::vector<std::string> names;
+  for (size_t i = 0; i < kTargetCount; i++)
+    names.push_back("t" + std::to_string(i));
+  std::vector<std::string> sorted_names = names;
+  std::sort(sorted_names.begin(), sorted_names.end());
+
+  std::string expected;
+  for (const std::string& name : sorted_names)
+    expected += "build " + name + ": phony phony/dir/" + name + "\n";
+  for (const std::string& name : names)
+    expected += "build dir$:" + name + ": phony phony/dir/" + name + "\n";
+  expected += "\nbuild all: phony";
+  for (const std::string& name : names)
+    expected += " $\n    phony/dir/" + name;
+  expected += "\n";
+
+  EXPECT_NE(std::string::npos, ninja_out.str().find(expected));
+}
+
 TEST_F(NinjaBuildWriterTest, ExtractRegenerationCommands) {
   TestWithScope setup;
   Err err;
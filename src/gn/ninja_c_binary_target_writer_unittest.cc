@@ -11,6 +11,7 @@
 #include "gn/config.h"
 #include "gn/ninja_target_command_util.h"
 #include "gn/pool.h"
+#include "gn/resolved_target_data.h"
 #include "gn/scheduler.h"
 #include "gn/target.h"
 #include "gn/test_with_scheduler.h"
@@ -20,6 +21,40 @@
 
 using NinjaCBinaryTargetWriterTest = TestWithScheduler;
 
+namespace {
+
+// Sets up a toolchain whose compiler uses {{framework_dirs}}, with the given
+// framework dir switch.
+void SetupFrameworkDirsToolchain(Toolchain* toolchain,
+                                 const std::string& framework_dir_switch) {
+  std::unique_ptr<Tool> cc_tool = Tool::CreateTool(CTool::kCToolCc);
+  TestWithScope::SetCommandForTool(
+      "cc {{source}} {{framework_dirs}} -o {{output}}", cc_tool.get());
+  cc_tool->set_outputs(SubstitutionList::MakeForTest(
+      "{{source_out_dir}}/{{target_output_name}}.{{source_name_part}}.o"));
+  toolchain->SetTool(std::move(cc_tool));
+
+  std::unique_ptr<Tool> alink_tool = Tool::CreateTool(CTool::kCToolAlink);
+  TestWithScope::SetCommandForTool("ar {{output}} {{source}}",
+                                   alink_tool.get());
+  alink_tool->set_output_prefix("lib");
+  alink_tool->set_outputs(SubstitutionList::MakeForTest(
+      "{{target_out_dir}}/{{target_output_name}}.a"));
+  toolchain->SetTool(std::move(alink_tool));
+
+  std::unique_ptr<Tool> link_tool = Tool::CreateTool(CTool::kCToolLink);
+  TestWithScope::SetCommandForTool("ld -o {{output}} {{inputs}}",
+                                   link_tool.get());
+  link_tool->set_framework_dir_switch(framework_dir_switch);
+  link_tool->set_outputs(SubstitutionList::MakeForTest(
+      "{{root_out_dir}}/{{target_output_name}}"));
+  toolchain->SetTool(std::move(link_tool));
+
+  toolchain->ToolchainSetupComplete();
+}
+
+}  // namespace
+
 TEST_F(NinjaCBinaryTargetWriterTest, SourceSet) {
   Err err;
   TestWithScope setup;
@@ -624,6 +659,44 @@ TEST_F(NinjaCBinaryTargetWriterTest, FrameworksAndFrameworkDirs) {
   EXPECT_EQ(expected, out_str) << expected << "\n" << out_str;
 }
 
+// Targets of toolchains with different framework dir switches don't share
+// their framework_dirs, even with the same values.
+TEST_F(NinjaCBinaryTargetWriterTest, FrameworkDirsPerToolchain) {
+  Err err;
+  TestWithScope setup;
+
+  Toolchain toolchain_a(setup.settings(), Label(SourceDir("//tc/"), "a"));
+  SetupFrameworkDirsToolchain(&toolchain_a, "-F");
+  Toolchain toolchain_b(setup.settings(), Label(SourceDir("//tc/"), "b"));
+  SetupFrameworkDirsToolchain(&toolchain_b, "/FW:");
+
+  // The writers of all the toolchains share their flags, like the writers
+  // running on the same thread do.
+  ResolvedTargetData resolved;
+  auto write_lib = [&](const Toolchain* toolchain) {
+    Target target(setup.settings(),
+                  Label(SourceDir("//foo/"), "lib", toolchain->label().dir(),
+                        toolchain->label().name()));
+    target.set_output_type(Target::STATIC_LIBRARY);
+    target.sources().push_back(SourceFile("//foo/lib.cc"));
+    target.source_types_used().Set(SourceFile::SOURCE_C);
+    target.config_values().framework_dirs().push_back(SourceDir("//fw/"));
+    target.SetToolchain(toolchain);
+    EXPECT_TRUE(target.OnResolved(&err));
+
+    std::ostringstream out;
+    NinjaCBinaryTargetWriter writer(&target, out);
+    writer.SetResolvedTargetData(&resolved);
+    writer.Run();
+    return out.str();
+  };
+
+  EXPECT_NE(std::string::npos,
+            write_lib(&toolchain_a).find("framework_dirs = -F../../fw\n"));
+  EXPECT_NE(std::string::npos,
+            write_lib(&toolchain_b).find("framework_dirs = /FW:../../fw\n"));
+}
+
 TEST_F(NinjaCBinaryTargetWriterTest, EmptyOutputExtension) {
   Err err;
   TestWithScope setup;
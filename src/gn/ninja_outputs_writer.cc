@@ -129,28 +129,26 @@ bool NinjaOutputsWriter::RunAndWriteFiles(
   StringOutputBuffer outputs = GenerateJSON(outputs_map);
 
   base::FilePath output_path = build_settings->GetFullPath(output_file);
-  if (!outputs.ContentsEqual(output_path)) {
-    if (!outputs.WriteToFile(output_path, err)) {
-      return false;
-    }
+  bool written;
+  if (!outputs.WriteToFileIfChanged(output_path, err, &written))
+    return false;
 
-    if (!exec_script.empty()) {
-      SourceFile script_file;
-      if (exec_script[0] != '/') {
-        // Relative path, assume the base is in build_dir.
-        script_file = build_settings->build_dir().ResolveRelativeFile(
-            Value(nullptr, exec_script), err);
-        if (script_file.is_null()) {
-          return false;
-        }
-      } else {
-        script_file = SourceFile(exec_script);
+  if (written && !exec_script.empty()) {
+    SourceFile script_file;
+    if (exec_script[0] != '/') {
+      // Relative path, assume the base is in build_dir.
+      script_file = build_settings->build_dir().ResolveRelativeFile(
+          Value(nullptr, exec_script), err);
+      if (script_file.is_null()) {
+        return false;
       }
-      base::FilePath script_path = build_settings->GetFullPath(script_file);
-      return internal::InvokePython(build_settings, script_path,
-                                    exec_script_extra_args, output_path, quiet,
-                                    err);
+    } else {
+      script_file = SourceFile(exec_script);
     }
+    base::FilePath script_path = build_settings->GetFullPath(script_file);
+    return internal::InvokePython(build_settings, script_path,
+                                  exec_script_extra_args, output_path, quiet,
+                                  err);
   }
 
   return true;
@@ -52,10 +52,24 @@ void WriteOneFlag(RecursiveWriterConfig config,
                   PathOutput& path_output,
                   std::ostream& out,
                   bool write_substitution,
-                  bool indent) {
+                  bool indent,
+                  ResolvedFlagSets* flag_sets) {
   if (!target->toolchain()->substitution_bits().used.count(subst_enum))
     return;
 
+  auto write_flags = [&]() {
+    if (flag_sets) {
+      flag_sets->WriteFlags(
+          target, subst_enum,
+          flag_sets->Get(subst_enum, config, target, getter,
+                         EscapedStringWriter(flag_escape_options)),
+          out);
+    } else {
+      RecursiveTargetConfigStringsToStream(config, target, getter,
+                                           flag_escape_options, out);
+    }
+  };
+
   if (indent)
     out << "  ";
   if (write_substitution)
@@ -71,16 +85,14 @@ void WriteOneFlag(RecursiveWriterConfig config,
       // Enables precompiled headers and names the .h file. It's a string
       // rather than a file name (so no need to rebase or use path_output).
       out << " /Yu" << target->config_values().precompiled_header();
-      RecursiveTargetConfigStringsToStream(config, target, getter,
-                                           flag_escape_options, out);
+      write_flags();
     } else if (tool && tool->precompiled_header_type() == CTool::PCH_GCC) {
       // The targets to build the .gch files should omit the -include flag
       // below. To accomplish this, each substitution flag is overwritten in
       // the target rule and these values are repeated. The -include flag is
       // omitted in place of the required -x <header lang> flag for .gch
       // targets.
-      RecursiveTargetConfigStringsToStream(config, target, getter,
-                                           flag_escape_options, out);
+      write_flags();
 
       // Compute the gch file (it will be language-specific).
       std::vector<OutputFile> outputs;
@@ -94,12 +106,10 @@ void WriteOneFlag(RecursiveWriterConfig config,
         out << " -include " << pch_file;
       }
     } else {
-      RecursiveTargetConfigStringsToStream(config, target, getter,
-                                           flag_escape_options, out);
+      write_flags();
     }
   } else {
-    RecursiveTargetConfigStringsToStream(config, target, getter,
-                                         flag_escape_options, out);
+    write_flags();
   }
 
   if (write_substitution)
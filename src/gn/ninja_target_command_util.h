@@ -13,6 +13,7 @@
 #include "gn/filesystem_utils.h"
 #include "gn/frameworks_utils.h"
 #include "gn/path_output.h"
+#include "gn/resolved_flag_sets.h"
 #include "gn/target.h"
 #include "gn/toolchain.h"
 #include "gn/variables.h"
@@ -103,7 +104,8 @@ void WriteOneFlag(RecursiveWriterConfig config,
                   PathOutput& path_output,
                   std::ostream& out,
                   bool write_substitution = true,
-                  bool indent = false);
+                  bool indent = false,
+                  ResolvedFlagSets* flag_sets = nullptr);
 
 // Fills |outputs| with the object or gch file for the precompiled header of the
 // given type (flag type and tool type must match).
@@ -264,14 +264,20 @@ void NinjaTargetWriter::WriteSharedVars(const SubstitutionBits& bits) {
 void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
                                            bool indent,
                                            bool respect_source_used) {
+  // Targets with the same configs share their flags, see ResolvedFlagSets.
+  ResolvedFlagSets& flag_sets = resolved().flag_sets();
+
   // Defines.
   if (bits.used.count(&CSubstitutionDefines)) {
     if (indent)
       out_ << "  ";
     out_ << CSubstitutionDefines.ninja_name << " =";
-    RecursiveTargetConfigToStream<std::string>(kRecursiveWriterSkipDuplicates,
-                                               target_, &ConfigValues::defines,
-                                               DefineWriter(), out_);
+    flag_sets.WriteFlags(
+        target_, &CSubstitutionDefines,
+        flag_sets.Get<std::string>(&CSubstitutionDefines,
+                                   kRecursiveWriterSkipDuplicates, target_,
+                                   &ConfigValues::defines, DefineWriter()),
+        out_);
     out_ << std::endl;
   }
 
@@ -285,10 +291,14 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
     PathOutput framework_dirs_output(
         path_output_.current_dir(),
         settings_->build_settings()->root_path_utf8(), ESCAPE_NINJA_COMMAND);
-    RecursiveTargetConfigToStream<SourceDir>(
-        kRecursiveWriterSkipDuplicates, target_, &ConfigValues::framework_dirs,
-        FrameworkDirsWriter(framework_dirs_output,
-                            tool->framework_dir_switch()),
+    flag_sets.WriteFlags(
+        target_, &CSubstitutionFrameworkDirs,
+        flag_sets.Get<SourceDir>(
+            &CSubstitutionFrameworkDirs, kRecursiveWriterSkipDuplicates,
+            target_, &ConfigValues::framework_dirs,
+            FrameworkDirsWriter(framework_dirs_output,
+                                tool->framework_dir_switch()),
+            tool->framework_dir_switch()),
         out_);
     out_ << std::endl;
   }
@@ -301,9 +311,13 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
     PathOutput include_path_output(
         path_output_.current_dir(),
         settings_->build_settings()->root_path_utf8(), ESCAPE_NINJA_COMMAND);
-    RecursiveTargetConfigToStream<SourceDir>(
-        kRecursiveWriterSkipDuplicates, target_, &ConfigValues::include_dirs,
-        IncludeWriter(include_path_output), out_);
+    flag_sets.WriteFlags(
+        target_, &CSubstitutionIncludeDirs,
+        flag_sets.Get<SourceDir>(&CSubstitutionIncludeDirs,
+                                 kRecursiveWriterSkipDuplicates, target_,
+                                 &ConfigValues::include_dirs,
+                                 IncludeWriter(include_path_output)),
+        out_);
     out_ << std::endl;
   }
 
@@ -318,7 +332,7 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_,
                  &CSubstitutionAsmFlags, false, Tool::kToolNone,
                  &ConfigValues::asmflags, opts, path_output_, out_, true,
-                 indent);
+                 indent, &flag_sets);
   }
   if (respect_source_used
           ? (target_->source_types_used().Get(SourceFile::SOURCE_C) ||
@@ -329,7 +343,7 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
           : bits.used.count(&CSubstitutionCFlags)) {
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_, &CSubstitutionCFlags,
                  false, Tool::kToolNone, &ConfigValues::cflags, opts,
-                 path_output_, out_, true, indent);
+                 path_output_, out_, true, indent, &flag_sets);
   }
   if (respect_source_used
           ? target_->source_types_used().Get(SourceFile::SOURCE_C)
@@ -337,7 +351,7 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_, &CSubstitutionCFlagsC,
                  has_precompiled_headers, CTool::kCToolCc,
                  &ConfigValues::cflags_c, opts, path_output_, out_, true,
-                 indent);
+                 indent, &flag_sets);
   }
   if (respect_source_used
           ? (target_->source_types_used().Get(SourceFile::SOURCE_CPP) ||
@@ -346,7 +360,7 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_,
                  &CSubstitutionCFlagsCc, has_precompiled_headers,
                  CTool::kCToolCxx, &ConfigValues::cflags_cc, opts, path_output_,
-                 out_, true, indent);
+                 out_, true, indent, &flag_sets);
   }
   if (respect_source_used
           ? target_->source_types_used().Get(SourceFile::SOURCE_M)
@@ -354,7 +368,7 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_,
                  &CSubstitutionCFlagsObjC, has_precompiled_headers,
                  CTool::kCToolObjC, &ConfigValues::cflags_objc, opts,
-                 path_output_, out_, true, indent);
+                 path_output_, out_, true, indent, &flag_sets);
   }
   if (respect_source_used
           ? target_->source_types_used().Get(SourceFile::SOURCE_MM)
@@ -362,7 +376,7 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_,
                  &CSubstitutionCFlagsObjCc, has_precompiled_headers,
                  CTool::kCToolObjCxx, &ConfigValues::cflags_objcc, opts,
-                 path_output_, out_, true, indent);
+                 path_output_, out_, true, indent, &flag_sets);
   }
   if (target_->source_types_used().SwiftSourceUsed() || !respect_source_used) {
     if (bits.used.count(&CSubstitutionSwiftModuleName)) {
@@ -408,13 +422,14 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_,
                  &CSubstitutionSwiftFlags, false, CTool::kCToolSwift,
                  &ConfigValues::swiftflags, opts, path_output_, out_, true,
-                 indent);
+                 indent, &flag_sets);
   }
 }
 
 void NinjaTargetWriter::WriteRustCompilerVars(const SubstitutionBits& bits,
                                               bool indent,
                                               bool always_write) {
+  ResolvedFlagSets& flag_sets = resolved().flag_sets();
   EscapeOptions opts;
   opts.mode = ESCAPE_NINJA_COMMAND;
 
@@ -422,14 +437,14 @@ void NinjaTargetWriter::WriteRustCompilerVars(const SubstitutionBits& bits,
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_,
                  &kRustSubstitutionRustFlags, false, Tool::kToolNone,
                  &ConfigValues::rustflags, opts, path_output_, out_, true,
-                 indent);
+                 indent, &flag_sets);
   }
 
   if (bits.used.count(&kRustSubstitutionRustEnv) || always_write) {
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_,
                  &kRustSubstitutionRustEnv, false, Tool::kToolNone,
                  &ConfigValues::rustenv, opts, path_output_, out_, true,
-                 indent);
+                 indent, &flag_sets);
   }
 }
 
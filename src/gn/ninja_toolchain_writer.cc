@@ -4,9 +4,6 @@
 
 #include "gn/ninja_toolchain_writer.h"
 
-#include <fstream>
-
-#include "base/files/file_util.h"
 #include "base/strings/stringize_macros.h"
 #include "gn/build_settings.h"
 #include "gn/builtin_tool.h"
@@ -16,6 +13,7 @@
 #include "gn/ninja_utils.h"
 #include "gn/pool.h"
 #include "gn/settings.h"
+#include "gn/string_output_buffer.h"
 #include "gn/substitution_writer.h"
 #include "gn/target.h"
 #include "gn/toolchain.h"
@@ -52,6 +50,13 @@ void NinjaToolchainWriter::Run(
   }
   out_ << std::endl;
 
+  // The shared flag variables must be defined before the targets using them.
+  if (settings_->build_settings()->shared_ninja_flags()) {
+    out_ << "include ";
+    path_output_.WriteFile(out_, GetNinjaFlagsFileForToolchain(settings_));
+    out_ << std::endl << std::endl;
+  }
+
   for (const auto& pair : rules)
     out_ << pair.second;
 }
@@ -60,23 +65,47 @@ void NinjaToolchainWriter::Run(
 bool NinjaToolchainWriter::RunAndWriteFile(
     const Settings* settings,
     const Toolchain* toolchain,
-    const std::vector<NinjaWriter::TargetRulePair>& rules) {
+    const std::vector<NinjaWriter::TargetRulePair>& rules,
+    const NinjaWriter::SharedFlags* shared_flags) {
+  if (settings->build_settings()->shared_ninja_flags() &&
+      !WriteSharedFlagsFile(settings, shared_flags))
+    return false;
+
   base::FilePath ninja_file(settings->build_settings()->GetFullPath(
       GetNinjaFileForToolchain(settings)));
   ScopedTrace trace(TraceItem::TRACE_FILE_WRITE_NINJA,
                     FilePathToUTF8(ninja_file));
 
-  base::CreateDirectory(ninja_file.DirName());
-
-  std::ofstream file;
-  file.open(FilePathToUTF8(ninja_file).c_str(),
-            std::ios_base::out | std::ios_base::binary);
-  if (file.fail())
-    return false;
-
+  // Format the whole file in memory and write it in one operation, this is
+  // much faster than going through an fstream line by line. This may run on
+  // a worker thread concurrently with the other toolchains.
+  StringOutputBuffer storage;
+  std::ostream file(&storage);
   NinjaToolchainWriter gen(settings, toolchain, file);
   gen.Run(rules);
-  return true;
+  return storage.WriteToFileIfChanged(ninja_file, nullptr);
+}
+
+// static
+bool NinjaToolchainWriter::WriteSharedFlagsFile(
+    const Settings* settings,
+    const NinjaWriter::SharedFlags* shared_flags) {
+  base::FilePath flags_file(settings->build_settings()->GetFullPath(
+      GetNinjaFlagsFileForToolchain(settings)));
+  ScopedTrace trace(TraceItem::TRACE_FILE_WRITE_NINJA,
+                    FilePathToUTF8(flags_file));
+
+  // The values start with a space which Ninja strips.
+  StringOutputBuffer storage;
+  if (shared_flags) {
+    for (const auto& [name, value] : *shared_flags) {
+      storage.Append(name);
+      storage.Append(" =");
+      storage.Append(value);
+      storage.Append('\n');
+    }
+  }
+  return storage.WriteToFileIfChanged(flags_file, nullptr);
 }
 
 void NinjaToolchainWriter::WriteToolRule(Tool* tool,
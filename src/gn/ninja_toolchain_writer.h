@@ -22,11 +22,14 @@ class Tool;
 class NinjaToolchainWriter {
  public:
   // Takes the settings for the toolchain, as well as the list of all targets
-  // associated with the toolchain.
+  // associated with the toolchain. When the build uses shared_ninja_flags,
+  // this also writes the file defining the shared flag variables of the
+  // toolchain (|shared_flags| can be null if there are none).
   static bool RunAndWriteFile(
       const Settings* settings,
       const Toolchain* toolchain,
-      const std::vector<NinjaWriter::TargetRulePair>& rules);
+      const std::vector<NinjaWriter::TargetRulePair>& rules,
+      const NinjaWriter::SharedFlags* shared_flags = nullptr);
 
  private:
   FRIEND_TEST_ALL_PREFIXES(NinjaToolchainWriter, WriteToolRule);
@@ -39,6 +42,10 @@ class NinjaToolchainWriter {
 
   void Run(const std::vector<NinjaWriter::TargetRulePair>& extra_rules);
 
+  static bool WriteSharedFlagsFile(
+      const Settings* settings,
+      const NinjaWriter::SharedFlags* shared_flags);
+
   void WriteRules();
   void WriteToolRule(Tool* tool, const std::string& rule_prefix);
   void WriteRulePattern(const char* name,
@@ -21,6 +21,13 @@ SourceFile GetNinjaFileForToolchain(const Settings* settings) {
                     "toolchain.ninja");
 }
 
+SourceFile GetNinjaFlagsFileForToolchain(const Settings* settings) {
+  return SourceFile(GetBuildDirAsSourceDir(BuildDirContext(settings),
+                                           BuildDirType::TOOLCHAIN_ROOT)
+                        .value() +
+                    "flags.ninja");
+}
+
 std::string GetNinjaRulePrefixForToolchain(const Settings* settings) {
   // Don't prefix the default toolchain so it looks prettier, prefix everything
   // else.
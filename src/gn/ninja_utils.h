@@ -18,6 +18,10 @@ SourceFile GetNinjaFileForTarget(const Target* target);
 // Returns the name of the root .ninja file for the given toolchain.
 SourceFile GetNinjaFileForToolchain(const Settings* settings);
 
+// Returns the name of the file defining the shared flag variables of the given
+// toolchain, see BuildSettings::shared_ninja_flags().
+SourceFile GetNinjaFlagsFileForToolchain(const Settings* settings);
+
 // Returns the prefix applied to the Ninja rules in a given toolchain so they
 // don't collide with rules from other toolchains.
 std::string GetNinjaRulePrefixForToolchain(const Settings* settings);
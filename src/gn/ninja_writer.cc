@@ -11,36 +11,63 @@
 #include "gn/ninja_toolchain_writer.h"
 #include "gn/settings.h"
 #include "gn/target.h"
+#include "util/worker_pool.h"
 
 NinjaWriter::NinjaWriter(const Builder& builder) : builder_(builder) {}
 
 NinjaWriter::~NinjaWriter() = default;
 
 // static
-bool NinjaWriter::RunAndWriteFiles(const BuildSettings* build_settings,
-                                   const Builder& builder,
-                                   const PerToolchainRules& per_toolchain_rules,
-                                   Err* err) {
+bool NinjaWriter::RunAndWriteFiles(
+    const BuildSettings* build_settings,
+    const Builder& builder,
+    const PerToolchainRules& per_toolchain_rules,
+    const PerToolchainSharedFlags& per_toolchain_shared_flags,
+    Err* err) {
   NinjaWriter writer(builder);
 
-  if (!writer.WriteToolchains(per_toolchain_rules, err))
+  if (!writer.WriteToolchains(per_toolchain_rules, per_toolchain_shared_flags,
+                              err))
     return false;
   return NinjaBuildWriter::RunAndWriteFile(build_settings, builder, err);
 }
 
-bool NinjaWriter::WriteToolchains(const PerToolchainRules& per_toolchain_rules,
-                                  Err* err) {
+bool NinjaWriter::WriteToolchains(
+    const PerToolchainRules& per_toolchain_rules,
+    const PerToolchainSharedFlags& per_toolchain_shared_flags,
+    Err* err) {
   if (per_toolchain_rules.empty()) {
     *err = Err(Location(), "No targets.",
                "I could not find any targets to write, so I'm doing nothing.");
     return false;
   }
 
-  for (const auto& i : per_toolchain_rules) {
-    const Toolchain* toolchain = i.first;
-    const Settings* settings =
-        builder_.loader()->GetToolchainSettings(toolchain->label());
-    if (!NinjaToolchainWriter::RunAndWriteFile(settings, toolchain, i.second)) {
+  // Each toolchain file is independent, so format and write them all
+  // concurrently. Failures are reported in toolchain order so the error is
+  // deterministic.
+  std::vector<PerToolchainRules::const_iterator> toolchains;
+  toolchains.reserve(per_toolchain_rules.size());
+  for (auto i = per_toolchain_rules.begin(); i != per_toolchain_rules.end();
+       ++i)
+    toolchains.push_back(i);
+
+  std::vector<char> succeeded(toolchains.size(), 0);
+  WorkerPool::GetShared().ParallelFor(
+      toolchains.size(), [this, &toolchains, &per_toolchain_shared_flags,
+                          &succeeded](size_t index) {
+        const Toolchain* toolchain = toolchains[index]->first;
+        const Settings* settings =
+            builder_.loader()->GetToolchainSettings(toolchain->label());
+        auto shared_flags = per_toolchain_shared_flags.find(toolchain);
+        succeeded[index] = NinjaToolchainWriter::RunAndWriteFile(
+            settings, toolchain, toolchains[index]->second,
+            shared_flags == per_toolchain_shared_flags.end()
+                ? nullptr
+                : &shared_flags->second);
+      });
+
+  for (char success : succeeded) {
+    if (!success) {
       *err =
           Err(Location(), "Couldn't open toolchain buildfile(s) for writing");
       return false;
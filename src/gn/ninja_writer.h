@@ -25,19 +25,29 @@ class NinjaWriter {
   using PerToolchainRules =
       std::map<const Toolchain*, std::vector<TargetRulePair>>;
 
+  // The shared flag variables of a toolchain, as names mapped to values. See
+  // BuildSettings::shared_ninja_flags().
+  using SharedFlags = std::map<std::string, std::string>;
+  using PerToolchainSharedFlags = std::map<const Toolchain*, SharedFlags>;
+
   // On failure will populate |err| and will return false.  The map contains
   // the per-toolchain set of rules collected to write to the toolchain build
-  // files.
-  static bool RunAndWriteFiles(const BuildSettings* build_settings,
-                               const Builder& builder,
-                               const PerToolchainRules& per_toolchain_rules,
-                               Err* err);
+  // files. The shared flags are only used with shared_ninja_flags.
+  static bool RunAndWriteFiles(
+      const BuildSettings* build_settings,
+      const Builder& builder,
+      const PerToolchainRules& per_toolchain_rules,
+      const PerToolchainSharedFlags& per_toolchain_shared_flags,
+      Err* err);
 
  private:
   NinjaWriter(const Builder& builder);
   ~NinjaWriter();
 
-  bool WriteToolchains(const PerToolchainRules& per_toolchain_rules, Err* err);
+  bool WriteToolchains(
+      const PerToolchainRules& per_toolchain_rules,
+      const PerToolchainSharedFlags& per_toolchain_shared_flags,
+      Err* err);
 
   const Builder& builder_;
 
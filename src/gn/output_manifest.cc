@@ -0,0 +1,238 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/output_manifest.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "gn/filesystem_utils.h"
+#include "util/atomic_write.h"
+
+namespace {
+
+constexpr uint64_t kMul = 0xc6a4a7935bd1e995ull;
+constexpr int kShift = 47;
+
+// First line of the manifest. Bump the version when the format or the hash
+// function changes so that old manifests are ignored.
+const char kHeader[] = "# gn output manifest v1";
+
+}  // namespace
+
+const char OutputManifest::kFileName[] = ".gn_output_manifest";
+
+OutputManifest* g_output_manifest = nullptr;
+
+void ContentHasher::Update(std::string_view data) {
+  total_size_ += data.size();
+
+  if (pending_size_ > 0) {
+    size_t needed = std::min(sizeof(pending_) - pending_size_, data.size());
+    memcpy(pending_ + pending_size_, data.data(), needed);
+    pending_size_ += needed;
+    data.remove_prefix(needed);
+    if (pending_size_ < sizeof(pending_))
+      return;
+
+    uint64_t word;
+    memcpy(&word, pending_, sizeof(word));
+    MixWord(word);
+    pending_size_ = 0;
+  }
+
+  while (data.size() >= sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data.data(), sizeof(word));
+    MixWord(word);
+    data.remove_prefix(sizeof(word));
+  }
+
+  memcpy(pending_, data.data(), data.size());
+  pending_size_ = data.size();
+}
+
+uint64_t ContentHasher::Finish() const {
+  uint64_t hash = hash_;
+  if (pending_size_ > 0) {
+    uint64_t tail = 0;
+    for (size_t i = 0; i < pending_size_; i++)
+      tail |= static_cast<uint64_t>(static_cast<unsigned char>(pending_[i]))
+              << (8 * i);
+    hash ^= tail;
+    hash *= kMul;
+  }
+
+  // MurmurHash64A mixes the length in up front, which a streaming hash can't
+  // do, so mix it in here instead.
+  hash ^= total_size_ * kMul;
+  hash ^= hash >> kShift;
+  hash *= kMul;
+  hash ^= hash >> kShift;
+  return hash;
+}
+
+void ContentHasher::MixWord(uint64_t word) {
+  word *= kMul;
+  word ^= word >> kShift;
+  word *= kMul;
+
+  hash_ ^= word;
+  hash_ *= kMul;
+}
+
+OutputManifest::OutputManifest(const base::FilePath& manifest_file)
+    : manifest_file_(manifest_file) {}
+
+OutputManifest::~OutputManifest() {
+  if (g_output_manifest == this)
+    g_output_manifest = nullptr;
+}
+
+void OutputManifest::Load() {
+  std::string contents;
+  if (!base::ReadFileToString(manifest_file_, &contents))
+    return;
+
+  std::string_view remaining(contents);
+  size_t line_end = remaining.find('\n');
+  if (line_end == std::string_view::npos ||
+      remaining.substr(0, line_end) != kHeader)
+    return;
+  remaining.remove_prefix(line_end + 1);
+
+  // Each line is "<hash> <size> <last modified> <path>". The path comes last
+  // since it may contain spaces.
+  std::unordered_map<std::string, Entry> entries;
+  while (!remaining.empty()) {
+    line_end = remaining.find('\n');
+    if (line_end == std::string_view::npos)
+      return;  // Truncated, ignore everything.
+    std::string_view line = remaining.substr(0, line_end);
+    remaining.remove_prefix(line_end + 1);
+
+    std::string_view fields[3];
+    for (std::string_view& field : fields) {
+      size_t space = line.find(' ');
+      if (space == std::string_view::npos)
+        return;
+      field = line.substr(0, space);
+      line.remove_prefix(space + 1);
+    }
+
+    Entry entry;
+    uint64_t last_modified;
+    if (!base::StringToUint64(fields[0], &entry.hash) ||
+        !base::StringToSizeT(fields[1], &entry.size) ||
+        !base::StringToUint64(fields[2], &last_modified) || line.empty())
+      return;
+    entry.last_modified = last_modified;
+    entries[std::string(line)] = entry;
+  }
+
+  std::lock_guard<std::mutex> lock(lock_);
+  entries_ = std::move(entries);
+}
+
+bool OutputManifest::Save() const {
+  std::string contents(kHeader);
+  contents.push_back('\n');
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    for (const auto& [path, entry] : entries_) {
+      if (!entry.used)
+        continue;
+      contents.append(base::NumberToString(
+          static_cast<unsigned long long>(entry.hash)));
+      contents.push_back(' ');
+      contents.append(base::NumberToString(
+          static_cast<unsigned long long>(entry.size)));
+      contents.push_back(' ');
+      contents.append(base::NumberToString(
+          static_cast<unsigned long long>(entry.last_modified)));
+      contents.push_back(' ');
+      contents.append(path);
+      contents.push_back('\n');
+    }
+  }
+
+  return util::WriteFileAtomically(manifest_file_, contents.data(),
+                                   static_cast<int>(contents.size())) ==
+         static_cast<int>(contents.size());
+}
+
+bool OutputManifest::IsUpToDate(const base::FilePath& file,
+                                uint64_t hash,
+                                size_t size) {
+  std::string key = FilePathToUTF8(file);
+  Entry recorded;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto found = entries_.find(key);
+    if (found == entries_.end())
+      return false;
+    recorded = found->second;
+  }
+  if (recorded.hash != hash || recorded.size != size)
+    return false;
+
+  // The file must not have been touched since it was recorded.
+  base::File::Info info;
+  if (!base::GetFileInfo(file, &info) || info.is_directory ||
+      static_cast<size_t>(info.size) != size ||
+      info.last_modified != recorded.last_modified)
+    return false;
+
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    entries_[key].used = true;
+  }
+  files_skipped_++;
+  bytes_skipped_ += size;
+  return true;
+}
+
+void OutputManifest::Record(const base::FilePath& file,
+                            uint64_t hash,
+                            size_t size,
+                            bool written) {
+  if (written) {
+    files_written_++;
+    bytes_written_ += size;
+  } else {
+    files_skipped_++;
+    bytes_skipped_ += size;
+  }
+
+  std::string key = FilePathToUTF8(file);
+  base::File::Info info;
+  if (!base::GetFileInfo(file, &info)) {
+    // Without a timestamp the entry can't be trusted later.
+    std::lock_guard<std::mutex> lock(lock_);
+    entries_.erase(key);
+    return;
+  }
+
+  Entry entry;
+  entry.hash = hash;
+  entry.size = size;
+  entry.last_modified = info.last_modified;
+  entry.used = true;
+
+  std::lock_guard<std::mutex> lock(lock_);
+  entries_[key] = entry;
+}
+
+OutputManifest::Stats OutputManifest::GetStats() const {
+  Stats stats;
+  stats.files_written = files_written_;
+  stats.bytes_written = bytes_written_;
+  stats.files_skipped = files_skipped_;
+  stats.bytes_skipped = bytes_skipped_;
+  return stats;
+}
@@ -0,0 +1,120 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_OUTPUT_MANIFEST_H_
+#define TOOLS_GN_OUTPUT_MANIFEST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "base/files/file_path.h"
+#include "util/ticks.h"
+
+// Incrementally computes the 64-bit content hash recorded in the
+// OutputManifest. The hash is a streaming variant of MurmurHash64A, so the
+// result doesn't depend on how the data is split across Update() calls.
+class ContentHasher {
+ public:
+  ContentHasher() = default;
+
+  void Update(std::string_view data);
+  uint64_t Finish() const;
+
+ private:
+  void MixWord(uint64_t word);
+
+  uint64_t hash_ = 0xc70f6907ull;
+  uint64_t total_size_ = 0;
+
+  // Bytes that don't yet make up a full 8-byte word.
+  char pending_[8];
+  size_t pending_size_ = 0;
+};
+
+// Remembers the content hash, size and modification time of every file GN
+// writes to the build directory, and persists them in the build directory
+// between runs.
+//
+// When a file is about to be rewritten with contents whose hash matches the
+// recorded one, and the file on disk still has the recorded size and
+// modification time, it is known to be up to date without reading it back.
+// Files that don't change keep their timestamps so that nothing downstream is
+// re-run because of them.
+//
+// Thread-safe, files are written from worker threads.
+class OutputManifest {
+ public:
+  // Name of the manifest file in the root build directory.
+  static const char kFileName[];
+
+  struct Stats {
+    size_t files_written = 0;
+    size_t bytes_written = 0;
+    size_t files_skipped = 0;
+    size_t bytes_skipped = 0;
+  };
+
+  explicit OutputManifest(const base::FilePath& manifest_file);
+  ~OutputManifest();
+
+  // Reads the manifest written by a previous run. A missing, unreadable or
+  // incompatible manifest is treated as empty, which only means the next
+  // writes will fall back to comparing file contents.
+  void Load();
+
+  // Writes the entries for the files that were seen during this run. Files
+  // that were not written again are dropped since they are no longer outputs.
+  bool Save() const;
+
+  // Returns true if |file| is known to contain exactly the data with the given
+  // hash and size, based only on the recorded entry and a stat() of the file.
+  // Counts the file as skipped when returning true.
+  bool IsUpToDate(const base::FilePath& file, uint64_t hash, size_t size);
+
+  // Records the current state of |file| after it was found to be equal to the
+  // data with the given hash and size (|written| is false), or after that data
+  // was written to it (|written| is true).
+  void Record(const base::FilePath& file,
+              uint64_t hash,
+              size_t size,
+              bool written);
+
+  Stats GetStats() const;
+
+ private:
+  struct Entry {
+    uint64_t hash = 0;
+    size_t size = 0;
+    Ticks last_modified = 0;
+
+    // Set when the file was written or checked during this run.
+    bool used = false;
+  };
+
+  base::FilePath manifest_file_;
+
+  mutable std::mutex lock_;
+  std::unordered_map<std::string, Entry> entries_;
+
+  std::atomic<size_t> files_written_ = 0;
+  std::atomic<size_t> bytes_written_ = 0;
+  std::atomic<size_t> files_skipped_ = 0;
+  std::atomic<size_t> bytes_skipped_ = 0;
+
+  OutputManifest(const OutputManifest&) = delete;
+  OutputManifest& operator=(const OutputManifest&) = delete;
+};
+
+// The manifest used by StringOutputBuffer::WriteToFileIfChanged(). Null when
+// no build directory is being generated, in which case the contents of
+// existing files are always compared.
+extern OutputManifest* g_output_manifest;
+
+#endif  // TOOLS_GN_OUTPUT_MANIFEST_H_
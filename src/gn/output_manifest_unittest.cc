@@ -0,0 +1,169 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/output_manifest.h"
+
+#include <algorithm>
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "gn/filesystem_utils.h"
+#include "gn/string_output_buffer.h"
+#include "util/test/test.h"
+
+namespace {
+
+uint64_t HashInPieces(std::string_view data, size_t piece_size) {
+  ContentHasher hasher;
+  while (!data.empty()) {
+    size_t size = std::min(piece_size, data.size());
+    hasher.Update(data.substr(0, size));
+    data.remove_prefix(size);
+  }
+  return hasher.Finish();
+}
+
+Ticks GetLastModified(const base::FilePath& file) {
+  base::File::Info info;
+  EXPECT_TRUE(base::GetFileInfo(file, &info));
+  return info.last_modified;
+}
+
+// Sets g_output_manifest for the lifetime of the object.
+class ScopedOutputManifest {
+ public:
+  explicit ScopedOutputManifest(OutputManifest* manifest) {
+    g_output_manifest = manifest;
+  }
+  ~ScopedOutputManifest() { g_output_manifest = nullptr; }
+};
+
+}  // namespace
+
+TEST(OutputManifest, ContentHasher) {
+  std::string data;
+  for (int i = 0; i < 1000; i++)
+    data.push_back(static_cast<char>('a' + i % 26));
+
+  // The split into pieces must not matter.
+  uint64_t expected = HashInPieces(data, data.size());
+  for (size_t piece_size : {1, 3, 7, 8, 9, 64, 999})
+    EXPECT_EQ(expected, HashInPieces(data, piece_size));
+
+  // Different lengths and contents give different hashes.
+  EXPECT_NE(HashInPieces("", 1), HashInPieces(std::string(1, '\0'), 1));
+  EXPECT_NE(HashInPieces("abc", 1), HashInPieces("abd", 1));
+  EXPECT_NE(HashInPieces("abcdefgh", 8),
+            HashInPieces(std::string_view("abcdefgh\0", 9), 8));
+}
+
+TEST(OutputManifest, SkipsUnchangedFiles) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath manifest_file =
+      temp_dir.GetPath().AppendASCII(OutputManifest::kFileName);
+  base::FilePath file = temp_dir.GetPath().AppendASCII("foo.ninja");
+
+  StringOutputBuffer buffer;
+  buffer.Append("build foo: phony\n");
+
+  {
+    OutputManifest manifest(manifest_file);
+    manifest.Load();
+    ScopedOutputManifest scoped_manifest(&manifest);
+
+    bool written = false;
+    EXPECT_TRUE(buffer.WriteToFileIfChanged(file, nullptr, &written));
+    EXPECT_TRUE(written);
+    EXPECT_EQ(1u, manifest.GetStats().files_written);
+    EXPECT_EQ(buffer.size(), manifest.GetStats().bytes_written);
+    EXPECT_TRUE(manifest.Save());
+  }
+
+  Ticks last_modified = GetLastModified(file);
+
+  {
+    // A new run with the same contents doesn't touch the file.
+    OutputManifest manifest(manifest_file);
+    manifest.Load();
+    ScopedOutputManifest scoped_manifest(&manifest);
+    EXPECT_TRUE(
+        manifest.IsUpToDate(file, buffer.ContentHash(), buffer.size()));
+
+    bool written = true;
+    EXPECT_TRUE(buffer.WriteToFileIfChanged(file, nullptr, &written));
+    EXPECT_FALSE(written);
+    EXPECT_EQ(0u, manifest.GetStats().files_written);
+    EXPECT_EQ(2u, manifest.GetStats().files_skipped);
+    EXPECT_EQ(last_modified, GetLastModified(file));
+
+    // Different contents are written.
+    StringOutputBuffer other;
+    other.Append("build bar: phony\n");
+    EXPECT_TRUE(other.WriteToFileIfChanged(file, nullptr, &written));
+    EXPECT_TRUE(written);
+    std::string contents;
+    ASSERT_TRUE(base::ReadFileToString(file, &contents));
+    EXPECT_EQ("build bar: phony\n", contents);
+  }
+}
+
+TEST(OutputManifest, DetectsExternalChanges) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath manifest_file =
+      temp_dir.GetPath().AppendASCII(OutputManifest::kFileName);
+  base::FilePath file = temp_dir.GetPath().AppendASCII("foo.txt");
+
+  StringOutputBuffer buffer;
+  buffer.Append("contents");
+
+  OutputManifest manifest(manifest_file);
+  ScopedOutputManifest scoped_manifest(&manifest);
+  ASSERT_TRUE(buffer.WriteToFileIfChanged(file, nullptr));
+  uint64_t hash = buffer.ContentHash();
+  ASSERT_TRUE(manifest.IsUpToDate(file, hash, buffer.size()));
+
+  // Something else changed the file, so the manifest can't vouch for it and
+  // the file must be rewritten.
+  std::string changed = "CONTENTS+";
+  ASSERT_EQ(static_cast<int>(changed.size()),
+            base::WriteFile(file, changed.data(), changed.size()));
+  EXPECT_FALSE(manifest.IsUpToDate(file, hash, buffer.size()));
+
+  bool written = false;
+  EXPECT_TRUE(buffer.WriteToFileIfChanged(file, nullptr, &written));
+  EXPECT_TRUE(written);
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(file, &contents));
+  EXPECT_EQ("contents", contents);
+
+  // A deleted file isn't up to date either.
+  ASSERT_TRUE(base::DeleteFile(file, false));
+  EXPECT_FALSE(manifest.IsUpToDate(file, hash, buffer.size()));
+}
+
+TEST(OutputManifest, Load) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath manifest_file =
+      temp_dir.GetPath().AppendASCII(OutputManifest::kFileName);
+  base::FilePath file = temp_dir.GetPath().AppendASCII("foo bar.txt");
+  ASSERT_EQ(3, base::WriteFile(file, "foo", 3));
+
+  std::string entry = "1234 3 " + std::to_string(GetLastModified(file)) +
+                      " " + FilePathToUTF8(file) + "\n";
+  for (bool valid_header : {true, false}) {
+    std::string contents = valid_header ? "# gn output manifest v1\n"
+                                        : "# gn output manifest v0\n";
+    contents += entry;
+    ASSERT_EQ(static_cast<int>(contents.size()),
+              base::WriteFile(manifest_file, contents.data(),
+                              contents.size()));
+    OutputManifest manifest(manifest_file);
+    manifest.Load();
+    EXPECT_EQ(valid_header, manifest.IsUpToDate(file, 1234, 3));
+  }
+}
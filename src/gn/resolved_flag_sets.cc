@@ -0,0 +1,133 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/resolved_flag_sets.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <functional>
+#include <ostream>
+#include <utility>
+
+#include "base/strings/stringprintf.h"
+#include "gn/build_settings.h"
+#include "gn/output_manifest.h"
+#include "gn/settings.h"
+#include "gn/substitution_type.h"
+#include "gn/target.h"
+
+namespace {
+
+size_t HashCombine(size_t seed, size_t value) {
+  return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+}  // namespace
+
+ResolvedFlagSets::ResolvedFlagSets() = default;
+ResolvedFlagSets::~ResolvedFlagSets() = default;
+
+void ResolvedFlagSets::Key::Reset(const Substitution* new_kind,
+                                  RecursiveWriterConfig new_config,
+                                  std::string_view new_writer_args) {
+  kind = new_kind;
+  config = new_config;
+  writer_args.assign(new_writer_args);
+  sources.clear();
+  own_values.clear();
+}
+
+void ResolvedFlagSets::Key::AddOwnValue(std::string_view value) {
+  uint32_t size = static_cast<uint32_t>(value.size());
+  own_values.append(reinterpret_cast<const char*>(&size), sizeof(size));
+  own_values.append(value);
+}
+
+size_t ResolvedFlagSets::KeyHash::operator()(const Key& key) const {
+  size_t hash = std::hash<const void*>()(key.kind);
+  hash = HashCombine(hash, static_cast<size_t>(key.config));
+  hash = HashCombine(hash, std::hash<std::string_view>()(key.writer_args));
+  for (const void* source : key.sources)
+    hash = HashCombine(hash, std::hash<const void*>()(source));
+  return HashCombine(hash, std::hash<std::string_view>()(key.own_values));
+}
+
+const std::string* ResolvedFlagSets::Find() const {
+  auto found = sets_.find(key_);
+  return found == sets_.end() ? nullptr : &found->second;
+}
+
+const std::string& ResolvedFlagSets::Insert(std::string fragment) {
+  return sets_.emplace(key_, std::move(fragment)).first->second;
+}
+
+void ResolvedFlagSets::WriteFlags(const Target* target,
+                                  const Substitution* kind,
+                                  const std::string& flags,
+                                  std::ostream& out) {
+  // A reference is " $<ninja_name>_<16 hex digits>", don't use one when the
+  // flags are as short as that.
+  if (!target->settings()->build_settings()->shared_ninja_flags() ||
+      flags.size() <= strlen(kind->ninja_name) + 18) {
+    out << flags;
+    return;
+  }
+
+  auto [found, inserted] = shared_names_.emplace(&flags, std::string());
+  std::string& name = found->second;
+  if (inserted) {
+    // Names only depend on the contents so that all the threads writing
+    // targets agree on them.
+    ContentHasher hasher;
+    hasher.Update(flags);
+    name = base::StringPrintf(
+        "%s_%016llx", kind->ninja_name,
+        static_cast<unsigned long long>(hasher.Finish()));
+  }
+
+  SharedVariables& variables = shared_variables_[target->toolchain()];
+  auto variable = variables.find(name);
+  if (variable == variables.end()) {
+    if (!ClaimName(target->toolchain(), name, &flags)) {
+      // Hash collision with flags written by another thread, keep these
+      // flags inline.
+      out << flags;
+      return;
+    }
+    variable = variables.emplace(name, &flags).first;
+  } else if (variable->second != &flags && *variable->second != flags) {
+    // Hash collision, keep these flags inline.
+    out << flags;
+    return;
+  }
+  out << " $" << name;
+}
+
+bool ResolvedFlagSets::ClaimName(const Toolchain* toolchain,
+                                 const std::string& name,
+                                 const std::string* flags) {
+  if (!shared_flag_names_)
+    return true;
+  auto key = std::make_pair(toolchain, name);
+  if (names_claimed_elsewhere_.count(key))
+    return false;
+  if (shared_flag_names_->Claim(toolchain, name, flags))
+    return true;
+  names_claimed_elsewhere_.insert(std::move(key));
+  return false;
+}
+
+SharedFlagNames::SharedFlagNames() = default;
+
+SharedFlagNames::~SharedFlagNames() = default;
+
+bool SharedFlagNames::Claim(const Toolchain* toolchain,
+                            const std::string& name,
+                            const std::string* flags) {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto [found, inserted] =
+      names_.emplace(std::make_pair(toolchain, name), flags);
+  return inserted || found->second == flags || *found->second == *flags;
+}
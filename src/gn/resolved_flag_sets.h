@@ -0,0 +1,191 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_RESOLVED_FLAG_SETS_H_
+#define TOOLS_GN_RESOLVED_FLAG_SETS_H_
+
+#include <stddef.h>
+
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gn/config_values_extractors.h"
+#include "gn/source_dir.h"
+
+struct Substitution;
+class Toolchain;
+
+// Names of the shared flag variables used by the ResolvedFlagSets of all the
+// threads writing targets. The names are derived from the flags, so a name
+// can only be given to different flags by a hash collision; the first thread
+// to use the name keeps it. Thread-safe.
+class SharedFlagNames {
+ public:
+  SharedFlagNames();
+  ~SharedFlagNames();
+
+  // Returns true if |name| is not used in |toolchain| yet, or is used for the
+  // same flags. The flags must outlive this object.
+  bool Claim(const Toolchain* toolchain,
+             const std::string& name,
+             const std::string* flags);
+
+ private:
+  std::mutex lock_;
+  std::map<std::pair<const Toolchain*, std::string>, const std::string*>
+      names_;
+
+  SharedFlagNames(const SharedFlagNames&) = delete;
+  SharedFlagNames& operator=(const SharedFlagNames&) = delete;
+};
+
+// Interns the flag fragments written for the config values of targets, such
+// as the " -DFOO -DBAR" written for {{defines}}.
+//
+// Many targets share the same stack of configs, and the flags of a given
+// kind are then the same for all of them. A resolved flag set is identified
+// by the values of the target itself and the (ordered) list of the configs
+// that have non-empty values of that kind, so the configs are only walked to
+// build the key, and the values are only de-duplicated and escaped the first
+// time a set is seen.
+//
+// The result of a lookup is the fragment that RecursiveTargetConfigToStream()
+// would write with the given writer. The writer itself is not part of the key:
+// all lookups for the same |kind| must use equivalent writers (same escaping
+// and, for directories, the same PathOutput directory), except for the
+// |writer_args| passed with it, which are. These hold what the writer takes
+// from the toolchain, like the switch of FrameworkDirsWriter, since the
+// instance is shared by the targets of all the toolchains.
+//
+// When the build uses the shared_ninja_flags option of the .gn file, the
+// fragments are written as references to Ninja variables defined once per
+// toolchain, see WriteFlags().
+//
+// The config pointers of the keys must outlive the instance. This is not
+// thread-safe, it is owned by a ResolvedTargetData which is per-thread.
+class ResolvedFlagSets {
+ public:
+  ResolvedFlagSets();
+  ~ResolvedFlagSets();
+
+  template <typename T, class Writer>
+  const std::string& Get(const Substitution* kind,
+                         RecursiveWriterConfig config,
+                         const Target* target,
+                         const std::vector<T>& (ConfigValues::*getter)() const,
+                         const Writer& writer,
+                         std::string_view writer_args = std::string_view()) {
+    key_.Reset(kind, config, writer_args);
+    if (target->has_config_values()) {
+      for (const T& value : (target->config_values().*getter)())
+        key_.AddOwnValue(ValueOf(value));
+    }
+    for (const auto& pair : target->configs()) {
+      const std::vector<T>& values = (pair.ptr->resolved_values().*getter)();
+      if (!values.empty())
+        key_.sources.push_back(&values);
+    }
+
+    if (const std::string* found = Find())
+      return *found;
+
+    std::ostringstream out;
+    RecursiveTargetConfigToStream<T>(config, target, getter, writer, out);
+    return Insert(out.str());
+  }
+
+  // Writes a fragment returned by Get() for the given target and kind of
+  // flags. With shared_ninja_flags, this writes a reference to a shared
+  // variable instead when that is shorter, and records the variable in
+  // shared_variables().
+  void WriteFlags(const Target* target,
+                  const Substitution* kind,
+                  const std::string& flags,
+                  std::ostream& out);
+
+  // Sets the names shared with the other threads writing targets, so that
+  // WriteFlags() keeps flags inline rather than reuse a name that another
+  // thread defines differently in the same toolchain.
+  void set_shared_flag_names(SharedFlagNames* names) {
+    shared_flag_names_ = names;
+  }
+
+  // The shared variables referenced by WriteFlags(), as variable names mapped
+  // to the fragments, for each toolchain.
+  using SharedVariables = std::map<std::string, const std::string*>;
+  const std::map<const Toolchain*, SharedVariables>& shared_variables() const {
+    return shared_variables_;
+  }
+
+  // Number of distinct flag sets seen so far.
+  size_t size() const { return sets_.size(); }
+
+ private:
+  struct Key {
+    void Reset(const Substitution* new_kind,
+               RecursiveWriterConfig new_config,
+               std::string_view new_writer_args);
+    void AddOwnValue(std::string_view value);
+
+    bool operator==(const Key& other) const {
+      return kind == other.kind && config == other.config &&
+             writer_args == other.writer_args && sources == other.sources &&
+             own_values == other.own_values;
+    }
+
+    const Substitution* kind = nullptr;
+    RecursiveWriterConfig config = kRecursiveWriterKeepDuplicates;
+    std::string writer_args;
+
+    // The value vectors of the configs that contribute values, in order.
+    std::vector<const void*> sources;
+
+    // The values of the target itself, each prefixed by its length.
+    std::string own_values;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  static std::string_view ValueOf(const std::string& value) { return value; }
+  static std::string_view ValueOf(const SourceDir& value) {
+    return value.value();
+  }
+
+  const std::string* Find() const;
+  const std::string& Insert(std::string fragment);
+
+  // Claims |name| for |flags| in |toolchain| in |shared_flag_names_|.
+  bool ClaimName(const Toolchain* toolchain,
+                 const std::string& name,
+                 const std::string* flags);
+
+  // Reused to build the key of every lookup.
+  Key key_;
+
+  std::unordered_map<Key, std::string, KeyHash> sets_;
+
+  // Name of the shared variable for each fragment of |sets_|.
+  std::unordered_map<const std::string*, std::string> shared_names_;
+  std::map<const Toolchain*, SharedVariables> shared_variables_;
+
+  SharedFlagNames* shared_flag_names_ = nullptr;
+
+  // Names that another thread claimed for other flags.
+  std::set<std::pair<const Toolchain*, std::string>> names_claimed_elsewhere_;
+
+  ResolvedFlagSets(const ResolvedFlagSets&) = delete;
+  ResolvedFlagSets& operator=(const ResolvedFlagSets&) = delete;
+};
+
+#endif  // TOOLS_GN_RESOLVED_FLAG_SETS_H_
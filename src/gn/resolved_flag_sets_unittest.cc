@@ -0,0 +1,278 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/resolved_flag_sets.h"
+
+#include "gn/c_substitution_type.h"
+#include "gn/config.h"
+#include "gn/escape.h"
+#include "gn/ninja_target_command_util.h"
+#include "gn/test_with_scope.h"
+#include "util/test/test.h"
+
+namespace {
+
+struct DirWriter {
+  void operator()(const SourceDir& dir, std::ostream& out) const {
+    out << " " << dir.value();
+  }
+};
+
+}  // namespace
+
+TEST(ResolvedFlagSets, SharedConfigs) {
+  TestWithScope setup;
+  Err err;
+
+  Config first(setup.settings(), Label(SourceDir("//foo/"), "first"));
+  first.visibility().SetPublic();
+  first.own_values().cflags().push_back("-a");
+  first.own_values().cflags().push_back("-b c");
+  first.own_values().include_dirs().push_back(SourceDir("//foo/"));
+  ASSERT_TRUE(first.OnResolved(&err));
+
+  Config second(setup.settings(), Label(SourceDir("//foo/"), "second"));
+  second.visibility().SetPublic();
+  second.own_values().cflags().push_back("-a");
+  second.own_values().include_dirs().push_back(SourceDir("//foo/"));
+  ASSERT_TRUE(second.OnResolved(&err));
+
+  // Has no cflags, so it doesn't change the cflags of the targets using it.
+  Config empty(setup.settings(), Label(SourceDir("//foo/"), "empty"));
+  empty.visibility().SetPublic();
+  empty.own_values().defines().push_back("EMPTY");
+  ASSERT_TRUE(empty.OnResolved(&err));
+
+  TestTarget a(setup, "//foo:a", Target::SOURCE_SET);
+  a.configs().push_back(LabelConfigPair(&first));
+  a.configs().push_back(LabelConfigPair(&second));
+  ASSERT_TRUE(a.OnResolved(&err));
+
+  TestTarget b(setup, "//foo:b", Target::SOURCE_SET);
+  b.configs().push_back(LabelConfigPair(&first));
+  b.configs().push_back(LabelConfigPair(&empty));
+  b.configs().push_back(LabelConfigPair(&second));
+  ASSERT_TRUE(b.OnResolved(&err));
+
+  // Same configs in a different order.
+  TestTarget c(setup, "//foo:c", Target::SOURCE_SET);
+  c.configs().push_back(LabelConfigPair(&second));
+  c.configs().push_back(LabelConfigPair(&first));
+  ASSERT_TRUE(c.OnResolved(&err));
+
+  // Same configs but with values of its own.
+  TestTarget d(setup, "//foo:d", Target::SOURCE_SET);
+  d.config_values().cflags().push_back("-d");
+  d.configs().push_back(LabelConfigPair(&first));
+  d.configs().push_back(LabelConfigPair(&second));
+  ASSERT_TRUE(d.OnResolved(&err));
+
+  TestTarget e(setup, "//foo:e", Target::SOURCE_SET);
+  e.config_values().cflags().push_back("-d");
+  e.configs().push_back(LabelConfigPair(&first));
+  e.configs().push_back(LabelConfigPair(&second));
+  ASSERT_TRUE(e.OnResolved(&err));
+
+  EscapeOptions opts;
+  opts.mode = ESCAPE_NINJA_COMMAND;
+  ResolvedFlagSets flag_sets;
+  auto get_cflags = [&](const Target* target) -> const std::string& {
+    return flag_sets.Get<std::string>(
+        &CSubstitutionCFlags, kRecursiveWriterKeepDuplicates, target,
+        &ConfigValues::cflags, EscapedStringWriter(opts));
+  };
+
+  const std::string& a_cflags = get_cflags(&a);
+  EXPECT_EQ(" -a -b\\$ c -a", a_cflags);
+  EXPECT_EQ(1u, flag_sets.size());
+  EXPECT_EQ(&a_cflags, &get_cflags(&b));
+  EXPECT_EQ(1u, flag_sets.size());
+
+  EXPECT_EQ(" -a -a -b\\$ c", get_cflags(&c));
+  EXPECT_EQ(2u, flag_sets.size());
+
+  const std::string& d_cflags = get_cflags(&d);
+  EXPECT_EQ(" -d -a -b\\$ c -a", d_cflags);
+  EXPECT_EQ(&d_cflags, &get_cflags(&e));
+  EXPECT_EQ(3u, flag_sets.size());
+
+  // Other kinds of flags are separate sets, and duplicates are removed when
+  // requested.
+  EXPECT_EQ(" //foo/",
+            flag_sets.Get<SourceDir>(&CSubstitutionIncludeDirs,
+                                     kRecursiveWriterSkipDuplicates, &a,
+                                     &ConfigValues::include_dirs, DirWriter()));
+  EXPECT_EQ(" //foo/ //foo/",
+            flag_sets.Get<SourceDir>(&CSubstitutionIncludeDirs,
+                                     kRecursiveWriterKeepDuplicates, &a,
+                                     &ConfigValues::include_dirs, DirWriter()));
+  EXPECT_EQ(5u, flag_sets.size());
+}
+
+TEST(ResolvedFlagSets, SharedVariables) {
+  TestWithScope setup;
+  Err err;
+
+  TestTarget a(setup, "//foo:a", Target::SOURCE_SET);
+  a.config_values().defines().push_back("SOME_LONG_DEFINE=1");
+  a.config_values().defines().push_back("ANOTHER_LONG_DEFINE=2");
+  ASSERT_TRUE(a.OnResolved(&err));
+
+  TestTarget b(setup, "//foo:b", Target::SOURCE_SET);
+  b.config_values().defines().push_back("SOME_LONG_DEFINE=1");
+  b.config_values().defines().push_back("ANOTHER_LONG_DEFINE=2");
+  ASSERT_TRUE(b.OnResolved(&err));
+
+  TestTarget c(setup, "//foo:c", Target::SOURCE_SET);
+  c.config_values().defines().push_back("A");
+  ASSERT_TRUE(c.OnResolved(&err));
+
+  ResolvedFlagSets flag_sets;
+  auto write_defines = [&](const Target* target) {
+    std::ostringstream out;
+    flag_sets.WriteFlags(
+        target, &CSubstitutionDefines,
+        flag_sets.Get<std::string>(&CSubstitutionDefines,
+                                   kRecursiveWriterSkipDuplicates, target,
+                                   &ConfigValues::defines, DefineWriter()),
+        out);
+    return out.str();
+  };
+
+  // The flags are written inline by default.
+  EXPECT_EQ(" -DSOME_LONG_DEFINE=1 -DANOTHER_LONG_DEFINE=2", write_defines(&a));
+  EXPECT_TRUE(flag_sets.shared_variables().empty());
+
+  setup.build_settings()->set_shared_ninja_flags(true);
+  std::string reference = write_defines(&a);
+  ASSERT_EQ(0u, reference.find(" $defines_"));
+  EXPECT_EQ(std::string(" $defines_").size() + 16, reference.size());
+  EXPECT_EQ(reference, write_defines(&b));
+
+  // Flags shorter than a reference stay inline.
+  EXPECT_EQ(" -DA", write_defines(&c));
+
+  ASSERT_EQ(1u, flag_sets.shared_variables().size());
+  const ResolvedFlagSets::SharedVariables& variables =
+      flag_sets.shared_variables().at(setup.toolchain());
+  ASSERT_EQ(1u, variables.size());
+  EXPECT_EQ(reference.substr(2), variables.begin()->first);
+  EXPECT_EQ(" -DSOME_LONG_DEFINE=1 -DANOTHER_LONG_DEFINE=2",
+            *variables.begin()->second);
+}
+
+// A name claimed by another thread for other flags, by a hash collision,
+// isn't used and the flags stay inline.
+TEST(ResolvedFlagSets, SharedVariablesClaimedElsewhere) {
+  TestWithScope setup;
+  setup.build_settings()->set_shared_ninja_flags(true);
+  Err err;
+
+  TestTarget a(setup, "//foo:a", Target::SOURCE_SET);
+  a.config_values().defines().push_back("SOME_LONG_DEFINE=1");
+  a.config_values().defines().push_back("ANOTHER_LONG_DEFINE=2");
+  ASSERT_TRUE(a.OnResolved(&err));
+
+  auto write_defines = [&](ResolvedFlagSets* flag_sets) {
+    std::ostringstream out;
+    flag_sets->WriteFlags(
+        &a, &CSubstitutionDefines,
+        flag_sets->Get<std::string>(&CSubstitutionDefines,
+                                    kRecursiveWriterSkipDuplicates, &a,
+                                    &ConfigValues::defines, DefineWriter()),
+        out);
+    return out.str();
+  };
+
+  // Finds the name of the variable for these flags.
+  ResolvedFlagSets first;
+  std::string reference = write_defines(&first);
+  ASSERT_EQ(0u, reference.find(" $defines_"));
+  std::string name = reference.substr(2);
+
+  // Other flags claimed the name first on another thread.
+  SharedFlagNames names;
+  const std::string other_flags = " -DOTHER_LONG_DEFINE=3";
+  ASSERT_TRUE(names.Claim(setup.toolchain(), name, &other_flags));
+
+  ResolvedFlagSets second;
+  second.set_shared_flag_names(&names);
+  EXPECT_EQ(" -DSOME_LONG_DEFINE=1 -DANOTHER_LONG_DEFINE=2",
+            write_defines(&second));
+  EXPECT_EQ(" -DSOME_LONG_DEFINE=1 -DANOTHER_LONG_DEFINE=2",
+            write_defines(&second));
+  EXPECT_TRUE(second.shared_variables().at(setup.toolchain()).empty());
+
+  // A thread claiming the name for the same flags shares the variable.
+  ResolvedFlagSets third;
+  SharedFlagNames same_names;
+  const std::string same_flags =
+      " -DSOME_LONG_DEFINE=1 -DANOTHER_LONG_DEFINE=2";
+  ASSERT_TRUE(same_names.Claim(setup.toolchain(), name, &same_flags));
+  third.set_shared_flag_names(&same_names);
+  EXPECT_EQ(reference, write_defines(&third));
+}
+
+// The same framework_dirs in toolchains using different framework dir
+// switches are different fragments, each defined in its toolchain.
+TEST(ResolvedFlagSets, SharedVariablesPerToolchain) {
+  TestWithScope setup;
+  setup.build_settings()->set_shared_ninja_flags(true);
+  Err err;
+
+  Toolchain other_toolchain(setup.settings(),
+                            Label(SourceDir("//tc/"), "other"));
+  TestWithScope::SetupToolchain(&other_toolchain);
+
+  TestTarget a(setup, "//foo:a", Target::SOURCE_SET);
+  a.config_values().framework_dirs().push_back(
+      SourceDir("//some/long/framework/directory/"));
+  ASSERT_TRUE(a.OnResolved(&err));
+
+  Target b(setup.settings(),
+           Label(SourceDir("//foo/"), "b", other_toolchain.label().dir(),
+                 other_toolchain.label().name()));
+  b.set_output_type(Target::SOURCE_SET);
+  b.config_values().framework_dirs().push_back(
+      SourceDir("//some/long/framework/directory/"));
+  b.SetToolchain(&other_toolchain);
+  ASSERT_TRUE(b.OnResolved(&err));
+
+  ResolvedFlagSets flag_sets;
+  PathOutput path_output(setup.build_settings()->build_dir(),
+                         setup.build_settings()->root_path_utf8(),
+                         ESCAPE_NINJA_COMMAND);
+  auto write_framework_dirs = [&](const Target* target,
+                                  const std::string& tool_switch) {
+    std::ostringstream out;
+    flag_sets.WriteFlags(
+        target, &CSubstitutionFrameworkDirs,
+        flag_sets.Get<SourceDir>(&CSubstitutionFrameworkDirs,
+                                 kRecursiveWriterSkipDuplicates, target,
+                                 &ConfigValues::framework_dirs,
+                                 FrameworkDirsWriter(path_output, tool_switch),
+                                 tool_switch),
+        out);
+    return out.str();
+  };
+
+  std::string reference_a = write_framework_dirs(&a, "-F");
+  std::string reference_b = write_framework_dirs(&b, "/FW:");
+  EXPECT_NE(reference_a, reference_b);
+
+  ASSERT_EQ(2u, flag_sets.shared_variables().size());
+  const ResolvedFlagSets::SharedVariables& variables_a =
+      flag_sets.shared_variables().at(setup.toolchain());
+  ASSERT_EQ(1u, variables_a.size());
+  EXPECT_EQ(reference_a.substr(2), variables_a.begin()->first);
+  EXPECT_EQ(" -F../../some/long/framework/directory",
+            *variables_a.begin()->second);
+
+  const ResolvedFlagSets::SharedVariables& variables_b =
+      flag_sets.shared_variables().at(&other_toolchain);
+  ASSERT_EQ(1u, variables_b.size());
+  EXPECT_EQ(reference_b.substr(2), variables_b.begin()->first);
+  EXPECT_EQ(" /FW:../../some/long/framework/directory",
+            *variables_b.begin()->second);
+}
@@ -10,6 +10,7 @@
 
 #include "base/containers/span.h"
 #include "gn/lib_file.h"
+#include "gn/resolved_flag_sets.h"
 #include "gn/resolved_target_deps.h"
 #include "gn/source_dir.h"
 #include "gn/target.h"
@@ -128,6 +129,10 @@ class ResolvedTargetData {
     return info->swift_values->modules;
   }
 
+  // The flag fragments written for the config values of targets, shared by
+  // all the targets that use the same configs.
+  ResolvedFlagSets& flag_sets() const { return flag_sets_; }
+
  private:
   // The information associated with a given Target pointer.
   struct TargetInfo {
@@ -274,6 +279,8 @@ class ResolvedTargetData {
   // instances for best performance.
   mutable UniqueVector<const Target*> targets_;
   mutable std::vector<std::unique_ptr<TargetInfo>> infos_;
+
+  mutable ResolvedFlagSets flag_sets_;
 };
 
 #endif  // TOOLS_GN_RESOLVED_TARGET_DATA_H_
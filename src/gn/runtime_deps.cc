@@ -4,7 +4,6 @@
 
 #include "gn/runtime_deps.h"
 
-#include <map>
 #include <set>
 #include <sstream>
 
@@ -15,6 +14,7 @@
 #include "gn/builder.h"
 #include "gn/deps_iterator.h"
 #include "gn/filesystem_utils.h"
+#include "gn/id_table.h"
 #include "gn/loader.h"
 #include "gn/output_file.h"
 #include "gn/scheduler.h"
@@ -52,27 +52,28 @@ void AddIfNew(const std::string& str,
 
 // To avoid duplicate traversals of targets, or duplicating output files that
 // might be listed by more than one target, the set of targets and output files
-// that have been found so far is passed. The "value" of the seen_targets map
-// is a boolean indicating if the seen dep was a data dep (true = data_dep).
-// data deps add more stuff, so we will want to revisit a target if it's a
-// data dependency and we've previously only seen it as a regular dep.
+// that have been found so far is passed. The targets seen as data deps are
+// also recorded in seen_data_targets. data deps add more stuff, so we will
+// want to revisit a target if it's a data dependency and we've previously only
+// seen it as a regular dep.
 void RecursiveCollectRuntimeDeps(const Target* target,
                                  bool is_target_data_dep,
                                  RuntimeDepsVector* deps,
-                                 std::map<const Target*, bool>* seen_targets,
+                                 IdBitSet* seen_targets,
+                                 IdBitSet* seen_data_targets,
                                  std::set<OutputFile>* found_files) {
-  const auto& found_seen_target = seen_targets->find(target);
-  if (found_seen_target != seen_targets->end()) {
+  if (!seen_targets->add(target->id())) {
     // Already visited.
-    if (found_seen_target->second || !is_target_data_dep) {
+    if (!is_target_data_dep || !seen_data_targets->add(target->id())) {
       // Already visited as a data dep, or the current dep is not a data
       // dep so visiting again will be a no-op.
       return;
     }
     // In the else case, the previously seen target was a regular dependency
     // and we'll now process it as a data dependency.
+  } else if (is_target_data_dep) {
+    seen_data_targets->add(target->id());
   }
-  (*seen_targets)[target] = is_target_data_dep;
 
   // Add the main output file for executables, shared libraries, and
   // loadable modules.
@@ -100,7 +101,7 @@ void RecursiveCollectRuntimeDeps(const Target* target,
   // Data dependencies.
   for (const auto& dep_pair : target->data_deps()) {
     RecursiveCollectRuntimeDeps(dep_pair.ptr, true, deps, seen_targets,
-                                found_files);
+                                seen_data_targets, found_files);
   }
 
   // Do not recurse into bundle targets. A bundle's dependencies should be
@@ -124,7 +125,7 @@ void RecursiveCollectRuntimeDeps(const Target* target,
       continue;
     }
     RecursiveCollectRuntimeDeps(dep_pair.ptr, false, deps, seen_targets,
-                                found_files);
+                                seen_data_targets, found_files);
   }
 }
 
@@ -294,14 +295,15 @@ Multiple outputs
 
 RuntimeDepsVector ComputeRuntimeDeps(const Target* target) {
   RuntimeDepsVector result;
-  std::map<const Target*, bool> seen_targets;
+  IdBitSet seen_targets;
+  IdBitSet seen_data_targets;
   std::set<OutputFile> found_files;
 
   // The initial target is not considered a data dependency so that actions's
   // outputs (if the current target is an action) are not automatically
   // considered data deps.
   RecursiveCollectRuntimeDeps(target, false, &result, &seen_targets,
-                              &found_files);
+                              &seen_data_targets, &found_files);
   return result;
 }
 
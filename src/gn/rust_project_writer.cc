@@ -4,14 +4,18 @@
 
 #include "gn/rust_project_writer.h"
 
+#include <algorithm>
 #include <fstream>
+#include <memory>
 #include <optional>
 #include <sstream>
 #include <tuple>
+#include <utility>
 
 #include "base/json/string_escape.h"
 #include "base/strings/string_split.h"
 #include "gn/builder.h"
+#include "gn/commands.h"
 #include "gn/deps_iterator.h"
 #include "gn/ninja_target_command_util.h"
 #include "gn/rust_project_writer_helpers.h"
@@ -19,6 +23,7 @@
 #include "gn/source_file.h"
 #include "gn/string_output_buffer.h"
 #include "gn/tool.h"
+#include "util/worker_pool.h"
 
 #if defined(OS_WINDOWS)
 #define NEWLINE "\r\n"
@@ -60,6 +65,7 @@
 bool RustProjectWriter::RunAndWriteFiles(const BuildSettings* build_settings,
                                          const Builder& builder,
                                          const std::string& file_name,
+                                         const std::string& root_filters,
                                          bool quiet,
                                          Err* err) {
   SourceFile output_file = build_settings->build_dir().ResolveRelativeFile(
@@ -70,6 +76,14 @@ bool RustProjectWriter::RunAndWriteFiles(const BuildSettings* build_settings,
   base::FilePath output_path = build_settings->GetFullPath(output_file);
 
   std::vector<const Target*> all_targets = builder.GetAllResolvedTargets();
+  if (!root_filters.empty()) {
+    std::vector<LabelPattern> patterns;
+    if (!commands::FilterPatternsFromString(build_settings, root_filters,
+                                            &patterns, err)) {
+      return false;
+    }
+    all_targets = FilterToRootsClosure(all_targets, patterns);
+  }
 
   StringOutputBuffer out_buffer;
   std::ostream out(&out_buffer);
@@ -78,6 +92,38 @@ bool RustProjectWriter::RunAndWriteFiles(const BuildSettings* build_settings,
   return out_buffer.WriteToFileIfChanged(output_path, err);
 }
 
+// static
+std::vector<const Target*> RustProjectWriter::FilterToRootsClosure(
+    const std::vector<const Target*>& all_targets,
+    const std::vector<LabelPattern>& patterns) {
+  std::vector<const Target*> roots;
+  commands::FilterTargetsByPatterns(all_targets, patterns, &roots);
+
+  TargetSet closure;
+  std::vector<const Target*> stack;
+  for (const Target* root : roots) {
+    if (closure.add(root))
+      stack.push_back(root);
+  }
+  while (!stack.empty()) {
+    const Target* target = stack.back();
+    stack.pop_back();
+    for (const auto& pair : target->GetDeps(Target::DEPS_LINKED)) {
+      if (closure.add(pair.ptr))
+        stack.push_back(pair.ptr);
+    }
+  }
+
+  // Keep the original order so that the crates are numbered as they would be
+  // without filtering.
+  std::vector<const Target*> result;
+  for (const Target* target : all_targets) {
+    if (closure.contains(target))
+      result.push_back(target);
+  }
+  return result;
+}
+
 // Map of Targets to their index in the crates list (for linking dependencies to
 // their indexes).
 using TargetIndexMap = std::unordered_map<const Target*, uint32_t>;
@@ -85,11 +131,17 @@ using TargetIndexMap = std::unordered_map<const Target*, uint32_t>;
 // A collection of Targets.
 using TargetsVector = UniqueVector<const Target*>;
 
+// Rust deps of the groups already expanded by GetRustDeps(), since groups are
+// often depended on by many targets.
+using GroupRustDepsMap = std::unordered_map<const Target*, TargetsVector>;
+
 // Get the Rust deps for a target, recursively expanding OutputType::GROUPS
 // that are present in the GN structure.  This will return a flattened list of
 // deps from the groups, but will not expand a Rust lib dependency to find any
 // transitive Rust dependencies.
-void GetRustDeps(const Target* target, TargetsVector* rust_deps) {
+void GetRustDeps(const Target* target,
+                 GroupRustDepsMap* group_deps,
+                 TargetsVector* rust_deps) {
   for (const auto& pair : target->GetDeps(Target::DEPS_LINKED)) {
     const Target* dep = pair.ptr;
 
@@ -98,24 +150,23 @@ void GetRustDeps(const Target* target, TargetsVector* rust_deps) {
       rust_deps->push_back(dep);
     } else if (dep->output_type() == Target::OutputType::GROUP) {
       // Inspect (recursively) any group to see if it contains Rust deps.
-      GetRustDeps(dep, rust_deps);
+      auto found = group_deps->find(dep);
+      if (found == group_deps->end()) {
+        TargetsVector deps;
+        GetRustDeps(dep, group_deps, &deps);
+        found = group_deps->emplace(dep, std::move(deps)).first;
+      }
+      for (const Target* group_dep : found->second)
+        rust_deps->push_back(group_dep);
     }
   }
 }
-TargetsVector GetRustDeps(const Target* target) {
-  TargetsVector deps;
-  GetRustDeps(target, &deps);
-  return deps;
-}
 
 std::vector<std::string> ExtractCompilerArgs(const Target* target) {
   std::vector<std::string> args;
   for (ConfigValuesIterator iter(target); !iter.done(); iter.Next()) {
-    auto rustflags = iter.cur().rustflags();
-    for (auto flag_iter = rustflags.begin(); flag_iter != rustflags.end();
-         flag_iter++) {
-      args.push_back(*flag_iter);
-    }
+    const auto& rustflags = iter.cur().rustflags();
+    args.insert(args.end(), rustflags.begin(), rustflags.end());
   }
   return args;
 }
@@ -124,7 +175,7 @@ std::optional<std::string> FindArgValue(const char* arg,
                                         const std::vector<std::string>& args) {
   for (auto current = args.begin(); current != args.end();) {
     // capture the current value
-    auto previous = *current;
+    const auto& previous = *current;
     // and increment
     current++;
 
@@ -140,7 +191,7 @@ std::optional<std::string> FindArgValue(const char* arg,
 std::optional<std::string> FindArgValueAfterPrefix(
     const std::string& prefix,
     const std::vector<std::string>& args) {
-  for (auto arg : args) {
+  for (const auto& arg : args) {
     if (!arg.compare(0, prefix.size(), prefix)) {
       auto value = arg.substr(prefix.size());
       return std::make_optional(value);
@@ -153,17 +204,108 @@ std::vector<std::string> FindAllArgValuesAfterPrefix(
     const std::string& prefix,
     const std::vector<std::string>& args) {
   std::vector<std::string> values;
-  for (auto arg : args) {
+  for (const auto& arg : args) {
     if (!arg.compare(0, prefix.size(), prefix)) {
-      auto value = arg.substr(prefix.size());
-      values.push_back(value);
+      values.push_back(arg.substr(prefix.size()));
     }
   }
   return values;
 }
 
+// The information about a Rust target needed for its crate, computed once per
+// target.
+struct RustTargetInfo {
+  TargetsVector rust_deps;
+  std::vector<std::string> compiler_args;
+  std::optional<std::string> compiler_target;
+  std::string edition;
+  ConfigList cfgs;
+  std::optional<OutputFile> gen_dir;
+  std::optional<OutputFile> proc_macro_dynamic_library;
+  std::vector<std::pair<std::string, std::string>> rustenv;
+};
+
+using TargetInfoMap =
+    std::unordered_map<const Target*, std::unique_ptr<RustTargetInfo>>;
+
+// Number of targets whose information is computed by one task.
+constexpr size_t kTargetsPerChunk = 32;
+
+// Fills the parts of |info| that only depend on |target|.
+void ComputeTargetInfo(const Target* target, RustTargetInfo* info) {
+  info->compiler_args = ExtractCompilerArgs(target);
+  info->compiler_target = FindArgValue("--target", info->compiler_args);
+
+  auto edition =
+      FindArgValueAfterPrefix(std::string("--edition="), info->compiler_args);
+  if (!edition.has_value()) {
+    edition = FindArgValue("--edition", info->compiler_args);
+  }
+  info->edition = edition.value_or("2015");
+
+  info->gen_dir = GetBuildDirForTargetAsOutputFile(target, BuildDirType::GEN);
+
+  info->cfgs =
+      FindAllArgValuesAfterPrefix(std::string("--cfg="), info->compiler_args);
+
+  // If it's a proc macro, record its output location so IDEs can invoke it.
+  auto rust_tool =
+      target->toolchain()->GetToolForTargetFinalOutputAsRust(target);
+  if (std::string_view(rust_tool->name()) ==
+      std::string_view(RustTool::kRsToolMacro)) {
+    const auto& outputs = target->computed_outputs();
+    if (outputs.size() > 0) {
+      info->proc_macro_dynamic_library = outputs[0];
+    }
+  }
+
+  // Note any environment variables. These may be used by proc macros
+  // invoked by the current crate (so we want to record these for all crates,
+  // not just proc macro crates)
+  for (const auto& env_var : target->config_values().rustenv()) {
+    std::vector<std::string> parts = base::SplitString(
+        env_var, "=", base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
+    if (parts.size() >= 2) {
+      info->rustenv.emplace_back(std::move(parts[0]), std::move(parts[1]));
+    }
+  }
+}
+
+// Collects the information of |roots| and of their transitive Rust deps. The
+// deps are found first, then the rest of the information is computed in
+// parallel since it is independent for each target.
+TargetInfoMap CollectTargetInfo(const std::vector<const Target*>& roots) {
+  TargetInfoMap infos;
+  std::vector<std::pair<const Target*, RustTargetInfo*>> pending;
+  GroupRustDepsMap group_deps;
+  std::vector<const Target*> stack(roots.rbegin(), roots.rend());
+  while (!stack.empty()) {
+    const Target* target = stack.back();
+    stack.pop_back();
+    auto& info = infos[target];
+    if (info)
+      continue;
+    info = std::make_unique<RustTargetInfo>();
+    GetRustDeps(target, &group_deps, &info->rust_deps);
+    for (const Target* dep : info->rust_deps)
+      stack.push_back(dep);
+    pending.emplace_back(target, info.get());
+  }
+
+  size_t chunk_count =
+      (pending.size() + kTargetsPerChunk - 1) / kTargetsPerChunk;
+  WorkerPool::GetShared().ParallelFor(chunk_count, [&pending](size_t chunk) {
+    size_t begin = chunk * kTargetsPerChunk;
+    size_t end = std::min(begin + kTargetsPerChunk, pending.size());
+    for (size_t i = begin; i < end; i++)
+      ComputeTargetInfo(pending[i].first, pending[i].second);
+  });
+  return infos;
+}
+
 void AddTarget(const BuildSettings* build_settings,
                const Target* target,
+               TargetInfoMap& infos,
                TargetIndexMap& lookup,
                CrateList& crate_list) {
   if (lookup.find(target) != lookup.end()) {
@@ -171,13 +313,11 @@ void AddTarget(const BuildSettings* build_settings,
     return;
   }
 
-  auto compiler_args = ExtractCompilerArgs(target);
-  auto compiler_target = FindArgValue("--target", compiler_args);
-  auto crate_deps = GetRustDeps(target);
+  RustTargetInfo& info = *infos[target];
 
   // Add all dependencies of this crate, before this crate.
-  for (const auto& dep : crate_deps) {
-    AddTarget(build_settings, dep, lookup, crate_list);
+  for (const auto& dep : info.rust_deps) {
+    AddTarget(build_settings, dep, infos, lookup, crate_list);
   }
 
   // The index of a crate is its position (0-based) in the list of crates.
@@ -189,60 +329,34 @@ void AddTarget(const BuildSettings* build_settings,
   SourceFile crate_root = target->rust_values().crate_root();
   std::string crate_label = target->label().GetUserVisibleName(false);
 
-  auto edition =
-      FindArgValueAfterPrefix(std::string("--edition="), compiler_args);
-  if (!edition.has_value()) {
-    edition = FindArgValue("--edition", compiler_args);
-  }
+  Crate crate = Crate(crate_root, std::move(info.gen_dir), crate_id,
+                      crate_label, std::move(info.edition));
 
-  auto gen_dir = GetBuildDirForTargetAsOutputFile(target, BuildDirType::GEN);
-
-  Crate crate = Crate(crate_root, gen_dir, crate_id, crate_label,
-                      edition.value_or("2015"));
-
-  crate.SetCompilerArgs(compiler_args);
-  if (compiler_target.has_value())
-    crate.SetCompilerTarget(compiler_target.value());
-
-  ConfigList cfgs =
-      FindAllArgValuesAfterPrefix(std::string("--cfg="), compiler_args);
+  if (info.compiler_target.has_value())
+    crate.SetCompilerTarget(std::move(info.compiler_target.value()));
+  crate.SetCompilerArgs(std::move(info.compiler_args));
 
   crate.AddConfigItem("test");
   crate.AddConfigItem("debug_assertions");
 
-  for (auto& cfg : cfgs) {
-    crate.AddConfigItem(cfg);
+  for (auto& cfg : info.cfgs) {
+    crate.AddConfigItem(std::move(cfg));
   }
 
-  // If it's a proc macro, record its output location so IDEs can invoke it.
-  auto rust_tool =
-      target->toolchain()->GetToolForTargetFinalOutputAsRust(target);
-  if (std::string_view(rust_tool->name()) ==
-      std::string_view(RustTool::kRsToolMacro)) {
-    auto outputs = target->computed_outputs();
-    if (outputs.size() > 0) {
-      crate.SetIsProcMacro(outputs[0]);
-    }
-  }
+  if (info.proc_macro_dynamic_library.has_value())
+    crate.SetIsProcMacro(info.proc_macro_dynamic_library.value());
 
-  // Note any environment variables. These may be used by proc macros
-  // invoked by the current crate (so we want to record these for all crates,
-  // not just proc macro crates)
-  for (const auto& env_var : target->config_values().rustenv()) {
-    std::vector<std::string> parts = base::SplitString(
-        env_var, "=", base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
-    if (parts.size() >= 2) {
-      crate.AddRustenv(parts[0], parts[1]);
-    }
+  for (auto& env : info.rustenv) {
+    crate.AddRustenv(std::move(env.first), std::move(env.second));
   }
 
   // Add the rest of the crate dependencies.
-  for (const auto& dep : crate_deps) {
+  for (const auto& dep : info.rust_deps) {
     auto idx = lookup[dep];
     crate.AddDependency(idx, dep->rust_values().crate_name());
   }
 
-  crate_list.push_back(crate);
+  crate_list.push_back(std::move(crate));
 }
 
 void WriteCrates(const BuildSettings* build_settings,
@@ -284,7 +398,7 @@ void WriteCrates(const BuildSettings* build_settings,
                  << FilePathToUTF8(
                         build_settings->GetFullPath(crate.root().GetDir()))
                  << "\"";
-    auto gen_dir = crate.gen_dir();
+    const auto& gen_dir = crate.gen_dir();
     if (gen_dir.has_value()) {
       auto gen_dir_path = FilePathToUTF8(
           build_settings->GetFullPath(gen_dir->AsSourceDir(build_settings)));
@@ -297,17 +411,17 @@ void WriteCrates(const BuildSettings* build_settings,
                  << "          \"exclude_dirs\": []" NEWLINE
                  << "      }," NEWLINE;
 
-    auto compiler_target = crate.CompilerTarget();
+    const auto& compiler_target = crate.CompilerTarget();
     if (compiler_target.has_value()) {
       rust_project << "      \"target\": \"" << compiler_target.value()
                    << "\"," NEWLINE;
     }
 
-    auto compiler_args = crate.CompilerArgs();
+    const auto& compiler_args = crate.CompilerArgs();
     if (!compiler_args.empty()) {
       rust_project << "      \"compiler_args\": [";
       bool first_arg = true;
-      for (auto& arg : crate.CompilerArgs()) {
+      for (const auto& arg : compiler_args) {
         if (!first_arg)
           rust_project << ", ";
         first_arg = false;
@@ -336,7 +450,7 @@ void WriteCrates(const BuildSettings* build_settings,
 
     rust_project << "      \"edition\": \"" << crate.edition() << "\"," NEWLINE;
 
-    auto proc_macro_target = crate.proc_macro_path();
+    const auto& proc_macro_target = crate.proc_macro_path();
     if (proc_macro_target.has_value()) {
       rust_project << "      \"is_proc_macro\": true," NEWLINE;
       auto so_location = FilePathToUTF8(build_settings->GetFullPath(
@@ -396,11 +510,15 @@ void RustProjectWriter::RenderJSON(const BuildSettings* build_settings,
   std::optional<std::string> rust_sysroot;
 
   // All the crates defined in the project.
+  std::vector<const Target*> rust_targets;
   for (const auto* target : all_targets) {
-    if (!target->IsBinary() || !target->source_types_used().RustSourceUsed())
-      continue;
+    if (target->IsBinary() && target->source_types_used().RustSourceUsed())
+      rust_targets.push_back(target);
+  }
+  TargetInfoMap infos = CollectTargetInfo(rust_targets);
 
-    AddTarget(build_settings, target, lookup, crate_list);
+  for (const auto* target : rust_targets) {
+    AddTarget(build_settings, target, infos, lookup, crate_list);
 
     // If a sysroot hasn't been found, see if we can find one using this target.
     if (!rust_sysroot.has_value()) {
@@ -5,11 +5,15 @@
 #ifndef TOOLS_GN_RUST_PROJECT_WRITER_H_
 #define TOOLS_GN_RUST_PROJECT_WRITER_H_
 
+#include <string>
+#include <vector>
+
 #include "gn/err.h"
 #include "gn/target.h"
 
 class Builder;
 class BuildSettings;
+class LabelPattern;
 
 // rust-project.json is an output format describing the rust build graph. It is
 // used by rust-analyzer (a LSP server), similar to compile-commands.json.
@@ -19,10 +23,15 @@ class RustProjectWriter {
  public:
   // Write Rust build graph into a json file located by parameter file_name.
   //
+  // If root_filters is not empty, it is a semicolon-separated list of label
+  // patterns and only the crates of the matching targets and of their
+  // transitive dependencies are written.
+  //
   // Parameter quiet is not used.
   static bool RunAndWriteFiles(const BuildSettings* build_setting,
                                const Builder& builder,
                                const std::string& file_name,
+                               const std::string& root_filters,
                                bool quiet,
                                Err* err);
   static void RenderJSON(const BuildSettings* build_settings,
@@ -30,6 +39,14 @@ class RustProjectWriter {
                          std::ostream& rust_project);
 
  private:
+  FRIEND_TEST_ALL_PREFIXES(RustProjectJSONWriter, FilterToRootsClosure);
+
+  // Returns the targets of |all_targets| matching |patterns| and their
+  // transitive linked dependencies, in the order of |all_targets|.
+  static std::vector<const Target*> FilterToRootsClosure(
+      const std::vector<const Target*>& all_targets,
+      const std::vector<LabelPattern>& patterns);
+
   // This function visits the deps graph of a target in a DFS fashion.
   static void VisitDeps(const Target* target, TargetSet* visited);
 };
@@ -12,6 +12,7 @@
 #include <string_view>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "base/containers/flat_map.h"
@@ -39,32 +40,38 @@ class Crate {
         CrateIndex index,
         std::string label,
         std::string edition)
-      : root_(root),
-        gen_dir_(gen_dir),
+      : root_(std::move(root)),
+        gen_dir_(std::move(gen_dir)),
         index_(index),
-        label_(label),
-        edition_(edition) {}
+        label_(std::move(label)),
+        edition_(std::move(edition)) {}
 
   ~Crate() = default;
 
   // Add a config item to the crate.
-  void AddConfigItem(std::string cfg_item) { configs_.push_back(cfg_item); }
+  void AddConfigItem(std::string cfg_item) {
+    configs_.push_back(std::move(cfg_item));
+  }
 
   // Add a key-value environment variable pair used when building this crate.
   void AddRustenv(std::string key, std::string value) {
-    rustenv_.emplace(key, value);
+    rustenv_.emplace(std::move(key), std::move(value));
   }
 
   // Add another crate as a dependency of this one.
   void AddDependency(CrateIndex index, std::string name) {
-    deps_.push_back(std::make_pair(index, name));
+    deps_.push_back(std::make_pair(index, std::move(name)));
   }
 
   // Set the compiler arguments used to invoke the compilation of this crate
-  void SetCompilerArgs(std::vector<std::string> args) { compiler_args_ = args; }
+  void SetCompilerArgs(std::vector<std::string> args) {
+    compiler_args_ = std::move(args);
+  }
 
   // Set the compiler target ("e.g. x86_64-linux-kernel")
-  void SetCompilerTarget(std::string target) { compiler_target_ = target; }
+  void SetCompilerTarget(std::string target) {
+    compiler_target_ = std::move(target);
+  }
 
   // Set that this is a proc macro with the path to the output .so/dylib/dll
   void SetIsProcMacro(OutputFile proc_macro_dynamic_library) {
@@ -6,6 +6,7 @@
 #include "base/files/file_path.h"
 #include "base/strings/string_util.h"
 #include "gn/filesystem_utils.h"
+#include "gn/label_pattern.h"
 #include "gn/substitution_list.h"
 #include "gn/target.h"
 #include "gn/test_with_scheduler.h"
@@ -653,3 +654,57 @@ TEST_F(RustProjectJSONWriter, OneRustProcMacroTarget) {
 
   ExpectEqOrShowDiff(expected_json, out);
 }
+
+TEST_F(RustProjectJSONWriter, FilterToRootsClosure) {
+  Err err;
+  TestWithScope setup;
+
+  auto make_rust_library = [&setup](Target* target, const char* lib) {
+    target->set_output_type(Target::RUST_LIBRARY);
+    target->visibility().SetPublic();
+    SourceFile root(lib);
+    target->sources().push_back(root);
+    target->source_types_used().Set(SourceFile::SOURCE_RS);
+    target->rust_values().set_crate_root(root);
+    target->rust_values().crate_name() = target->label().name();
+    target->SetToolchain(setup.toolchain());
+  };
+
+  Target a(setup.settings(), Label(SourceDir("//a/"), "a"));
+  make_rust_library(&a, "//a/lib.rs");
+  ASSERT_TRUE(a.OnResolved(&err));
+
+  Target b(setup.settings(), Label(SourceDir("//b/"), "b"));
+  make_rust_library(&b, "//b/lib.rs");
+  b.private_deps().push_back(LabelTargetPair(&a));
+  ASSERT_TRUE(b.OnResolved(&err));
+
+  Target group(setup.settings(), Label(SourceDir("//g/"), "g"));
+  group.set_output_type(Target::GROUP);
+  group.visibility().SetPublic();
+  group.public_deps().push_back(LabelTargetPair(&b));
+  group.SetToolchain(setup.toolchain());
+  ASSERT_TRUE(group.OnResolved(&err));
+
+  Target c(setup.settings(), Label(SourceDir("//c/"), "c"));
+  make_rust_library(&c, "//c/lib.rs");
+  ASSERT_TRUE(c.OnResolved(&err));
+
+  std::vector<const Target*> all_targets = {&c, &group, &b, &a};
+  std::vector<LabelPattern> patterns = {
+      LabelPattern(LabelPattern::MATCH, SourceDir("//g/"), "g", Label())};
+
+  // The roots and their transitive dependencies are kept, in their original
+  // order.
+  std::vector<const Target*> filtered =
+      RustProjectWriter::FilterToRootsClosure(all_targets, patterns);
+  std::vector<const Target*> expected = {&group, &b, &a};
+  EXPECT_EQ(expected, filtered);
+
+  std::ostringstream stream;
+  RustProjectWriter::RenderJSON(setup.build_settings(), filtered, stream);
+  std::string out = stream.str();
+  EXPECT_NE(std::string::npos, out.find("\"label\": \"//a:a\""));
+  EXPECT_NE(std::string::npos, out.find("\"label\": \"//b:b\""));
+  EXPECT_EQ(std::string::npos, out.find("\"label\": \"//c:c\""));
+}
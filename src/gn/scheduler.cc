@@ -58,13 +58,16 @@ void Scheduler::FailWithError(const Err& err) {
 void Scheduler::ScheduleWork(std::function<void()> work) {
   IncrementWorkCount();
   pool_work_count_.Increment();
-  worker_pool_.PostTask([this, work = std::move(work)]() {
+  // The pool outlives the scheduler, so once the count is decremented, the
+  // task must not touch the scheduler after releasing the lock, which is
+  // when WaitForPoolTasks() may return. This includes destroying |work|.
+  WorkerPool::GetShared().PostTask([this, work = std::move(work)]() mutable {
     work();
+    work = nullptr;
     DecrementWorkCount();
-    if (!pool_work_count_.Decrement()) {
-      std::unique_lock<std::mutex> auto_lock(pool_work_count_lock_);
+    std::unique_lock<std::mutex> auto_lock(pool_work_count_lock_);
+    if (!pool_work_count_.Decrement())
       pool_work_count_cv_.notify_one();
-    }
   });
 }
 
@@ -12,6 +12,7 @@
 
 #include "base/atomic_ref_count.h"
 #include "base/files/file_path.h"
+#include "gn/exec_script_runner.h"
 #include "gn/input_file_manager.h"
 #include "gn/label.h"
 #include "gn/source_file.h"
@@ -36,6 +37,8 @@ class Scheduler {
 
   InputFileManager* input_file_manager() { return input_file_manager_.get(); }
 
+  ExecScriptRunner* exec_script_runner() { return &exec_script_runner_; }
+
   bool verbose_logging() const { return verbose_logging_; }
   void set_verbose_logging(bool v) { verbose_logging_ = v; }
 
@@ -114,6 +117,8 @@ class Scheduler {
 
   scoped_refptr<InputFileManager> input_file_manager_;
 
+  ExecScriptRunner exec_script_runner_;
+
   bool verbose_logging_ = false;
 
   base::AtomicRefCount work_count_;
@@ -128,8 +133,6 @@ class Scheduler {
   // Condition variable signaled when |pool_work_count_| reaches zero.
   std::condition_variable pool_work_count_cv_;
 
-  WorkerPool worker_pool_;
-
   mutable std::mutex lock_;
   bool is_failed_ = false;
 
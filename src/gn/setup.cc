@@ -208,6 +208,14 @@ Variables
       rules instead of stamp files whenever possible. This results in smaller
       Ninja build plans, but requires at least Ninja 1.11.
 
+  shared_ninja_flags [optional]
+      A boolean flag that can be set to write each distinct set of compiler
+      flags (defines, include_dirs, cflags, etc.) once per toolchain, as a
+      variable in a flags.ninja file next to the toolchain.ninja file. The
+      .ninja files of the targets then refer to these variables instead of
+      repeating the flags, which makes them much smaller when many targets
+      share the same configs. The resulting commands are the same.
+
 Example .gn file contents
 
   buildconfig = "//build/config/BUILDCONFIG.gn"
@@ -247,13 +255,14 @@ base::FilePath FindDotFile(const base::FilePath& current_dir) {
   return FindDotFile(up_one_dir);
 }
 
-// Called on any thread. Post the item to the builder on the main thread.
-void ItemDefinedCallback(MsgLoop* task_runner,
-                         Builder* builder_call_on_main_thread_only,
-                         std::unique_ptr<Item> item) {
-  DCHECK(item);
+// Called on any thread. Post the items to the builder on the main thread, as
+// a single task for all the items of a file.
+void ItemsDefinedCallback(MsgLoop* task_runner,
+                          Builder* builder_call_on_main_thread_only,
+                          std::vector<std::unique_ptr<Item>> items) {
+  DCHECK(!items.empty());
 
-  // Increment the work count for the duration of defining the item with the
+  // Increment the work count for the duration of defining the items with the
   // builder. Otherwise finishing this callback will race finishing loading
   // files. If there is no other pending work at any point in the middle of
   // this call completing on the main thread, the 'Complete' function will
@@ -262,10 +271,12 @@ void ItemDefinedCallback(MsgLoop* task_runner,
 
   // Work around issue binding a unique_ptr with std::function by moving into a
   // shared_ptr.
-  auto item_shared = std::make_shared<std::unique_ptr<Item>>(std::move(item));
+  auto items_shared =
+      std::make_shared<std::vector<std::unique_ptr<Item>>>(std::move(items));
   task_runner->PostTask(
-      [builder_call_on_main_thread_only, item_shared]() mutable {
-        builder_call_on_main_thread_only->ItemDefined(std::move(*item_shared));
+      [builder_call_on_main_thread_only, items_shared]() mutable {
+        builder_call_on_main_thread_only->ItemsDefined(
+            std::move(*items_shared));
         g_scheduler->DecrementWorkCount();
       });
 }
@@ -397,10 +408,10 @@ Setup::Setup()
       dotfile_scope_(&dotfile_settings_) {
   dotfile_settings_.set_toolchain_label(Label());
 
-  build_settings_.set_item_defined_callback(
+  build_settings_.set_items_defined_callback(
       [task_runner = scheduler_.task_runner(),
-       builder = &builder_](std::unique_ptr<Item> item) {
-        ItemDefinedCallback(task_runner, builder, std::move(item));
+       builder = &builder_](std::vector<std::unique_ptr<Item>> items) {
+        ItemsDefinedCallback(task_runner, builder, std::move(items));
       });
 
   loader_->set_complete_callback(&DecrementWorkCount);
@@ -476,7 +487,7 @@ bool Setup::Run() {
 }
 
 bool Setup::Run(const base::CommandLine& cmdline) {
-  RunPreMessageLoop();
+  RunPreMessageLoop(cmdline);
   if (!scheduler_.Run())
     return false;
   return RunPostMessageLoop(cmdline);
@@ -486,7 +497,26 @@ SourceFile Setup::GetBuildArgFile() const {
   return SourceFile(build_settings_.build_dir().value() + kBuildArgFileName);
 }
 
-void Setup::RunPreMessageLoop() {
+const TargetGraph& Setup::GetTargetGraph() {
+  if (!target_graph_) {
+    target_graph_ =
+        std::make_unique<TargetGraph>(builder_.GetAllResolvedTargets());
+  }
+  return *target_graph_;
+}
+
+base::FilePath Setup::GetExecScriptRecordFile() const {
+  return build_settings_.GetFullPath(
+      SourceFile(build_settings_.build_dir().value() +
+                 ExecScriptRunner::kRecordFileName));
+}
+
+void Setup::RunPreMessageLoop(const base::CommandLine& cmdline) {
+  // Start the scripts run by the previous run so that they overlap with the
+  // load instead of blocking the file running them.
+  if (cmdline.HasSwitch(switches::kPrefetchExecScript))
+    scheduler_.exec_script_runner()->Prefetch(GetExecScriptRecordFile());
+
   // Will be decremented with the loader is drained.
   g_scheduler->IncrementWorkCount();
 
@@ -532,6 +562,9 @@ bool Setup::RunPostMessageLoop(const base::CommandLine& cmdline) {
     }
   }
 
+  if (cmdline.HasSwitch(switches::kPrefetchExecScript))
+    scheduler_.exec_script_runner()->SaveRecord(GetExecScriptRecordFile());
+
   // Write out tracing and timing if requested.
   if (cmdline.HasSwitch(switches::kTime))
     PrintLongHelp(SummarizeTraces());
@@ -1141,6 +1174,17 @@ bool Setup::FillOtherConfig(const base::CommandLine& cmdline, Err* err) {
     build_settings_.set_no_stamp_files(no_stamp_files_value->boolean_value());
   }
 
+  // Shared Ninja flags.
+  const Value* shared_ninja_flags_value =
+      dotfile_scope_.GetValue("shared_ninja_flags", true);
+  if (shared_ninja_flags_value) {
+    if (!shared_ninja_flags_value->VerifyTypeIs(Value::BOOLEAN, err)) {
+      return false;
+    }
+    build_settings_.set_shared_ninja_flags(
+        shared_ninja_flags_value->boolean_value());
+  }
+
   // Export compile commands.
   const Value* export_cc_value =
       dotfile_scope_.GetValue("export_compile_commands", true);
@@ -16,6 +16,7 @@
 #include "gn/scheduler.h"
 #include "gn/scope.h"
 #include "gn/settings.h"
+#include "gn/target_graph.h"
 #include "gn/token.h"
 #include "gn/toolchain.h"
 
@@ -123,6 +124,11 @@ class Setup {
   Builder& builder() { return builder_; }
   LoaderImpl* loader() { return loader_.get(); }
 
+  // Returns the dependency graph of the resolved targets. It is built the
+  // first time it's requested and then shared by the callers, so it must only
+  // be requested once the load completed.
+  const TargetGraph& GetTargetGraph();
+
   const SourceFile& GetDotFile() const { return dotfile_input_file_->name(); }
 
   // Name of the file in the root build directory that contains the build
@@ -132,9 +138,13 @@ class Setup {
  private:
   // Performs the two sets of operations to run the generation before and after
   // the message loop is run.
-  void RunPreMessageLoop();
+  void RunPreMessageLoop(const base::CommandLine& cmdline);
   bool RunPostMessageLoop(const base::CommandLine& cmdline);
 
+  // Returns the file recording the exec_script() calls for
+  // --prefetch-exec-script.
+  base::FilePath GetExecScriptRecordFile() const;
+
   // Fills build arguments. Returns true on success.
   bool FillArguments(const base::CommandLine& cmdline, Err* err);
 
@@ -172,6 +182,7 @@ class Setup {
   BuildSettings build_settings_;
   scoped_refptr<LoaderImpl> loader_;
   Builder builder_;
+  std::unique_ptr<TargetGraph> target_graph_;
 
   SourceFile root_build_file_;
 
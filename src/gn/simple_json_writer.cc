@@ -0,0 +1,136 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/simple_json_writer.h"
+
+#include "base/json/string_escape.h"
+#include "base/logging.h"
+#include "gn/string_output_buffer.h"
+#include "util/build_config.h"
+
+// NOTE: Intentional macro definition allows compile-time string concatenation.
+// (see usage below).
+#if defined(OS_WINDOWS)
+#define LINE_ENDING "\r\n"
+#else
+#define LINE_ENDING "\n"
+#endif
+
+SimpleJSONWriter::SimpleJSONWriter(StringOutputBuffer& out) : out_(out) {
+  out_ << "{" LINE_ENDING;
+  SetIndentation(1u);
+}
+
+SimpleJSONWriter::~SimpleJSONWriter() {
+  Close();
+}
+
+void SimpleJSONWriter::Close() {
+  if (indentation_ > 0) {
+    DCHECK(indentation_ == 1u);
+    if (comma_.size())
+      out_ << LINE_ENDING;
+
+    out_ << "}" LINE_ENDING;
+    SetIndentation(0);
+  }
+}
+
+void SimpleJSONWriter::AddString(std::string_view key, std::string_view value) {
+  if (comma_.size()) {
+    out_ << comma_;
+  }
+  AddMargin() << Escape(key) << ": " << Escape(value);
+  comma_ = "," LINE_ENDING;
+}
+
+void SimpleJSONWriter::BeginList(std::string_view key) {
+  if (comma_.size())
+    out_ << comma_;
+  AddMargin() << Escape(key) << ": [ ";
+  comma_ = {};
+}
+
+void SimpleJSONWriter::AddListItem(std::string_view item) {
+  if (comma_.size())
+    out_ << comma_;
+  out_ << Escape(item);
+  comma_ = ", ";
+}
+
+void SimpleJSONWriter::EndList() {
+  out_ << " ]";
+  comma_ = "," LINE_ENDING;
+}
+
+void SimpleJSONWriter::BeginDict(std::string_view key) {
+  if (comma_.size())
+    out_ << comma_;
+
+  AddMargin() << Escape(key) << ": {";
+  SetIndentation(indentation_ + 1);
+  comma_ = LINE_ENDING;
+}
+
+void SimpleJSONWriter::EndDict() {
+  if (comma_.size())
+    out_ << LINE_ENDING;
+
+  SetIndentation(indentation_ - 1);
+  AddMargin() << "}";
+  comma_ = "," LINE_ENDING;
+}
+
+void SimpleJSONWriter::AddJSONDict(std::string_view key,
+                                   std::string_view json) {
+  if (comma_.size())
+    out_ << comma_;
+  AddMargin() << Escape(key) << ": ";
+  if (json.empty()) {
+    out_ << "{ }";
+  } else {
+    DCHECK(json[0] == '{');
+    bool first_line = true;
+    do {
+      size_t line_end = json.find('\n');
+
+      // NOTE: Do not add margin if original input line is empty.
+      // This needs to deal with CR/LF which are part of |json| on Windows
+      // only, due to the way base::JSONWriter::Write() is implemented.
+      bool line_empty = (line_end == 0 || (line_end == 1 && json[0] == '\r'));
+      if (!first_line && !line_empty)
+        AddMargin();
+
+      if (line_end == std::string_view::npos) {
+        out_ << json;
+        comma_ = {};
+        return;
+      }
+      // Important: do not add the final newline.
+      out_ << json.substr(
+          0, (line_end == json.size() - 1) ? line_end : line_end + 1);
+      json.remove_prefix(line_end + 1);
+      first_line = false;
+    } while (!json.empty());
+  }
+  comma_ = "," LINE_ENDING;
+}
+
+// static
+std::string SimpleJSONWriter::Escape(std::string_view str) {
+  std::string result;
+  base::EscapeJSONString(str, true, &result);
+  return result;
+}
+
+StringOutputBuffer& SimpleJSONWriter::AddMargin() const {
+  static const char kMargin[17] = "                ";
+  size_t margin_len = indentation_ * 3;
+  while (margin_len > 0) {
+    size_t span = (margin_len > 16u) ? 16u : margin_len;
+    out_.Append(kMargin, span);
+    margin_len -= span;
+  }
+  return out_;
+}
@@ -0,0 +1,93 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_SIMPLE_JSON_WRITER_H_
+#define TOOLS_GN_SIMPLE_JSON_WRITER_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <string_view>
+
+class StringOutputBuffer;
+
+// Helper class to output a, potentially very large, JSON file to a
+// StringOutputBuffer. Note that sorting the keys, if desired, is left to
+// the user (unlike base::JSONWriter). This allows rendering to be performed
+// in series of incremental steps. Usage is:
+//
+//   1) Create instance, passing a StringOutputBuffer reference as the
+//      destination.
+//
+//   2) Add keys and values using one of the following:
+//
+//       a) AddString(key, string_value) to add one string value.
+//
+//       b) BeginList(key), AddListItem(), EndList() to add a string list.
+//          NOTE: Only lists of strings are supported here.
+//
+//       c) BeginDict(key), ... add other keys, followed by EndDict() to add
+//          a dictionary key.
+//
+//       d) AddJSONDict(key, json) to add a dictionary formatted by
+//          base::JSONWriter.
+//
+//   3) Call Close() or destroy the instance to finalize the output.
+//
+// The output is formatted like the one of base::JSONWriter with the
+// OPTIONS_PRETTY_PRINT option, so a dictionary whose values are written one
+// by one with AddJSONDict() is identical to the whole dictionary written by
+// base::JSONWriter, without having to build it in memory.
+class SimpleJSONWriter {
+ public:
+  explicit SimpleJSONWriter(StringOutputBuffer& out);
+  ~SimpleJSONWriter();
+
+  // Closing finalizes the output.
+  void Close();
+
+  // Add new string-valued key.
+  void AddString(std::string_view key, std::string_view value);
+
+  // Begin a new list. Must be followed by zero or more AddListItem() calls,
+  // then by EndList().
+  void BeginList(std::string_view key);
+
+  // Add a new list item. For now only string values are supported.
+  void AddListItem(std::string_view item);
+
+  // End current list.
+  void EndList();
+
+  // Begin new dictionary. Must be followed by zero or more other key
+  // additions, then a call to EndDict().
+  void BeginDict(std::string_view key);
+
+  // End current dictionary.
+  void EndDict();
+
+  // Add a dictionary-valued key, whose value is already formatted as a valid
+  // JSON string. Useful to insert the output of base::JSONWriter::Write()
+  // into the target buffer.
+  void AddJSONDict(std::string_view key, std::string_view json);
+
+ private:
+  // Return the JSON-escape version of |str|.
+  static std::string Escape(std::string_view str);
+
+  // Adjust indentation level.
+  void SetIndentation(size_t indentation) { indentation_ = indentation; }
+
+  // Append margin, and return reference to output buffer.
+  StringOutputBuffer& AddMargin() const;
+
+  size_t indentation_ = 0;
+  std::string_view comma_;
+  StringOutputBuffer& out_;
+
+  SimpleJSONWriter(const SimpleJSONWriter&) = delete;
+  SimpleJSONWriter& operator=(const SimpleJSONWriter&) = delete;
+};
+
+#endif  // TOOLS_GN_SIMPLE_JSON_WRITER_H_
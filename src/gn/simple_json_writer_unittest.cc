@@ -0,0 +1,78 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/simple_json_writer.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/json/json_writer.h"
+#include "base/values.h"
+#include "gn/string_output_buffer.h"
+#include "util/test/test.h"
+
+namespace {
+
+std::string ToJSON(const base::Value& value) {
+  std::string json;
+  base::JSONWriter::WriteWithOptions(
+      value, base::JSONWriter::OPTIONS_PRETTY_PRINT, &json);
+  return json;
+}
+
+std::unique_ptr<base::DictionaryValue> MakeDict(const std::string& name) {
+  auto dict = std::make_unique<base::DictionaryValue>();
+  dict->SetKey("name", base::Value(name));
+  base::ListValue list;
+  list.GetList().push_back(base::Value("a"));
+  list.GetList().push_back(base::Value("b \"c\""));
+  dict->SetKey("list", std::move(list));
+  auto nested = std::make_unique<base::DictionaryValue>();
+  nested->SetKey("empty", base::DictionaryValue());
+  nested->SetKey("value", base::Value(true));
+  dict->SetWithoutPathExpansion("nested", std::move(nested));
+  return dict;
+}
+
+}  // namespace
+
+TEST(SimpleJSONWriter, SameAsJSONWriter) {
+  const char* const kNames[] = {"//a:a", "//b:b(//tc:tc)", "//c:\"quoted\""};
+
+  base::DictionaryValue all;
+  StringOutputBuffer out;
+  {
+    SimpleJSONWriter writer(out);
+    for (const char* name : kNames) {
+      all.SetWithoutPathExpansion(name, MakeDict(name));
+      writer.AddJSONDict(name, ToJSON(*MakeDict(name)));
+    }
+  }
+  EXPECT_EQ(ToJSON(all), out.str());
+}
+
+TEST(SimpleJSONWriter, Values) {
+  StringOutputBuffer out;
+  {
+    SimpleJSONWriter writer(out);
+    writer.AddString("a", "b");
+    writer.BeginList("list");
+    writer.AddListItem("x");
+    writer.AddListItem("y");
+    writer.EndList();
+    writer.BeginDict("dict");
+    writer.AddString("c", "d");
+    writer.EndDict();
+  }
+  EXPECT_EQ(
+      "{\n"
+      "   \"a\": \"b\",\n"
+      "   \"list\": [ \"x\", \"y\" ],\n"
+      "   \"dict\": {\n"
+      "      \"c\": \"d\"\n"
+      "   }\n"
+      "}\n",
+      out.str());
+}
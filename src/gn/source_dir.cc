@@ -5,6 +5,7 @@
 #include "gn/source_dir.h"
 
 #include <string>
+#include <unordered_map>
 
 #include "base/logging.h"
 #include "gn/filesystem_utils.h"
@@ -70,6 +71,56 @@ static StringAtom SourceDirStringAtom(std::string_view s) {
   return StringAtom(str);
 }
 
+// Caches the files resolved by ResolveRelativeFile() for inputs that need
+// normalization, like "../foo/bar.cc". Resolving those goes through the
+// absolute path of the directory, which is much more expensive than a lookup.
+// Inputs that don't need normalization take a fast path in ResolveRelative()
+// and aren't cached.
+//
+// The result only depends on the concatenation of the directory and the
+// input, and on the source root. Each thread has its own cache.
+class ResolvedFileCache {
+ public:
+  // Returns the cached file for |dir| + |input|, or null.
+  const SourceFile* Find(const std::string& dir,
+                         std::string_view input,
+                         std::string_view source_root) {
+    if (source_root != source_root_) {
+      // Only tests use different source roots in the same process.
+      files_.clear();
+      source_root_.assign(source_root);
+    }
+    key_.assign(dir);
+    key_.append(input);
+    auto found = files_.find(key_);
+    return found == files_.end() ? nullptr : &found->second;
+  }
+
+  // Adds a file for the key of the last call to Find().
+  void Add(const SourceFile& file) {
+    if (files_.size() >= kMaxEntries)
+      files_.clear();
+    files_.emplace(key_, file);
+  }
+
+ private:
+  static constexpr size_t kMaxEntries = 1 << 16;
+
+  std::string source_root_;
+  std::string key_;
+  std::unordered_map<std::string, SourceFile> files_;
+};
+
+#if !defined(OS_ZOS)
+thread_local ResolvedFileCache s_resolved_file_cache;
+#endif
+
+// Returns true if |input| is a relative path that needs normalization.
+bool NeedsNormalization(std::string_view input) {
+  return !IsPathAbsolute(input) && !IsPathSourceAbsolute(input) &&
+         !IsPathNormalizedRelative(input);
+}
+
 }  // namespace
 
 SourceDir::SourceDir(std::string_view s) : value_(SourceDirStringAtom(s)) {}
@@ -97,6 +148,18 @@ SourceFile SourceDir::ResolveRelativeFile(const Value& p,
   if (!ValidateResolveInput(true, p, input_string, err))
     return ret;
 
+#if !defined(OS_ZOS)
+  if (NeedsNormalization(input_string)) {
+    if (const SourceFile* cached = s_resolved_file_cache.Find(
+            value_.str(), input_string, source_root))
+      return *cached;
+    ret.SetValue(
+        ResolveRelative(input_string, value_.str(), true, source_root));
+    s_resolved_file_cache.Add(ret);
+    return ret;
+  }
+#endif
+
   ret.SetValue(ResolveRelative(input_string, value_.str(), true, source_root));
   return ret;
 }
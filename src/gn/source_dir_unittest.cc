@@ -112,6 +112,40 @@ TEST(SourceDir, ResolveRelativeFile) {
 #endif
 }
 
+// ResolveRelativeFile() caches the files that needed normalization. Checks
+// that the same inputs resolve correctly from other directories and source
+// roots.
+TEST(SourceDir, ResolveRelativeFileRepeated) {
+  Err err;
+  SourceDir a("//a/b/");
+  SourceDir c("//c/");
+  for (int round = 0; round < 2; round++) {
+    EXPECT_EQ("//a/foo.cc", a.ResolveRelativeFile(Value(nullptr, "../foo.cc"),
+                                                  &err, std::string_view())
+                                .value());
+    EXPECT_EQ("//foo.cc", c.ResolveRelativeFile(Value(nullptr, "../foo.cc"),
+                                                &err, std::string_view())
+                              .value());
+#if !defined(OS_WIN)
+    EXPECT_EQ("//a/foo.cc", a.ResolveRelativeFile(Value(nullptr, "../foo.cc"),
+                                                  &err, "/source/root")
+                                .value());
+    EXPECT_EQ("/source/foo.cc",
+              c.ResolveRelativeFile(Value(nullptr, "../../foo.cc"), &err,
+                                    "/source/root")
+                  .value());
+    EXPECT_EQ("/other/foo.cc",
+              c.ResolveRelativeFile(Value(nullptr, "../../foo.cc"), &err,
+                                    "/other/root")
+                  .value());
+#endif
+    EXPECT_EQ("//c/d/foo.cc", c.ResolveRelativeFile(Value(nullptr, "d/foo.cc"),
+                                                    &err, "/other/root")
+                                  .value());
+    EXPECT_FALSE(err.has_error());
+  }
+}
+
 TEST(SourceDir, ResolveRelativeDir) {
   Err err;
   SourceDir base("//base/");
@@ -0,0 +1,128 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/streaming_file_writer.h"
+
+#include <algorithm>
+
+#include "base/files/file_util.h"
+#include "gn/err.h"
+#include "gn/filesystem_utils.h"
+
+StreamingFileWriter::StreamingFileWriter(const base::FilePath& file_path)
+    : file_path_(file_path),
+      temp_path_(file_path.AddExtension(FILE_PATH_LITERAL("tmp"))) {}
+
+StreamingFileWriter::~StreamingFileWriter() {
+  if (created_ && writing_) {
+    writer_.Close();
+    base::DeleteFile(temp_path_, false);
+  }
+}
+
+bool StreamingFileWriter::Create(Err* err) {
+  if (!base::CreateDirectory(file_path_.DirName())) {
+    *err = Err(Location(), "Unable to create directory.",
+               "I was using \"" + FilePathToUTF8(file_path_.DirName()) + "\".");
+    return false;
+  }
+  created_ = true;
+
+  // Compare with the existing output, if there is one.
+  existing_.Initialize(file_path_,
+                       base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (existing_.IsValid())
+    return true;
+
+  if (!writer_.Create(temp_path_)) {
+    created_ = false;
+    *err = Err(Location(), "Unable to create file.",
+               "I was writing \"" + FilePathToUTF8(temp_path_) + "\".");
+    return false;
+  }
+  writing_ = true;
+  return true;
+}
+
+void StreamingFileWriter::Write(std::string_view data) {
+  DCHECK(created_);
+  hasher_.Update(data);
+  size_ += data.size();
+
+  if (!writing_) {
+    compare_buffer_.resize(data.size());
+    int read = existing_.ReadAtCurrentPos(compare_buffer_.data(),
+                                          static_cast<int>(data.size()));
+    if (read == static_cast<int>(data.size()) && compare_buffer_ == data) {
+      compared_size_ += read;
+      return;
+    }
+    StartWriting();
+  }
+
+  if (!writer_.Write(data))
+    write_failed_ = true;
+}
+
+void StreamingFileWriter::StartWriting() {
+  DCHECK(!writing_);
+  writing_ = true;
+  if (!writer_.Create(temp_path_)) {
+    write_failed_ = true;
+  } else {
+    char buffer[65536];
+    for (int64_t offset = 0; offset < compared_size_;) {
+      int size = static_cast<int>(
+          std::min<int64_t>(sizeof(buffer), compared_size_ - offset));
+      if (existing_.Read(offset, buffer, size) != size ||
+          !writer_.Write(std::string_view(buffer, size))) {
+        write_failed_ = true;
+        break;
+      }
+      offset += size;
+    }
+  }
+  existing_.Close();
+  std::string().swap(compare_buffer_);
+}
+
+bool StreamingFileWriter::Commit(Err* err, bool* written) {
+  DCHECK(created_);
+  if (written)
+    *written = false;
+
+  created_ = false;
+
+  OutputManifest* manifest = g_output_manifest;
+  uint64_t hash = hasher_.Finish();
+  if (!writing_) {
+    // Unchanged if the output doesn't have more data either.
+    if (existing_.GetLength() == compared_size_) {
+      existing_.Close();
+      if (manifest && !manifest->IsUpToDate(file_path_, hash, size_))
+        manifest->Record(file_path_, hash, size_, false);
+      return true;
+    }
+    StartWriting();
+  }
+
+  if (!writer_.Close() || write_failed_) {
+    base::DeleteFile(temp_path_, false);
+    *err = Err(Location(), "Unable to write file.",
+               "I was writing \"" + FilePathToUTF8(temp_path_) + "\".");
+    return false;
+  }
+
+  if (!base::ReplaceFile(temp_path_, file_path_, nullptr)) {
+    base::DeleteFile(temp_path_, false);
+    *err = Err(Location(), "Unable to write file.",
+               "I was writing \"" + FilePathToUTF8(file_path_) + "\".");
+    return false;
+  }
+  if (written)
+    *written = true;
+  if (manifest)
+    manifest->Record(file_path_, hash, size_, true);
+  return true;
+}
@@ -0,0 +1,80 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_STREAMING_FILE_WRITER_H_
+#define TOOLS_GN_STREAMING_FILE_WRITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "gn/file_writer.h"
+#include "gn/output_manifest.h"
+
+class Err;
+
+// Writes an output file that is too large to be built in memory first, such
+// as a compilation database for a big build, piece by piece.
+//
+// It behaves like StringOutputBuffer::WriteToFileIfChanged(): the data is
+// written to a temporary file next to the output, which only replaces the
+// output on Commit() if the contents are different, so an unchanged output
+// keeps its timestamp. The g_output_manifest is updated the same way.
+//
+// The manifest can't tell whether the data is unchanged before all of it is
+// written, so the data is compared with the existing output as it comes
+// instead. The temporary file is only created at the first difference, with
+// the equal part copied from the output, and an unchanged output is only
+// read, never written.
+//
+// Usage is:
+//   1) Create instance and call Create().
+//   2) Call Write() one or more times.
+//   3) Call Commit(). Without it the output is left untouched.
+class StreamingFileWriter {
+ public:
+  explicit StreamingFileWriter(const base::FilePath& file_path);
+  ~StreamingFileWriter();
+
+  // Creates the temporary file. Returns false and sets the error on failure.
+  bool Create(Err* err);
+
+  // Appends |data|. Errors are reported by Commit().
+  void Write(std::string_view data);
+
+  // Moves the written data to the output unless it has the same contents.
+  // If |written| is not null, it is set to whether the output was changed.
+  bool Commit(Err* err, bool* written = nullptr);
+
+ private:
+  // Stops comparing and creates the temporary file with the data compared so
+  // far. Failures are reported by Commit().
+  void StartWriting();
+
+  base::FilePath file_path_;
+  base::FilePath temp_path_;
+
+  // The existing output while the data written so far is the same as its
+  // first |compared_size_| bytes.
+  base::File existing_;
+  int64_t compared_size_ = 0;
+  std::string compare_buffer_;
+
+  FileWriter writer_;
+  bool created_ = false;
+  bool writing_ = false;
+  bool write_failed_ = false;
+
+  ContentHasher hasher_;
+  size_t size_ = 0;
+
+  StreamingFileWriter(const StreamingFileWriter&) = delete;
+  StreamingFileWriter& operator=(const StreamingFileWriter&) = delete;
+};
+
+#endif  // TOOLS_GN_STREAMING_FILE_WRITER_H_
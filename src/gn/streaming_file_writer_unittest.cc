@@ -0,0 +1,114 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/streaming_file_writer.h"
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "gn/err.h"
+#include "util/test/test.h"
+
+namespace {
+
+bool WriteInPieces(const base::FilePath& file,
+                   std::string_view contents,
+                   bool* written) {
+  Err err;
+  StreamingFileWriter writer(file);
+  if (!writer.Create(&err))
+    return false;
+  while (!contents.empty()) {
+    std::string_view piece = contents.substr(0, 3);
+    writer.Write(piece);
+    contents.remove_prefix(piece.size());
+  }
+  return writer.Commit(&err, written);
+}
+
+}  // namespace
+
+TEST(StreamingFileWriter, WritesIfChanged) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath file = temp_dir.GetPath().AppendASCII("sub/foo.json");
+
+  bool written = false;
+  ASSERT_TRUE(WriteInPieces(file, "[ 1, 2, 3 ]\n", &written));
+  EXPECT_TRUE(written);
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(file, &contents));
+  EXPECT_EQ("[ 1, 2, 3 ]\n", contents);
+
+  // The same contents leave the file alone.
+  base::File::Info info;
+  ASSERT_TRUE(base::GetFileInfo(file, &info));
+  ASSERT_TRUE(WriteInPieces(file, "[ 1, 2, 3 ]\n", &written));
+  EXPECT_FALSE(written);
+  base::File::Info new_info;
+  ASSERT_TRUE(base::GetFileInfo(file, &new_info));
+  EXPECT_EQ(info.last_modified, new_info.last_modified);
+
+  ASSERT_TRUE(WriteInPieces(file, "[]\n", &written));
+  EXPECT_TRUE(written);
+  ASSERT_TRUE(base::ReadFileToString(file, &contents));
+  EXPECT_EQ("[]\n", contents);
+
+  // No temporary file is left behind.
+  EXPECT_FALSE(base::PathExists(file.AddExtension(FILE_PATH_LITERAL("tmp"))));
+}
+
+TEST(StreamingFileWriter, NoCommit) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath file = temp_dir.GetPath().AppendASCII("foo.json");
+  ASSERT_EQ(3, base::WriteFile(file, "old", 3));
+
+  {
+    Err err;
+    StreamingFileWriter writer(file);
+    ASSERT_TRUE(writer.Create(&err));
+    writer.Write("new");
+  }
+
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(file, &contents));
+  EXPECT_EQ("old", contents);
+  EXPECT_FALSE(base::PathExists(file.AddExtension(FILE_PATH_LITERAL("tmp"))));
+}
+
+TEST(StreamingFileWriter, ComparesBeforeWriting) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath file = temp_dir.GetPath().AppendASCII("foo.json");
+  base::FilePath temp_file = file.AddExtension(FILE_PATH_LITERAL("tmp"));
+  ASSERT_EQ(12, base::WriteFile(file, "[ 1, 2, 3 ]\n", 12));
+
+  // Nothing is written while the data is the same as the output.
+  {
+    Err err;
+    StreamingFileWriter writer(file);
+    ASSERT_TRUE(writer.Create(&err));
+    writer.Write("[ 1, ");
+    writer.Write("2, 3 ]\n");
+    EXPECT_FALSE(base::PathExists(temp_file));
+    bool written = true;
+    ASSERT_TRUE(writer.Commit(&err, &written));
+    EXPECT_FALSE(written);
+  }
+
+  // The part that was the same is kept when the data differs later on, is
+  // shorter or is longer.
+  const char* const kContents[] = {"[ 1, 4 ]\n", "[ 1, 4 ]\n[ 1, 4 ]\n",
+                                   "[ 1, 4 ]", "[ 1, 4 ]\n", ""};
+  for (const char* contents : kContents) {
+    bool written = false;
+    ASSERT_TRUE(WriteInPieces(file, contents, &written));
+    EXPECT_TRUE(written);
+    std::string result;
+    ASSERT_TRUE(base::ReadFileToString(file, &result));
+    EXPECT_EQ(contents, result);
+    EXPECT_FALSE(base::PathExists(temp_file));
+  }
+}
@@ -9,6 +9,7 @@
 #include "gn/err.h"
 #include "gn/file_writer.h"
 #include "gn/filesystem_utils.h"
+#include "gn/output_manifest.h"
 
 #include <fstream>
 
@@ -117,9 +118,47 @@ bool StringOutputBuffer::WriteToFile(const base::FilePath& file_path,
 }
 
 bool StringOutputBuffer::WriteToFileIfChanged(const base::FilePath& file_path,
-                                              Err* err) const {
-  if (ContentsEqual(file_path))
+                                              Err* err,
+                                              bool* written) const {
+  if (written)
+    *written = false;
+
+  OutputManifest* manifest = g_output_manifest;
+  if (!manifest) {
+    if (ContentsEqual(file_path))
+      return true;
+    if (written)
+      *written = true;
+    return WriteToFile(file_path, err);
+  }
+
+  // Hashing is much cheaper than reading the old file back, and when the
+  // manifest says the file on disk already has this content it can be skipped
+  // entirely. Otherwise the file may have been written by an older GN or
+  // touched by something else, so fall back to comparing the contents.
+  uint64_t hash = ContentHash();
+  if (manifest->IsUpToDate(file_path, hash, size()))
     return true;
 
-  return WriteToFile(file_path, err);
+  if (ContentsEqual(file_path)) {
+    manifest->Record(file_path, hash, size(), false);
+    return true;
+  }
+
+  if (written)
+    *written = true;
+  if (!WriteToFile(file_path, err))
+    return false;
+  manifest->Record(file_path, hash, size(), true);
+  return true;
+}
+
+uint64_t StringOutputBuffer::ContentHash() const {
+  ContentHasher hasher;
+  size_t data_size = size();
+  for (size_t nn = 0; nn < pages_.size(); ++nn) {
+    size_t wanted_size = std::min(kPageSize, data_size - nn * kPageSize);
+    hasher.Update(std::string_view(pages_[nn]->data(), wanted_size));
+  }
+  return hasher.Finish();
 }
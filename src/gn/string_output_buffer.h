@@ -5,6 +5,8 @@
 #ifndef TOOLS_GN_STRING_OUTPUT_BUFFER_H_
 #define TOOLS_GN_STRING_OUTPUT_BUFFER_H_
 
+#include <stdint.h>
+
 #include <array>
 #include <memory>
 #include <streambuf>
@@ -38,7 +40,8 @@ class Err;
 //   4) Use ContentsEqual() to compare the instance's content with that of a
 //      given file.
 //
-//   5) Use WriteToFile() to write the content to a given file.
+//   5) Use WriteToFile() to write the content to a given file, or
+//      WriteToFileIfChanged() to only write it when it is different.
 //
 class StringOutputBuffer : public std::streambuf {
  public:
@@ -67,8 +70,17 @@ class StringOutputBuffer : public std::streambuf {
   bool WriteToFile(const base::FilePath& file_path, Err* err) const;
 
   // Write the contents of this instance to a file at |file_path| unless the
-  // file already exists and the contents are equal.
-  bool WriteToFileIfChanged(const base::FilePath& file_path, Err* err) const;
+  // file already exists and the contents are equal. If |written| is not null,
+  // it is set to whether the file was written.
+  //
+  // When g_output_manifest is set, files that are known to be unchanged are
+  // skipped without reading them back, and every file is recorded in it.
+  bool WriteToFileIfChanged(const base::FilePath& file_path,
+                            Err* err,
+                            bool* written = nullptr) const;
+
+  // Returns the hash of the contents as computed by ContentHasher.
+  uint64_t ContentHash() const;
 
   static size_t GetPageSizeForTesting() { return kPageSize; }
 
@@ -4,6 +4,8 @@
 
 #include "gn/substitution_writer.h"
 
+#include <memory>
+
 #include "gn/build_settings.h"
 #include "gn/c_substitution_type.h"
 #include "gn/escape.h"
@@ -34,6 +36,20 @@ void SetDirOrDotWithNoSlash(const std::string& dir, std::string* dest) {
     dest->push_back('.');
 }
 
+// Returns an OUTPUT_ABSOLUTE plan for each pattern in the list.
+std::vector<std::unique_ptr<SourceSubstitutionPlan>> MakeAbsolutePlans(
+    const Target* target,
+    const Settings* settings,
+    const SubstitutionList& list) {
+  std::vector<std::unique_ptr<SourceSubstitutionPlan>> plans;
+  for (const auto& pattern : list.list()) {
+    plans.push_back(std::make_unique<SourceSubstitutionPlan>(
+        target, settings, pattern, SubstitutionWriter::OUTPUT_ABSOLUTE,
+        SourceDir()));
+  }
+  return plans;
+}
+
 }  // namespace
 
 const char kSourceExpansion_Help[] =
@@ -287,8 +303,12 @@ void SubstitutionWriter::ApplyListToSources(
     const std::vector<SourceFile>& sources,
     std::vector<SourceFile>* output) {
   output->clear();
-  for (const auto& source : sources)
-    ApplyListToSource(target, settings, list, source, output);
+  std::vector<std::unique_ptr<SourceSubstitutionPlan>> plans =
+      MakeAbsolutePlans(target, settings, list);
+  for (const auto& source : sources) {
+    for (const auto& plan : plans)
+      output->push_back(plan->GetSourceFileForSource(source));
+  }
 }
 
 // static
@@ -299,8 +319,14 @@ void SubstitutionWriter::ApplyListToSourcesAsString(
     const std::vector<SourceFile>& sources,
     std::vector<std::string>* output) {
   output->clear();
-  for (const auto& source : sources)
-    ApplyListToSourceAsString(target, settings, list, source, output);
+  std::vector<std::unique_ptr<SourceSubstitutionPlan>> plans =
+      MakeAbsolutePlans(target, settings, list);
+  for (const auto& source : sources) {
+    for (const auto& plan : plans) {
+      output->emplace_back();
+      plan->AppendForSource(source, &output->back());
+    }
+  }
 }
 
 // static
@@ -311,8 +337,12 @@ void SubstitutionWriter::ApplyListToSourcesAsOutputFile(
     const std::vector<SourceFile>& sources,
     std::vector<OutputFile>* output) {
   output->clear();
-  for (const auto& source : sources)
-    ApplyListToSourceAsOutputFile(target, settings, list, source, output);
+  std::vector<std::unique_ptr<SourceSubstitutionPlan>> plans =
+      MakeAbsolutePlans(target, settings, list);
+  for (const auto& source : sources) {
+    for (const auto& plan : plans)
+      output->push_back(plan->GetOutputFileForSource(source));
+  }
 }
 
 // static
@@ -585,3 +615,138 @@ std::string SubstitutionWriter::GetLinkerSubstitution(
     return std::string();
   }
 }
+
+SourceSubstitutionPlan::SourceSubstitutionPlan(
+    const Target* target,
+    const Settings* settings,
+    const SubstitutionPattern& pattern,
+    SubstitutionWriter::OutputStyle output_style,
+    const SourceDir& relative_to)
+    : target_(target),
+      settings_(settings),
+      pattern_(&pattern),
+      output_style_(output_style),
+      relative_to_(relative_to) {
+  for (const auto& range : pattern.ranges())
+    AddStep(range.type, range.literal);
+}
+
+SourceSubstitutionPlan::SourceSubstitutionPlan(
+    const Target* target,
+    const Settings* settings,
+    const Substitution* type,
+    SubstitutionWriter::OutputStyle output_style,
+    const SourceDir& relative_to)
+    : target_(target),
+      settings_(settings),
+      pattern_(nullptr),
+      output_style_(output_style),
+      relative_to_(relative_to) {
+  AddStep(type, std::string_view());
+}
+
+SourceSubstitutionPlan::~SourceSubstitutionPlan() = default;
+
+void SourceSubstitutionPlan::AddStep(const Substitution* type,
+                                     std::string_view literal) {
+  Step step;
+  step.type = type;
+  step.literal = literal;
+  steps_.push_back(step);
+
+  if (type == &SubstitutionSourceDir ||
+      type == &SubstitutionSourceRootRelativeDir ||
+      type == &SubstitutionSourceGenDir || type == &SubstitutionSourceOutDir)
+    has_dir_steps_ = true;
+}
+
+void SourceSubstitutionPlan::AppendForSource(const SourceFile& source,
+                                             std::string* dest) {
+  // The source is null when expanding patterns that only have literals.
+  const std::string& value = source.value();
+  size_t name_offset = value.rfind('/');
+  name_offset = name_offset == std::string::npos ? 0 : name_offset + 1;
+
+  if (has_dir_steps_) {
+    std::string_view dir(value.data(), name_offset);
+    if (!has_cached_dir_ || dir != cached_dir_) {
+      cached_dir_.assign(dir);
+      has_cached_dir_ = true;
+      for (Step& step : steps_) {
+        if (step.type == &SubstitutionSourceDir ||
+            step.type == &SubstitutionSourceRootRelativeDir ||
+            step.type == &SubstitutionSourceGenDir ||
+            step.type == &SubstitutionSourceOutDir) {
+          step.dir_value = SubstitutionWriter::GetSourceSubstitution(
+              target_, settings_, source, step.type, output_style_,
+              relative_to_);
+        }
+      }
+    }
+  }
+
+  const std::string& root_path = settings_->build_settings()->root_path_utf8();
+  for (const Step& step : steps_) {
+    if (step.type == &SubstitutionLiteral) {
+      dest->append(step.literal);
+    } else if (step.type == &SubstitutionSource) {
+      if (source.is_system_absolute() ||
+          output_style_ == SubstitutionWriter::OUTPUT_ABSOLUTE)
+        dest->append(value);
+      else
+        AppendRebasedPath(value, relative_to_, root_path, dest);
+    } else if (step.type == &SubstitutionSourceNamePart) {
+      dest->append(FindFilenameNoExtension(&value));
+    } else if (step.type == &SubstitutionSourceFilePart) {
+      dest->append(value, name_offset, std::string::npos);
+    } else if (step.type == &SubstitutionSourceTargetRelative && target_) {
+      AppendRebasedPath(value, target_->label().dir(), root_path, dest);
+    } else if (step.type == &SubstitutionSourceDir ||
+               step.type == &SubstitutionSourceRootRelativeDir ||
+               step.type == &SubstitutionSourceGenDir ||
+               step.type == &SubstitutionSourceOutDir) {
+      dest->append(step.dir_value);
+    } else {
+      // Uncommon substitutions (and errors) use the regular path.
+      dest->append(SubstitutionWriter::GetSourceSubstitution(
+          target_, settings_, source, step.type, output_style_,
+          relative_to_));
+    }
+  }
+}
+
+void SourceSubstitutionPlan::WriteForSource(
+    const SourceFile& source,
+    const EscapeOptions& escape_options,
+    std::ostream& out) {
+  scratch_.clear();
+  AppendForSource(source, &scratch_);
+  EscapeStringToStream(out, scratch_, escape_options);
+}
+
+SourceFile SourceSubstitutionPlan::GetSourceFileForSource(
+    const SourceFile& source) {
+  ExpandSourcePath(source);
+  return SourceFile(scratch_);
+}
+
+OutputFile SourceSubstitutionPlan::GetOutputFileForSource(
+    const SourceFile& source) {
+  ExpandSourcePath(source);
+  NormalizePath(&scratch_);  // Same as the SourceFile constructor does.
+  const BuildSettings* build_settings = settings_->build_settings();
+  std::string result;
+  AppendRebasedPath(scratch_, build_settings->build_dir(),
+                    build_settings->root_path_utf8(), &result);
+  return OutputFile(std::move(result));
+}
+
+void SourceSubstitutionPlan::ExpandSourcePath(const SourceFile& source) {
+  DCHECK(output_style_ == SubstitutionWriter::OUTPUT_ABSOLUTE);
+  scratch_.clear();
+  AppendForSource(source, &scratch_);
+  CHECK(!scratch_.empty() && scratch_[0] == '/')
+      << "The result of the pattern \""
+      << (pattern_ ? pattern_->AsString() : std::string())
+      << "\" was not a path beginning in \"/\" or \"//\".";
+}
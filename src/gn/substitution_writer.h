@@ -7,14 +7,15 @@
 
 #include <iosfwd>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "gn/source_dir.h"
 #include "gn/substitution_type.h"
 
 struct EscapeOptions;
 class OutputFile;
 class Settings;
-class SourceDir;
 class SourceFile;
 class SubstitutionList;
 class SubstitutionPattern;
@@ -235,4 +236,89 @@ class SubstitutionWriter {
                                            const Substitution* type);
 };
 
+// A SubstitutionPattern prepared for expanding the source substitutions for
+// many sources of the same target, as done for action_foreach and copy
+// targets and process_file_template().
+//
+// The results are the same as with the SubstitutionWriter functions, but no
+// temporary strings are built per source: the values that only depend on the
+// directory of the source are computed once per run of sources in the same
+// directory (sources are normally sorted), the file name parts are copied
+// straight from the SourceFile, and results are appended to buffers that are
+// reused from one source to the next.
+//
+// The target can be null (see SubstitutionWriter above). The pattern must
+// outlive the plan.
+class SourceSubstitutionPlan {
+ public:
+  SourceSubstitutionPlan(const Target* target,
+                         const Settings* settings,
+                         const SubstitutionPattern& pattern,
+                         SubstitutionWriter::OutputStyle output_style,
+                         const SourceDir& relative_to);
+
+  // Plan for expanding a single substitution, as used for the Ninja
+  // variables of SubstitutionWriter::WriteNinjaVariablesForSource().
+  SourceSubstitutionPlan(const Target* target,
+                         const Settings* settings,
+                         const Substitution* type,
+                         SubstitutionWriter::OutputStyle output_style,
+                         const SourceDir& relative_to);
+
+  ~SourceSubstitutionPlan();
+
+  // Appends the expansion for the given source to |dest|. With
+  // OUTPUT_ABSOLUTE this is the same as
+  // SubstitutionWriter::ApplyPatternToSourceAsString().
+  void AppendForSource(const SourceFile& source, std::string* dest);
+
+  // Writes the escaped expansion for the given source to |out|.
+  void WriteForSource(const SourceFile& source,
+                      const EscapeOptions& escape_options,
+                      std::ostream& out);
+
+  // Same as SubstitutionWriter::ApplyPatternToSource() and
+  // ApplyPatternToSourceAsOutputFile(). The plan must use OUTPUT_ABSOLUTE.
+  SourceFile GetSourceFileForSource(const SourceFile& source);
+  OutputFile GetOutputFileForSource(const SourceFile& source);
+
+ private:
+  struct Step {
+    const Substitution* type;
+
+    // For SubstitutionLiteral.
+    std::string_view literal;
+
+    // For substitutions that only depend on the directory of the source, the
+    // value for |cached_dir_|.
+    std::string dir_value;
+  };
+
+  void AddStep(const Substitution* type, std::string_view literal);
+
+  // Expands the pattern into |scratch_| and CHECKs that the result is a
+  // source-absolute or system-absolute path.
+  void ExpandSourcePath(const SourceFile& source);
+
+  const Target* target_;
+  const Settings* settings_;
+  const SubstitutionPattern* pattern_;  // Null for single substitutions.
+  SubstitutionWriter::OutputStyle output_style_;
+  SourceDir relative_to_;
+
+  std::vector<Step> steps_;
+  bool has_dir_steps_ = false;
+
+  // Directory of the source the |dir_value|s were computed for, including
+  // the trailing slash.
+  std::string cached_dir_;
+  bool has_cached_dir_ = false;
+
+  // Reused for building results that aren't appended to a caller's string.
+  std::string scratch_;
+
+  SourceSubstitutionPlan(const SourceSubstitutionPlan&) = delete;
+  SourceSubstitutionPlan& operator=(const SourceSubstitutionPlan&) = delete;
+};
+
 #endif  // TOOLS_GN_SUBSTITUTION_WRITER_H_
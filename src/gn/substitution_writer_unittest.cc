@@ -187,6 +187,104 @@ TEST(SubstitutionWriter, SourceSubstitutions) {
 #undef GetRelSubst
 }
 
+// The plans must give exactly the same results as the functions above.
+TEST(SubstitutionWriter, SourceSubstitutionPlan) {
+  TestWithScope setup;
+  Err err;
+
+  Target target(setup.settings(), Label(SourceDir("//foo/bar/"), "baz"));
+  target.set_output_type(Target::ACTION_FOREACH);
+  target.SetToolchain(setup.toolchain());
+  ASSERT_TRUE(target.OnResolved(&err));
+
+  // Grouped by directory so the cached directory values are both reused and
+  // replaced.
+  const char* kSources[] = {
+      "//foo/bar/baz.txt",
+      "//foo/bar/a b.txt",
+      "//foo/bar/noext",
+      "//foo/bar/.hidden",
+      "//foo/x.y.z",
+      "//baz.txt",
+      "//out",
+      "//out/Debug",
+      "//out/Debug/gen.h",
+      "//out/Debug/gen/a.idl",
+      "//out/Debugger/a.idl",
+      "/baz.txt",
+      "/abs/dir/baz.txt",
+      "//foo/bar/baz.txt",
+  };
+  const Substitution* kTypes[] = {
+      &SubstitutionSource,
+      &SubstitutionSourceNamePart,
+      &SubstitutionSourceFilePart,
+      &SubstitutionSourceDir,
+      &SubstitutionSourceRootRelativeDir,
+      &SubstitutionSourceGenDir,
+      &SubstitutionSourceOutDir,
+      &SubstitutionSourceTargetRelative,
+  };
+  SourceDir kRelativeTo[] = {
+      setup.settings()->build_settings()->build_dir(),
+      SourceDir("//"),
+      SourceDir("//foo/bar/baz/"),
+      SourceDir("/abs/"),
+  };
+
+  for (const SourceDir& relative_to : kRelativeTo) {
+    for (auto output_style : {SubstitutionWriter::OUTPUT_ABSOLUTE,
+                              SubstitutionWriter::OUTPUT_RELATIVE}) {
+      for (const Substitution* type : kTypes) {
+        SourceSubstitutionPlan plan(&target, setup.settings(), type,
+                                    output_style, relative_to);
+        for (const char* source : kSources) {
+          std::string expected = SubstitutionWriter::GetSourceSubstitution(
+              &target, setup.settings(), SourceFile(source), type,
+              output_style, relative_to);
+          std::string result = "prefix";
+          plan.AppendForSource(SourceFile(source), &result);
+          EXPECT_EQ("prefix" + expected, result)
+              << type->name << " " << source << " " << relative_to.value();
+        }
+      }
+    }
+  }
+
+  SubstitutionPattern pattern = SubstitutionPattern::MakeForTest(
+      "//out/Debug/gen/{{source_target_relative}}/../{{source_name_part}} "
+      "{{source_root_relative_dir}}.{{source_file_part}}");
+  SourceSubstitutionPlan plan(&target, setup.settings(), pattern,
+                              SubstitutionWriter::OUTPUT_ABSOLUTE,
+                              SourceDir());
+  EscapeOptions escape_options;
+  escape_options.mode = ESCAPE_NINJA_COMMAND;
+  for (const char* source : kSources) {
+    SourceFile source_file(source);
+    std::string expected = SubstitutionWriter::ApplyPatternToSourceAsString(
+        &target, setup.settings(), pattern, source_file);
+    std::string result;
+    plan.AppendForSource(source_file, &result);
+    EXPECT_EQ(expected, result) << source;
+
+    std::ostringstream out;
+    plan.WriteForSource(source_file, escape_options, out);
+    EXPECT_EQ(EscapeString(expected, escape_options, nullptr), out.str())
+        << source;
+
+    EXPECT_EQ(SubstitutionWriter::ApplyPatternToSource(
+                  &target, setup.settings(), pattern, source_file)
+                  .value(),
+              plan.GetSourceFileForSource(source_file).value())
+        << source;
+    EXPECT_EQ(SubstitutionWriter::ApplyPatternToSourceAsOutputFile(
+                  &target, setup.settings(), pattern, source_file)
+                  .value(),
+              plan.GetOutputFileForSource(source_file).value())
+        << source;
+  }
+}
+
 TEST(SubstitutionWriter, TargetSubstitutions) {
   TestWithScope setup;
   Err err;
@@ -109,6 +109,29 @@ const char kNinjaExecutable_Help[] =
   post-processing on the generated files for more consistent builds.
 )";
 
+const char kPrefetchExecScript[] = "prefetch-exec-script";
+const char kPrefetchExecScript_HelpShort[] =
+    "--prefetch-exec-script: Start the scripts of the previous run early.";
+const char kPrefetchExecScript_Help[] =
+    R"(--prefetch-exec-script: Start the scripts of the previous run early.
+
+  Records the commands run by exec_script() in the build directory, and starts
+  the commands recorded by the previous run as soon as the build starts
+  loading, in the background. When exec_script() then runs a command that was
+  started this way, in the same directory, it uses its result instead of
+  running it again. This hides the startup time of the scripts, which often
+  dominates the evaluation of the build config file.
+
+  The scripts may run before what precedes their exec_script() call in the
+  build files, and those that are no longer called still run once. Only use
+  this when the scripts have no side effects and don't depend on files written
+  during the same run, for example by write_file().
+
+Example
+
+  gn gen out/Default --prefetch-exec-script
+)";
+
 const char kScriptExecutable[] = "script-executable";
 const char kScriptExecutable_HelpShort[] =
     "--script-executable: Set the executable used to execute scripts.";
@@ -337,6 +360,7 @@ const SwitchInfoMap& GetSwitches() {
     INSERT_VARIABLE(Markdown)
     INSERT_VARIABLE(NinjaExecutable)
     INSERT_VARIABLE(NoColor)
+    INSERT_VARIABLE(PrefetchExecScript)
     INSERT_VARIABLE(Root)
     INSERT_VARIABLE(RootTarget)
     INSERT_VARIABLE(Quiet)
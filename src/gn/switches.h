@@ -54,6 +54,10 @@ extern const char kNoColor[];
 extern const char kNoColor_HelpShort[];
 extern const char kNoColor_Help[];
 
+extern const char kPrefetchExecScript[];
+extern const char kPrefetchExecScript_HelpShort[];
+extern const char kPrefetchExecScript_Help[];
+
 extern const char kScriptExecutable[];
 extern const char kScriptExecutable_HelpShort[];
 extern const char kScriptExecutable_Help[];
@@ -7,6 +7,7 @@
 #include <stddef.h>
 
 #include <algorithm>
+#include <map>
 
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
@@ -16,6 +17,8 @@
 #include "gn/deps_iterator.h"
 #include "gn/filesystem_utils.h"
 #include "gn/functions.h"
+#include "gn/id_table.h"
+#include "gn/label_pattern_set.h"
 #include "gn/rust_tool.h"
 #include "gn/scheduler.h"
 #include "gn/substitution_writer.h"
@@ -161,25 +164,23 @@ bool EnsureFileIsGeneratedByDependency(const Target* target,
 // will be unchanged in this case.
 bool RecursiveCheckAssertNoDeps(const Target* target,
                                 bool check_this,
-                                const std::vector<LabelPattern>& assert_no,
-                                TargetSet* visited,
+                                const LabelPatternSet& assert_no,
+                                IdBitSet* visited,
                                 std::string* failure_path_str,
                                 const LabelPattern** failure_pattern) {
   static const char kIndentPath[] = "  ";
 
-  if (!visited->add(target))
+  if (!visited->add(target->id()))
     return true;  // Already checked this target.
 
   if (check_this) {
     // Check this target against the given list of patterns.
-    for (const LabelPattern& pattern : assert_no) {
-      if (pattern.Matches(target->label())) {
-        // Found a match.
-        *failure_pattern = &pattern;
-        *failure_path_str =
-            kIndentPath + target->label().GetUserVisibleName(false);
-        return false;
-      }
+    if (const LabelPattern* pattern = assert_no.FirstMatch(target->label())) {
+      // Found a match.
+      *failure_pattern = pattern;
+      *failure_path_str =
+          kIndentPath + target->label().GetUserVisibleName(false);
+      return false;
     }
   }
 
@@ -454,6 +455,10 @@ const Target* Target::AsTarget() const {
 }
 
 bool Target::OnResolved(Err* err) {
+  return OnResolved(nullptr, err);
+}
+
+bool Target::OnResolved(AssertNoDepsCache* assert_no_deps_cache, Err* err) {
   DCHECK(output_type_ != UNKNOWN);
   DCHECK(toolchain_) << "Toolchain should have been set before resolving.";
 
@@ -502,7 +507,7 @@ bool Target::OnResolved(Err* err) {
     return false;
   if (!CheckTestonly(err))
     return false;
-  if (!CheckAssertNoDeps(err))
+  if (!CheckAssertNoDeps(assert_no_deps_cache, err))
     return false;
   CheckSourcesGenerated();
 
@@ -548,12 +553,13 @@ bool Target::IsDataOnly() const {
 }
 
 bool Target::ShouldGenerate() const {
-  const auto& root_patterns = settings()->build_settings()->root_patterns();
+  const LabelPatternSet& root_patterns =
+      settings()->build_settings()->root_pattern_set();
   if (root_patterns.empty()) {
     // By default, generate all targets that belong to the default toolchain.
     return settings()->is_default();
   }
-  return LabelPattern::VectorMatches(root_patterns, label());
+  return root_patterns.Matches(label());
 }
 
 DepsIteratorRange Target::GetDeps(DepsIterationType type) const {
@@ -1091,15 +1097,20 @@ bool Target::CheckTestonly(Err* err) const {
   return true;
 }
 
-bool Target::CheckAssertNoDeps(Err* err) const {
+bool Target::CheckAssertNoDeps(AssertNoDepsCache* cache, Err* err) const {
   if (assert_no_deps_.empty())
     return true;
 
-  TargetSet visited;
+  // Almost all targets pass, so the path is only looked for on failure.
+  if (cache && !cache->DepsContain(this, assert_no_deps_))
+    return true;
+
+  LabelPatternSet assert_no(assert_no_deps_);
+  IdBitSet visited(Item::GetIdCount());
   std::string failure_path_str;
   const LabelPattern* failure_pattern = nullptr;
 
-  if (!RecursiveCheckAssertNoDeps(this, false, assert_no_deps_, &visited,
+  if (!RecursiveCheckAssertNoDeps(this, false, assert_no, &visited,
                                   &failure_path_str, &failure_pattern)) {
     *err = Err(
         defined_from(), "assert_no_deps failed.",
@@ -1253,3 +1264,42 @@ bool Target::GetMetadata(const std::vector<std::string>& keys_to_extract,
                  std::make_move_iterator(current_result.end()));
   return true;
 }
+
+AssertNoDepsCache::AssertNoDepsCache() = default;
+
+AssertNoDepsCache::~AssertNoDepsCache() = default;
+
+bool AssertNoDepsCache::DepsContain(const Target* target,
+                                    const std::vector<LabelPattern>& patterns) {
+  for (const LabelPattern& pattern : patterns) {
+    Contents* contents = &contents_[pattern.Describe()];
+    for (const auto& pair : target->GetDeps(Target::DEPS_ALL)) {
+      if (pair.ptr->output_type() != Target::EXECUTABLE &&
+          Contains(pair.ptr, pattern, contents))
+        return true;
+    }
+  }
+  return false;
+}
+
+// static
+bool AssertNoDepsCache::Contains(const Target* target,
+                                 const LabelPattern& pattern,
+                                 Contents* contents) {
+  if (!contents->checked.add(target->id()))
+    return contents->contains.contains(target->id());
+
+  bool result = pattern.Matches(target->label());
+  if (!result) {
+    for (const auto& pair : target->GetDeps(Target::DEPS_ALL)) {
+      if (pair.ptr->output_type() != Target::EXECUTABLE &&
+          Contains(pair.ptr, pattern, contents)) {
+        result = true;
+        break;
+      }
+    }
+  }
+  if (result)
+    contents->contains.add(target->id());
+  return result;
+}
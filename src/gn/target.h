@@ -5,6 +5,7 @@
 #ifndef TOOLS_GN_TARGET_H_
 #define TOOLS_GN_TARGET_H_
 
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -14,6 +15,7 @@
 #include "gn/action_values.h"
 #include "gn/bundle_data.h"
 #include "gn/config_values.h"
+#include "gn/id_table.h"
 #include "gn/item.h"
 #include "gn/label_pattern.h"
 #include "gn/label_ptr.h"
@@ -27,6 +29,7 @@
 #include "gn/unique_vector.h"
 
 class DepsIteratorRange;
+class AssertNoDepsCache;
 class Settings;
 class Target;
 class Toolchain;
@@ -76,6 +79,10 @@ class Target : public Item {
   const Target* AsTarget() const override;
   bool OnResolved(Err* err) override;
 
+  // Like OnResolved(), but checks assert_no_deps with |assert_no_deps_cache|,
+  // which is shared by all the targets resolved by a Builder.
+  bool OnResolved(AssertNoDepsCache* assert_no_deps_cache, Err* err);
+
   OutputType output_type() const { return output_type_; }
   void set_output_type(OutputType t) { output_type_ = t; }
 
@@ -486,7 +493,7 @@ class Target : public Item {
   bool CheckVisibility(Err* err) const;
   bool CheckConfigVisibility(Err* err) const;
   bool CheckTestonly(Err* err) const;
-  bool CheckAssertNoDeps(Err* err) const;
+  bool CheckAssertNoDeps(AssertNoDepsCache* cache, Err* err) const;
   void CheckSourcesGenerated() const;
   void CheckSourceGenerated(const SourceFile& source) const;
   bool CheckSourceSetLanguages(Err* err) const;
@@ -558,6 +565,37 @@ class Target : public Item {
   Target& operator=(const Target&) = delete;
 };
 
+// Remembers, for each assert_no_deps pattern, which targets contain it: the
+// target matches the pattern or one of its deps does, not looking past
+// executables. Deps are resolved before the targets depending on them and
+// don't change afterwards, so each target is checked once per pattern no
+// matter how many targets assert the pattern on it. Not threadsafe.
+class AssertNoDepsCache {
+ public:
+  AssertNoDepsCache();
+  ~AssertNoDepsCache();
+
+  // Returns true if one of the deps of |target| contains one of |patterns|.
+  bool DepsContain(const Target* target,
+                   const std::vector<LabelPattern>& patterns);
+
+ private:
+  struct Contents {
+    IdBitSet checked;
+    IdBitSet contains;
+  };
+
+  static bool Contains(const Target* target,
+                       const LabelPattern& pattern,
+                       Contents* contents);
+
+  // Keyed by the description of the pattern.
+  std::map<std::string, Contents> contents_;
+
+  AssertNoDepsCache(const AssertNoDepsCache&) = delete;
+  AssertNoDepsCache& operator=(const AssertNoDepsCache&) = delete;
+};
+
 extern const char kExecution_Help[];
 
 #endif  // TOOLS_GN_TARGET_H_
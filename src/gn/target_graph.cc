@@ -0,0 +1,104 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/target_graph.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "gn/target.h"
+#include "util/worker_pool.h"
+
+namespace {
+
+// Number of targets whose deps are resolved by each task.
+constexpr size_t kTargetsPerChunk = 256;
+
+}  // namespace
+
+TargetGraph::TargetGraph(std::vector<const Target*> targets)
+    : targets_(std::move(targets)), nodes_(Item::GetIdCount()) {
+  for (size_t i = 0; i < targets_.size(); i++)
+    nodes_[targets_[i]->id()] = static_cast<uint32_t>(i + 1);
+
+  // Resolve the deps of each chunk of targets to edges in parallel. The
+  // number of deps of each node is stored in deps_begin_ for now.
+  const size_t chunk_count =
+      (targets_.size() + kTargetsPerChunk - 1) / kTargetsPerChunk;
+  std::vector<std::vector<Edge>> chunk_deps(chunk_count);
+  deps_begin_.resize(targets_.size() + 1);
+  WorkerPool::GetShared().ParallelFor(chunk_count, [&](size_t chunk) {
+    const size_t begin = chunk * kTargetsPerChunk;
+    const size_t end = std::min(begin + kTargetsPerChunk, targets_.size());
+    std::vector<Edge>& edges = chunk_deps[chunk];
+    for (size_t i = begin; i < end; i++) {
+      const Target* target = targets_[i];
+      const size_t first_edge = edges.size();
+      auto add_edges = [&](const LabelTargetVector& deps, DepType type) {
+        for (const auto& pair : deps) {
+          uint32_t dep_node = GetNode(pair.ptr);
+          if (dep_node != kNoNode)
+            edges.push_back({dep_node, type});
+        }
+      };
+      add_edges(target->public_deps(), DepType::PUBLIC);
+      add_edges(target->private_deps(), DepType::PRIVATE);
+      add_edges(target->data_deps(), DepType::DATA);
+      deps_begin_[i + 1] = edges.size() - first_edge;
+    }
+  });
+
+  for (size_t i = 0; i < targets_.size(); i++)
+    deps_begin_[i + 1] += deps_begin_[i];
+  deps_.reserve(deps_begin_.back());
+  for (const std::vector<Edge>& edges : chunk_deps)
+    deps_.insert(deps_.end(), edges.begin(), edges.end());
+
+  // Invert the edges. Filling the dependents node by node keeps each list in
+  // node order.
+  dependents_begin_.resize(targets_.size() + 1);
+  for (const Edge& edge : deps_)
+    dependents_begin_[edge.node + 1]++;
+  for (size_t i = 0; i < targets_.size(); i++)
+    dependents_begin_[i + 1] += dependents_begin_[i];
+  dependents_.resize(deps_.size());
+  std::vector<size_t> next_dependent(dependents_begin_.begin(),
+                                     dependents_begin_.end() - 1);
+  for (uint32_t node = 0; node < targets_.size(); node++) {
+    for (const Edge& edge : deps(node))
+      dependents_[next_dependent[edge.node]++] = {node, edge.type};
+  }
+}
+
+TargetGraph::~TargetGraph() = default;
+
+uint32_t TargetGraph::GetNode(const Target* target) const {
+  uint32_t index = nodes_.get(target->id());
+  return index ? index - 1 : kNoNode;
+}
+
+void TargetGraph::CollectDependents(const std::vector<uint32_t>& nodes,
+                                    DepType max_type,
+                                    IdBitSet* result) const {
+  std::vector<uint32_t> stack(nodes);
+  while (!stack.empty()) {
+    uint32_t node = stack.back();
+    stack.pop_back();
+    for (const Edge& edge : dependents(node)) {
+      if (edge.type <= max_type && result->add(edge.node))
+        stack.push_back(edge.node);
+    }
+  }
+}
+
+std::vector<const Target*> TargetGraph::GetTargets(
+    const IdBitSet& nodes) const {
+  std::vector<const Target*> result;
+  result.reserve(nodes.size());
+  for (uint32_t node = 0; node < targets_.size(); node++) {
+    if (nodes.contains(node))
+      result.push_back(targets_[node]);
+  }
+  return result;
+}
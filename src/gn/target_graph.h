@@ -0,0 +1,106 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_TARGET_GRAPH_H_
+#define TOOLS_GN_TARGET_GRAPH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "gn/id_table.h"
+
+class Target;
+
+// The dependency graph of a set of targets, for the commands querying it
+// such as "gn refs" and "gn path".
+//
+// The targets are numbered densely in the order they are given, and the
+// deps of each target and the targets depending on it are stored in flat
+// arrays, so walks over the graph use node numbers to index IdBitSets and
+// IdTables instead of keying containers by target.
+class TargetGraph {
+ public:
+  // How a target depends on another. Ordered so that each type includes the
+  // ones before it when used as the maximum type of deps to follow.
+  enum class DepType : uint8_t { PUBLIC, PRIVATE, DATA };
+
+  struct Edge {
+    uint32_t node;
+    DepType type;
+  };
+
+  // The edges of one node.
+  class EdgeRange {
+   public:
+    EdgeRange(const Edge* begin, const Edge* end) : begin_(begin), end_(end) {}
+
+    const Edge* begin() const { return begin_; }
+    const Edge* end() const { return end_; }
+    bool empty() const { return begin_ == end_; }
+    size_t size() const { return end_ - begin_; }
+
+   private:
+    const Edge* begin_;
+    const Edge* end_;
+  };
+
+  // Returned by GetNode() for targets that are not in the graph.
+  static constexpr uint32_t kNoNode = UINT32_MAX;
+
+  // Builds the graph of |targets|, resolving the deps of the targets on a
+  // worker pool. Deps on targets that are not in |targets| are ignored.
+  explicit TargetGraph(std::vector<const Target*> targets);
+  ~TargetGraph();
+
+  size_t size() const { return targets_.size(); }
+
+  // The targets of the graph, indexed by node.
+  const std::vector<const Target*>& targets() const { return targets_; }
+  const Target* target(uint32_t node) const { return targets_[node]; }
+
+  // Returns the node of |target|, or kNoNode if it isn't in the graph.
+  uint32_t GetNode(const Target* target) const;
+
+  // The public, private and data deps of |node|, in that order.
+  EdgeRange deps(uint32_t node) const {
+    return EdgeRange(deps_.data() + deps_begin_[node],
+                     deps_.data() + deps_begin_[node + 1]);
+  }
+
+  // The targets depending on |node|, in node order.
+  EdgeRange dependents(uint32_t node) const {
+    return EdgeRange(dependents_.data() + dependents_begin_[node],
+                     dependents_.data() + dependents_begin_[node + 1]);
+  }
+
+  // Adds to |result| the nodes that depend directly or indirectly on any of
+  // |nodes|, only following deps up to |max_type|. The given nodes are not
+  // added themselves. Nodes already in |result| are not walked again.
+  void CollectDependents(const std::vector<uint32_t>& nodes,
+                         DepType max_type,
+                         IdBitSet* result) const;
+
+  // Returns the targets of |nodes| in node order.
+  std::vector<const Target*> GetTargets(const IdBitSet& nodes) const;
+
+ private:
+  std::vector<const Target*> targets_;
+
+  // Maps the Item::id() of the targets to their node plus one, so that
+  // targets that are not in the graph map to 0.
+  IdTable<uint32_t> nodes_;
+
+  // The edges of node N are in [begin[N], begin[N + 1]).
+  std::vector<size_t> deps_begin_;
+  std::vector<Edge> deps_;
+  std::vector<size_t> dependents_begin_;
+  std::vector<Edge> dependents_;
+
+  TargetGraph(const TargetGraph&) = delete;
+  TargetGraph& operator=(const TargetGraph&) = delete;
+};
+
+#endif  // TOOLS_GN_TARGET_GRAPH_H_
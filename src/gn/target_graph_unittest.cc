@@ -0,0 +1,85 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/target_graph.h"
+
+#include "gn/test_with_scope.h"
+#include "util/test/test.h"
+
+namespace {
+
+using DepType = TargetGraph::DepType;
+
+std::vector<uint32_t> Nodes(TargetGraph::EdgeRange edges) {
+  std::vector<uint32_t> result;
+  for (const TargetGraph::Edge& edge : edges)
+    result.push_back(edge.node);
+  return result;
+}
+
+}  // namespace
+
+TEST(TargetGraph, Edges) {
+  TestWithScope setup;
+
+  // a -> b (public), a -> c (private), b -> c (data), d -> c (public).
+  TestTarget a(setup, "//foo:a", Target::EXECUTABLE);
+  TestTarget b(setup, "//foo:b", Target::STATIC_LIBRARY);
+  TestTarget c(setup, "//foo:c", Target::STATIC_LIBRARY);
+  TestTarget d(setup, "//foo:d", Target::STATIC_LIBRARY);
+  TestTarget not_in_graph(setup, "//foo:e", Target::STATIC_LIBRARY);
+  a.private_deps().push_back(LabelTargetPair(&c));
+  a.public_deps().push_back(LabelTargetPair(&b));
+  b.data_deps().push_back(LabelTargetPair(&c));
+  d.public_deps().push_back(LabelTargetPair(&c));
+  d.public_deps().push_back(LabelTargetPair(&not_in_graph));
+
+  TargetGraph graph({&a, &b, &c, &d});
+  ASSERT_EQ(4u, graph.size());
+  EXPECT_EQ(0u, graph.GetNode(&a));
+  EXPECT_EQ(2u, graph.GetNode(&c));
+  EXPECT_EQ(&d, graph.target(3));
+  EXPECT_EQ(TargetGraph::kNoNode, graph.GetNode(&not_in_graph));
+
+  // Public deps come first, and deps outside the graph are skipped.
+  EXPECT_EQ(std::vector<uint32_t>({1, 2}), Nodes(graph.deps(0)));
+  EXPECT_EQ(DepType::PUBLIC, graph.deps(0).begin()[0].type);
+  EXPECT_EQ(DepType::PRIVATE, graph.deps(0).begin()[1].type);
+  EXPECT_EQ(std::vector<uint32_t>({2}), Nodes(graph.deps(3)));
+  EXPECT_TRUE(graph.deps(2).empty());
+
+  // Dependents are in node order.
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 3}), Nodes(graph.dependents(2)));
+  EXPECT_EQ(DepType::PRIVATE, graph.dependents(2).begin()[0].type);
+  EXPECT_EQ(DepType::DATA, graph.dependents(2).begin()[1].type);
+  EXPECT_EQ(std::vector<uint32_t>({0}), Nodes(graph.dependents(1)));
+  EXPECT_TRUE(graph.dependents(0).empty());
+}
+
+TEST(TargetGraph, CollectDependents) {
+  TestWithScope setup;
+
+  // a -> b (public) -> c (data), d -> c (private).
+  TestTarget a(setup, "//foo:a", Target::EXECUTABLE);
+  TestTarget b(setup, "//foo:b", Target::STATIC_LIBRARY);
+  TestTarget c(setup, "//foo:c", Target::STATIC_LIBRARY);
+  TestTarget d(setup, "//foo:d", Target::STATIC_LIBRARY);
+  a.public_deps().push_back(LabelTargetPair(&b));
+  b.data_deps().push_back(LabelTargetPair(&c));
+  d.private_deps().push_back(LabelTargetPair(&c));
+
+  TargetGraph graph({&a, &b, &c, &d});
+
+  IdBitSet all;
+  graph.CollectDependents({2}, DepType::DATA, &all);
+  EXPECT_EQ(std::vector<const Target*>({&a, &b, &d}), graph.GetTargets(all));
+
+  IdBitSet linked;
+  graph.CollectDependents({2}, DepType::PRIVATE, &linked);
+  EXPECT_EQ(std::vector<const Target*>({&d}), graph.GetTargets(linked));
+
+  IdBitSet public_only;
+  graph.CollectDependents({1, 2}, DepType::PUBLIC, &public_only);
+  EXPECT_EQ(std::vector<const Target*>({&a}), graph.GetTargets(public_only));
+}
@@ -1174,6 +1174,69 @@ TEST_F(TargetTest, AssertNoDeps) {
   ASSERT_TRUE(a2.OnResolved(&err));
 }
 
+// Targets sharing deps and asserting the same pattern reuse the results for
+// the deps, which must be the same as walking the deps for each of them.
+TEST_F(TargetTest, AssertNoDepsShared) {
+  TestWithScope setup;
+  Err err;
+
+  // lib -> bad, exe -> lib, other -> (nothing).
+  TestTarget bad(setup, "//bad", Target::STATIC_LIBRARY);
+  ASSERT_TRUE(bad.OnResolved(&err));
+  TestTarget lib(setup, "//lib", Target::STATIC_LIBRARY);
+  lib.private_deps().push_back(LabelTargetPair(&bad));
+  ASSERT_TRUE(lib.OnResolved(&err));
+  TestTarget other(setup, "//other", Target::STATIC_LIBRARY);
+  ASSERT_TRUE(other.OnResolved(&err));
+  TestTarget exe(setup, "//exe", Target::EXECUTABLE);
+  exe.private_deps().push_back(LabelTargetPair(&lib));
+  ASSERT_TRUE(exe.OnResolved(&err));
+
+  LabelPattern disallow_bad(LabelPattern::RECURSIVE_DIRECTORY,
+                            SourceDir("//bad/"), std::string(), Label());
+  LabelPattern disallow_other(LabelPattern::RECURSIVE_DIRECTORY,
+                              SourceDir("//other/"), std::string(), Label());
+  AssertNoDepsCache cache;
+
+  // Only depends on other through an executable.
+  TestTarget a(setup, "//a", Target::GROUP);
+  a.public_deps().push_back(LabelTargetPair(&exe));
+  a.public_deps().push_back(LabelTargetPair(&other));
+  a.assert_no_deps().push_back(disallow_bad);
+  ASSERT_TRUE(a.OnResolved(&cache, &err));
+
+  // Depends on lib directly.
+  TestTarget b(setup, "//b", Target::GROUP);
+  b.public_deps().push_back(LabelTargetPair(&other));
+  b.public_deps().push_back(LabelTargetPair(&lib));
+  b.assert_no_deps().push_back(disallow_bad);
+  ASSERT_FALSE(b.OnResolved(&cache, &err));
+  EXPECT_EQ(
+      "//b:b has an assert_no_deps entry:\n"
+      "  //bad/*\n"
+      "which fails for the dependency path:\n"
+      "  //b:b ->\n"
+      "  //lib:lib ->\n"
+      "  //bad:bad",
+      err.help_text());
+  err = Err();
+
+  // The second pattern matches, the first one doesn't.
+  TestTarget c(setup, "//c", Target::GROUP);
+  c.public_deps().push_back(LabelTargetPair(&other));
+  c.public_deps().push_back(LabelTargetPair(&exe));
+  c.assert_no_deps().push_back(disallow_bad);
+  c.assert_no_deps().push_back(disallow_other);
+  ASSERT_FALSE(c.OnResolved(&cache, &err));
+  EXPECT_EQ(
+      "//c:c has an assert_no_deps entry:\n"
+      "  //other/*\n"
+      "which fails for the dependency path:\n"
+      "  //c:c ->\n"
+      "  //other:other",
+      err.help_text());
+}
+
 TEST_F(TargetTest, PullRecursiveBundleData) {
   TestWithScope setup;
   Err err;
@@ -4,32 +4,91 @@
 
 #include "gn/tokenizer.h"
 
+#include <stdint.h>
+
+#include <utility>
+
 #include "base/logging.h"
-#include "base/strings/string_util.h"
 #include "gn/input_file.h"
 
 namespace {
 
-bool CouldBeTwoCharOperatorBegin(char c) {
-  return c == '<' || c == '>' || c == '!' || c == '=' || c == '-' || c == '+' ||
-         c == '|' || c == '&';
-}
+// Classes of characters, as bits of the entries of kCharTable.
+enum CharClass : uint16_t {
+  kWhitespace = 1 << 0,  // \n, \r and space.
+  // Tab, vertical tab and form feed, only whitespace when converted to spaces.
+  kInvalidWhitespace = 1 << 1,
+  kIdentifierFirst = 1 << 2,
+  kDigit = 1 << 3,
+  kOperator = 1 << 4,
+  kTwoCharOperatorBegin = 1 << 5,
+  kTwoCharOperatorEnd = 1 << 6,
+  kScoper = 1 << 7,
+  // Characters that end a run of ordinary characters in a string literal.
+  kStringSpecial = 1 << 8,
+
+  kIdentifierContinuing = kIdentifierFirst | kDigit,
+};
+
+// The classes of each character, and the type of the tokens starting with it
+// (see Tokenizer::ClassifyToken()), so that classifying a character is a
+// single lookup.
+struct CharTable {
+  constexpr CharTable() {
+    auto add = [this](std::string_view chars, uint16_t char_class) {
+      for (char c : chars)
+        classes[static_cast<unsigned char>(c)] |= char_class;
+    };
+    add("\n\r ", kWhitespace);
+    add("\t\v\f", kInvalidWhitespace);
+    for (char c = 'a'; c <= 'z'; c++)
+      add(std::string_view(&c, 1), kIdentifierFirst);
+    for (char c = 'A'; c <= 'Z'; c++)
+      add(std::string_view(&c, 1), kIdentifierFirst);
+    add("_", kIdentifierFirst);
+    add("0123456789", kDigit);
+    add("=<>+!:|&-", kOperator);
+    add("<>!=-+|&", kTwoCharOperatorBegin | kOperator);
+    add("=|&", kTwoCharOperatorEnd);
+    add("()[]{}", kScoper);
+    add("\"\\\n", kStringSpecial);
+
+    for (int i = 0; i < 256; i++) {
+      if (classes[i] & kDigit)
+        types[i] = Token::INTEGER;
+      else if (classes[i] & kOperator)
+        types[i] = Token::UNCLASSIFIED_OPERATOR;
+      else if (classes[i] & kIdentifierFirst)
+        types[i] = Token::IDENTIFIER;
+    }
+    types[static_cast<unsigned char>('"')] = Token::STRING;
+    types[static_cast<unsigned char>('[')] = Token::LEFT_BRACKET;
+    types[static_cast<unsigned char>(']')] = Token::RIGHT_BRACKET;
+    types[static_cast<unsigned char>('(')] = Token::LEFT_PAREN;
+    types[static_cast<unsigned char>(')')] = Token::RIGHT_PAREN;
+    types[static_cast<unsigned char>('{')] = Token::LEFT_BRACE;
+    types[static_cast<unsigned char>('}')] = Token::RIGHT_BRACE;
+    types[static_cast<unsigned char>('.')] = Token::DOT;
+    types[static_cast<unsigned char>(',')] = Token::COMMA;
+    types[static_cast<unsigned char>('#')] = Token::UNCLASSIFIED_COMMENT;
+  }
 
-bool CouldBeTwoCharOperatorEnd(char c) {
-  return c == '=' || c == '|' || c == '&';
-}
+  uint16_t classes[256] = {};
+  Token::Type types[256] = {};
+};
+
+constexpr CharTable kCharTable;
 
-bool CouldBeOneCharOperator(char c) {
-  return c == '=' || c == '<' || c == '>' || c == '+' || c == '!' || c == ':' ||
-         c == '|' || c == '&' || c == '-';
+bool IsClass(char c, uint16_t char_class) {
+  return (kCharTable.classes[static_cast<unsigned char>(c)] & char_class) != 0;
 }
 
 bool CouldBeOperator(char c) {
-  return CouldBeOneCharOperator(c) || CouldBeTwoCharOperatorBegin(c);
+  return IsClass(c, kOperator);
 }
 
 bool IsScoperChar(char c) {
-  return c == '(' || c == ')' || c == '[' || c == ']' || c == '{' || c == '}';
+  return IsClass(c, kScoper);
 }
 
 Token::Type GetSpecificOperatorType(std::string_view value) {
@@ -74,7 +133,10 @@ Tokenizer::Tokenizer(const InputFile* input_file,
     : input_file_(input_file),
       input_(input_file->contents()),
       err_(err),
-      whitespace_transform_(whitespace_transform) {}
+      whitespace_classes_(
+          whitespace_transform == WhitespaceTransform::kInvalidToSpace
+              ? kWhitespace | kInvalidWhitespace
+              : kWhitespace) {}
 
 Tokenizer::~Tokenizer() = default;
 
@@ -89,6 +151,10 @@ std::vector<Token> Tokenizer::Tokenize(
 
 std::vector<Token> Tokenizer::Run() {
   DCHECK(tokens_.empty());
+  // Build files average a token every 6 to 7 bytes. Start from a lower
+  // estimate to avoid most reallocations without wasting memory on the token
+  // vectors that are kept for the whole run.
+  tokens_.reserve(input_.size() / 8);
   while (!done()) {
     AdvanceToNextToken();
     if (done())
@@ -152,7 +218,7 @@ std::vector<Token> Tokenizer::Run() {
   }
   if (err_->has_error())
     tokens_.clear();
-  return tokens_;
+  return std::move(tokens_);
 }
 
 // static
@@ -184,67 +250,31 @@ bool Tokenizer::IsNewline(std::string_view buffer, size_t offset) {
 
 // static
 bool Tokenizer::IsIdentifierFirstChar(char c) {
-  return base::IsAsciiAlpha(c) || c == '_';
+  return IsClass(c, kIdentifierFirst);
 }
 
 // static
 bool Tokenizer::IsIdentifierContinuingChar(char c) {
   // Also allow digits after the first char.
-  return IsIdentifierFirstChar(c) || base::IsAsciiDigit(c);
+  return IsClass(c, kIdentifierContinuing);
 }
 
 void Tokenizer::AdvanceToNextToken() {
-  while (!at_end() && IsCurrentWhitespace())
-    Advance();
+  // Newlines are the only whitespace that needs more than moving forward.
+  while (!at_end() && IsCurrentWhitespace()) {
+    if (cur_char() == '\n')
+      StartNewLine(cur_ + 1);
+    cur_++;
+  }
 }
 
 // static
 Token::Type Tokenizer::ClassifyToken(char next_char, char following_char) {
-  if (base::IsAsciiDigit(next_char))
-    return Token::INTEGER;
-  if (next_char == '"')
-    return Token::STRING;
-
-  // Note: '-' handled specially below.
-  if (next_char != '-' && CouldBeOperator(next_char))
-    return Token::UNCLASSIFIED_OPERATOR;
-
-  if (IsIdentifierFirstChar(next_char))
-    return Token::IDENTIFIER;
-
-  if (next_char == '[')
-    return Token::LEFT_BRACKET;
-  if (next_char == ']')
-    return Token::RIGHT_BRACKET;
-  if (next_char == '(')
-    return Token::LEFT_PAREN;
-  if (next_char == ')')
-    return Token::RIGHT_PAREN;
-  if (next_char == '{')
-    return Token::LEFT_BRACE;
-  if (next_char == '}')
-    return Token::RIGHT_BRACE;
-
-  if (next_char == '.')
-    return Token::DOT;
-  if (next_char == ',')
-    return Token::COMMA;
-
-  if (next_char == '#')
-    return Token::UNCLASSIFIED_COMMENT;
-
   // For the case of '-' differentiate between a negative number and anything
   // else.
-  if (next_char == '-') {
-    if (following_char == '\0')
-      return Token::UNCLASSIFIED_OPERATOR;  // Just the minus before end of
-                                            // file.
-    if (base::IsAsciiDigit(following_char))
-      return Token::INTEGER;
-    return Token::UNCLASSIFIED_OPERATOR;
-  }
-
-  return Token::INVALID;
+  if (next_char == '-' && IsClass(following_char, kDigit))
+    return Token::INTEGER;
+  return kCharTable.types[static_cast<unsigned char>(next_char)];
 }
 
 Token::Type Tokenizer::ClassifyCurrent() const {
@@ -258,9 +288,8 @@ void Tokenizer::AdvanceToEndOfToken(const Location& location,
                                     Token::Type type) {
   switch (type) {
     case Token::INTEGER:
-      do {
-        Advance();
-      } while (!at_end() && base::IsAsciiDigit(cur_char()));
+      cur_++;  // The first digit or the minus sign.
+      SkipWhile(kDigit);
       if (!at_end()) {
         // Require the char after a number to be some kind of space, scope,
         // or operator.
@@ -275,22 +304,30 @@ void Tokenizer::AdvanceToEndOfToken(const Location& location,
       break;
 
     case Token::STRING: {
-      char initial = cur_char();
-      Advance();  // Advance past initial "
+      cur_++;  // Advance past initial "
       for (;;) {
+        SkipUntil(kStringSpecial);
         if (at_end()) {
           *err_ = Err(LocationRange(location, GetCurrentLocation()),
                       "Unterminated string literal.",
                       "Don't leave me hanging like this!");
           break;
         }
-        if (IsCurrentStringTerminator(initial)) {
-          Advance();  // Skip past last "
+        char c = cur_char();
+        if (c == '"') {
+          cur_++;  // Skip past last "
           break;
-        } else if (IsCurrentNewline()) {
-          *err_ = Err(LocationRange(location, GetCurrentLocation()),
-                      "Newline in string constant.");
         }
+        if (c == '\\') {
+          // Skip the escaped character, so that \" is not a string terminator
+          // but \\" is. An escaped newline is still reported below.
+          cur_++;
+          if (!at_end() && !IsCurrentNewline())
+            cur_++;
+          continue;
+        }
+        *err_ = Err(LocationRange(location, GetCurrentLocation()),
+                    "Newline in string constant.");
         Advance();
       }
       break;
@@ -298,16 +335,15 @@ void Tokenizer::AdvanceToEndOfToken(const Location& location,
 
     case Token::UNCLASSIFIED_OPERATOR:
       // Some operators are two characters, some are one.
-      if (CouldBeTwoCharOperatorBegin(cur_char())) {
-        if (CanIncrement() && CouldBeTwoCharOperatorEnd(input_[cur_ + 1]))
-          Advance();
+      if (IsClass(cur_char(), kTwoCharOperatorBegin)) {
+        if (CanIncrement() && IsClass(input_[cur_ + 1], kTwoCharOperatorEnd))
+          cur_++;
       }
-      Advance();
+      cur_++;
       break;
 
     case Token::IDENTIFIER:
-      while (!at_end() && IsIdentifierContinuingChar(cur_char()))
-        Advance();
+      SkipWhile(kIdentifierContinuing);
       break;
 
     case Token::LEFT_BRACKET:
@@ -318,14 +354,16 @@ void Tokenizer::AdvanceToEndOfToken(const Location& location,
     case Token::RIGHT_PAREN:
     case Token::DOT:
     case Token::COMMA:
-      Advance();  // All are one char.
+      cur_++;  // All are one char.
       break;
 
-    case Token::UNCLASSIFIED_COMMENT:
+    case Token::UNCLASSIFIED_COMMENT: {
       // Eat to EOL.
-      while (!at_end() && !IsCurrentNewline())
-        Advance();
+      size_t end_of_line = input_.find('\n', cur_);
+      cur_ = end_of_line == std::string_view::npos ? input_.size()
+                                                    : end_of_line;
       break;
+    }
 
     case Token::INVALID:
     default:
@@ -350,27 +388,8 @@ bool Tokenizer::AtStartOfLine(size_t location) const {
 
 bool Tokenizer::IsCurrentWhitespace() const {
   DCHECK(!at_end());
-  char c = input_[cur_];
   // Note that tab (0x09), vertical tab (0x0B), and formfeed (0x0C) are illegal.
-  return c == 0x0A || c == 0x0D || c == 0x20 ||
-         (whitespace_transform_ == WhitespaceTransform::kInvalidToSpace &&
-          (c == 0x09 || c == 0x0B || c == 0x0C));
-}
-
-bool Tokenizer::IsCurrentStringTerminator(char quote_char) const {
-  DCHECK(!at_end());
-  if (cur_char() != quote_char)
-    return false;
-
-  // Check for escaping. \" is not a string terminator, but \\" is. Count
-  // the number of preceding backslashes.
-  int num_backslashes = 0;
-  for (int i = static_cast<int>(cur_) - 1; i >= 0 && input_[i] == '\\'; i--)
-    num_backslashes++;
-
-  // Even backslashes mean that they were escaping each other and don't count
-  // as escaping this quote.
-  return (num_backslashes % 2) == 0;
+  return IsClass(cur_char(), whitespace_classes_);
 }
 
 bool Tokenizer::IsCurrentNewline() const {
@@ -379,17 +398,32 @@ bool Tokenizer::IsCurrentNewline() const {
 
 void Tokenizer::Advance() {
   DCHECK(cur_ < input_.size());
-  if (IsCurrentNewline()) {
-    line_number_++;
-    column_number_ = 1;
-  } else {
-    column_number_++;
-  }
+  if (IsCurrentNewline())
+    StartNewLine(cur_ + 1);
   cur_++;
 }
 
+void Tokenizer::SkipWhile(uint16_t char_classes) {
+  const char* begin = input_.data();
+  const char* end = begin + input_.size();
+  const char* p = begin + cur_;
+  while (p != end && IsClass(*p, char_classes))
+    ++p;
+  cur_ = p - begin;
+}
+
+void Tokenizer::SkipUntil(uint16_t char_classes) {
+  const char* begin = input_.data();
+  const char* end = begin + input_.size();
+  const char* p = begin + cur_;
+  while (p != end && !IsClass(*p, char_classes))
+    ++p;
+  cur_ = p - begin;
+}
+
 Location Tokenizer::GetCurrentLocation() const {
-  return Location(input_file_, line_number_, column_number_);
+  return Location(input_file_, line_number_,
+                  static_cast<int>(cur_ - line_begin_) + 1);
 }
 
 Err Tokenizer::GetErrorForInvalidToken(const Location& location) const {
@@ -6,6 +6,7 @@
 #define TOOLS_GN_TOKENIZER_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <string_view>
 #include <vector>
@@ -71,13 +72,24 @@ class Tokenizer {
 
   bool IsCurrentWhitespace() const;
   bool IsCurrentNewline() const;
-  bool IsCurrentStringTerminator(char quote_char) const;
 
   bool CanIncrement() const { return cur_ < input_.size() - 1; }
 
   // Increments the current location by one.
   void Advance();
 
+  // Moves the current location past the characters that belong, or don't
+  // belong, to one of the given character classes (see tokenizer.cc). Neither
+  // can be used to skip newlines.
+  void SkipWhile(uint16_t char_classes);
+  void SkipUntil(uint16_t char_classes);
+
+  // Records that a line starts at the given offset.
+  void StartNewLine(size_t offset) {
+    line_number_++;
+    line_begin_ = offset;
+  }
+
   // Returns the current character in the file as a location.
   Location GetCurrentLocation() const;
 
@@ -95,11 +107,16 @@ class Tokenizer {
   const InputFile* input_file_;
   const std::string_view input_;
   Err* err_;
-  WhitespaceTransform whitespace_transform_;
+  // Character classes that count as whitespace, which depend on the
+  // WhitespaceTransform.
+  uint16_t whitespace_classes_;
+
   size_t cur_ = 0;  // Byte offset into input buffer.
 
+  // Only the line is tracked while moving forward. The column of a location
+  // is computed from the offset of the beginning of its line.
   int line_number_ = 1;
-  int column_number_ = 1;
+  size_t line_begin_ = 0;
 
   Tokenizer(const Tokenizer&) = delete;
   Tokenizer& operator=(const Tokenizer&) = delete;
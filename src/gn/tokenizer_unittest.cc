@@ -133,6 +133,40 @@ TEST(Tokenizer, Locations) {
   ASSERT_TRUE(results[3].location() == Location(&input, 2, 3));
 }
 
+TEST(Tokenizer, LocationsAfterCommentsAndStrings) {
+  InputFile input(SourceFile("/test"));
+  input.SetContents("a = \"b\\\"c\" # d\n\n  e\r\n f");
+  Err err;
+  std::vector<Token> results = Tokenizer::Tokenize(&input, &err);
+
+  ASSERT_EQ(6u, results.size());
+  EXPECT_EQ("\"b\\\"c\"", results[2].value());
+  ASSERT_TRUE(results[3].location() == Location(&input, 1, 12));
+  ASSERT_TRUE(results[4].location() == Location(&input, 3, 3));
+  ASSERT_TRUE(results[5].location() == Location(&input, 4, 2));
+}
+
+TEST(Tokenizer, StringErrors) {
+  InputFile unterminated(SourceFile("/test"));
+  unterminated.SetContents("a = \"b\\\"");
+  Err err;
+  std::vector<Token> results = Tokenizer::Tokenize(&unterminated, &err);
+  EXPECT_TRUE(results.empty());
+  ASSERT_TRUE(err.has_error());
+  EXPECT_EQ("Unterminated string literal.", err.message());
+
+  // An escaped newline is still a newline.
+  InputFile newline(SourceFile("/test"));
+  newline.SetContents("a = \"b\\\nc\"");
+  err = Err();
+  results = Tokenizer::Tokenize(&newline, &err);
+  EXPECT_TRUE(results.empty());
+  ASSERT_TRUE(err.has_error());
+  EXPECT_EQ("Newline in string constant.", err.message());
+  EXPECT_EQ(1, err.location().line_number());
+  EXPECT_EQ(5, err.location().column_number());
+}
+
 TEST(Tokenizer, ByteOffsetOfNthLine) {
   EXPECT_EQ(0u, Tokenizer::ByteOffsetOfNthLine("foo", 1));
 
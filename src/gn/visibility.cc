@@ -25,36 +25,69 @@ bool Visibility::Set(const SourceDir& current_dir,
                      std::string_view source_root,
                      const Value& value,
                      Err* err) {
-  patterns_.clear();
+  patterns_ = LabelPatternSet();
+  OnPatternsChanged();
 
   if (!value.VerifyTypeIs(Value::LIST, err)) {
     CHECK(err->has_error());
     return false;
   }
 
+  std::vector<LabelPattern> patterns;
   for (const auto& item : value.list_value()) {
-    patterns_.push_back(
+    patterns.push_back(
         LabelPattern::GetPattern(current_dir, source_root, item, err));
     if (err->has_error())
       return false;
   }
+  patterns_ = LabelPatternSet(std::move(patterns));
+  OnPatternsChanged();
   return true;
 }
 
 void Visibility::SetPublic() {
-  patterns_.clear();
-  patterns_.push_back(LabelPattern(LabelPattern::RECURSIVE_DIRECTORY,
-                                   SourceDir(), std::string(), Label()));
+  patterns_ = LabelPatternSet({LabelPattern(LabelPattern::RECURSIVE_DIRECTORY,
+                                            SourceDir(), std::string(),
+                                            Label())});
+  OnPatternsChanged();
 }
 
 void Visibility::SetPrivate(const SourceDir& current_dir) {
-  patterns_.clear();
-  patterns_.push_back(LabelPattern(LabelPattern::DIRECTORY, current_dir,
-                                   std::string(), Label()));
+  patterns_ = LabelPatternSet({LabelPattern(
+      LabelPattern::DIRECTORY, current_dir, std::string(), Label())});
+  OnPatternsChanged();
 }
 
 bool Visibility::CanSeeMe(const Label& label) const {
-  return LabelPattern::VectorMatches(patterns_, label);
+  if (is_public_)
+    return true;
+  if (!dir_cache_)
+    return patterns_.Matches(label);
+
+  std::lock_guard<std::mutex> lock(dir_cache_->lock);
+  auto found = dir_cache_->can_see.find(label.dir());
+  if (found == dir_cache_->can_see.end())
+    found = dir_cache_->can_see.emplace(label.dir(), patterns_.Matches(label))
+                .first;
+  return found->second;
+}
+
+void Visibility::OnPatternsChanged() {
+  is_public_ = false;
+  bool dir_only = true;
+  for (const LabelPattern& pattern : patterns_.patterns()) {
+    if (!pattern.toolchain().is_null() || pattern.type() == LabelPattern::MATCH)
+      dir_only = false;
+    else if (pattern.type() == LabelPattern::RECURSIVE_DIRECTORY &&
+             pattern.dir().value().empty())
+      is_public_ = true;
+  }
+
+  // Matching a single pattern is cheaper than a lookup.
+  if (!is_public_ && dir_only && patterns_.patterns().size() > 1)
+    dir_cache_ = std::make_unique<DirCache>();
+  else
+    dir_cache_.reset();
 }
 
 std::string Visibility::Describe(int indent, bool include_brackets) const {
@@ -72,7 +105,7 @@ std::string Visibility::Describe(int indent, bool include_brackets) const {
     inner_indent_string += "  ";
   }
 
-  for (const auto& pattern : patterns_)
+  for (const auto& pattern : patterns_.patterns())
     result += inner_indent_string + pattern.Describe() + "\n";
 
   if (include_brackets)
@@ -82,7 +115,7 @@ std::string Visibility::Describe(int indent, bool include_brackets) const {
 
 std::unique_ptr<base::Value> Visibility::AsValue() const {
   auto res = std::make_unique<base::ListValue>();
-  for (const auto& pattern : patterns_)
+  for (const auto& pattern : patterns_.patterns())
     res->AppendString(pattern.Describe());
   return res;
 }
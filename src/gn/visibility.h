@@ -6,10 +6,12 @@
 #define TOOLS_GN_VISIBILITY_H_
 
 #include <memory>
+#include <mutex>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
-#include "gn/label_pattern.h"
+#include "gn/label_pattern_set.h"
 #include "gn/source_dir.h"
 
 namespace base {
@@ -43,6 +45,10 @@ class Visibility {
 
   // Returns true if the target with the given label can depend on one with the
   // current visibility.
+  //
+  // Public visibility is answered without matching. Visibility lists which
+  // only match directories are answered once per directory of the label,
+  // since most of the dependents of an item are in a few directories.
   bool CanSeeMe(const Label& label) const;
 
   // Returns a string listing the visibility. |indent| number of spaces will
@@ -63,7 +69,23 @@ class Visibility {
   static bool FillItemVisibility(Item* item, Scope* scope, Err* err);
 
  private:
-  std::vector<LabelPattern> patterns_;
+  // The results of CanSeeMe() by directory of the label.
+  struct DirCache {
+    std::mutex lock;
+    std::unordered_map<SourceDir, bool> can_see;
+  };
+
+  // Updates is_public_ and dir_cache_ for the current patterns.
+  void OnPatternsChanged();
+
+  LabelPatternSet patterns_;
+
+  // Set when the patterns match every label.
+  bool is_public_ = false;
+
+  // Non-null when the result only depends on the directory of the label and
+  // is worth caching.
+  std::unique_ptr<DirCache> dir_cache_;
 
   Visibility(const Visibility&) = delete;
   Visibility& operator=(const Visibility&) = delete;
@@ -31,6 +31,30 @@ TEST(Visibility, CanSeeMe) {
   EXPECT_FALSE(vis.CanSeeMe(Label(SourceDir("//directory/"), "anything")));
 }
 
+TEST(Visibility, DirectoryOnly) {
+  Value list(nullptr, Value::LIST);
+  list.list_value().push_back(Value(nullptr, "//rec/*"));
+  list.list_value().push_back(Value(nullptr, "//dir:*"));
+
+  Err err;
+  Visibility vis;
+  ASSERT_TRUE(vis.Set(SourceDir("//"), std::string_view(), list, &err));
+
+  // The second label of each directory uses the result of the first one.
+  for (int i = 0; i < 2; i++) {
+    EXPECT_TRUE(vis.CanSeeMe(Label(SourceDir("//rec/a/"), "a")));
+    EXPECT_TRUE(vis.CanSeeMe(Label(SourceDir("//dir/"), "b")));
+    EXPECT_FALSE(vis.CanSeeMe(Label(SourceDir("//other/"), "c")));
+  }
+
+  // Setting the visibility again forgets the results.
+  list.list_value().push_back(Value(nullptr, "//other:*"));
+  ASSERT_TRUE(vis.Set(SourceDir("//"), std::string_view(), list, &err));
+  EXPECT_TRUE(vis.CanSeeMe(Label(SourceDir("//other/"), "c")));
+  vis.SetPrivate(SourceDir("//rec/"));
+  EXPECT_FALSE(vis.CanSeeMe(Label(SourceDir("//rec/a/"), "a")));
+}
+
 TEST(Visibility, Public) {
   Err err;
   Visibility vis;
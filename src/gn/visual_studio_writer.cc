@@ -30,6 +30,7 @@
 #include "gn/variables.h"
 #include "gn/visual_studio_utils.h"
 #include "gn/xml_element_writer.h"
+#include "util/worker_pool.h"
 
 #if defined(OS_WIN)
 #include "base/win/registry.h"
@@ -95,6 +96,9 @@ const char kGuidSeedFilter[] = "filter";
 
 const char kConfigurationName[] = "GN";
 
+// Number of targets whose project files are written by each task.
+constexpr size_t kTargetsPerChunk = 16;
+
 const char kCharSetUnicode[] = "_UNICODE";
 const char kCharSetMultiByte[] = "_MBCS";
 
@@ -158,24 +162,18 @@ void ParseCompilerOptions(const std::vector<std::string>& cflags,
     ParseCompilerOption(flag, options);
 }
 
-void ParseCompilerOptions(const Target* target, CompilerOptions* options) {
-  for (ConfigValuesIterator iter(target); !iter.done(); iter.Next()) {
-    ParseCompilerOptions(iter.cur().cflags(), options);
-    ParseCompilerOptions(iter.cur().cflags_c(), options);
-    ParseCompilerOptions(iter.cur().cflags_cc(), options);
-  }
-}
-
 void ParseLinkerOptions(const std::vector<std::string>& ldflags,
                         LinkerOptions* options) {
   for (const std::string& flag : ldflags)
     ParseLinkerOption(flag, options);
 }
 
-void ParseLinkerOptions(const Target* target, LinkerOptions* options) {
-  for (ConfigValuesIterator iter(target); !iter.done(); iter.Next()) {
-    ParseLinkerOptions(iter.cur().ldflags(), options);
-  }
+// Adds |flags| to |flag_lists| unless it is empty, since empty lists don't
+// change the parsed options.
+void AddFlagList(const std::vector<std::string>& flags,
+                 std::vector<const std::vector<std::string>*>* flag_lists) {
+  if (!flags.empty())
+    flag_lists->push_back(&flags);
 }
 
 // Returns a string piece pointing into the input string identifying the parent
@@ -363,6 +361,7 @@ bool VisualStudioWriter::RunAndWriteFiles(const BuildSettings* build_settings,
   writer.projects_.reserve(targets.size());
   writer.folders_.reserve(targets.size());
 
+  std::vector<const Target*> project_targets;
   for (const Target* target : targets) {
     // Skip actions and bundle targets.
     if (target->output_type() == Target::ACTION ||
@@ -373,10 +372,32 @@ bool VisualStudioWriter::RunAndWriteFiles(const BuildSettings* build_settings,
         target->output_type() == Target::GENERATED_FILE) {
       continue;
     }
+    project_targets.push_back(target);
+  }
+
+  // The project files of each target are independent, so they are written in
+  // parallel. The first error in the order of the targets is reported.
+  std::vector<std::unique_ptr<SolutionProject>> projects(
+      project_targets.size());
+  std::vector<Err> errors(project_targets.size());
+  const size_t chunk_count =
+      (project_targets.size() + kTargetsPerChunk - 1) / kTargetsPerChunk;
+  WorkerPool::GetShared().ParallelFor(chunk_count, [&](size_t chunk) {
+    const size_t begin = chunk * kTargetsPerChunk;
+    const size_t end =
+        std::min(begin + kTargetsPerChunk, project_targets.size());
+    for (size_t i = begin; i < end; i++) {
+      writer.WriteProjectFiles(project_targets[i], ninja_extra_args,
+                               ninja_executable, &projects[i], &errors[i]);
+    }
+  });
 
-    if (!writer.WriteProjectFiles(target, ninja_extra_args, ninja_executable,
-                                  err))
+  for (size_t i = 0; i < project_targets.size(); i++) {
+    if (errors[i].has_error()) {
+      *err = errors[i];
       return false;
+    }
+    writer.projects_.push_back(std::move(projects[i]));
   }
 
   if (writer.projects_.empty()) {
@@ -396,10 +417,12 @@ bool VisualStudioWriter::RunAndWriteFiles(const BuildSettings* build_settings,
   return writer.WriteSolutionFile(sln_name, err);
 }
 
-bool VisualStudioWriter::WriteProjectFiles(const Target* target,
-                                           const std::string& ninja_extra_args,
-                                           const std::string& ninja_executable,
-                                           Err* err) {
+bool VisualStudioWriter::WriteProjectFiles(
+    const Target* target,
+    const std::string& ninja_extra_args,
+    const std::string& ninja_executable,
+    std::unique_ptr<SolutionProject>* project,
+    Err* err) {
   std::string project_name = target->label().name();
   const char* project_config_platform = config_platform_;
   if (!target->settings()->is_default()) {
@@ -421,21 +444,21 @@ bool VisualStudioWriter::WriteProjectFiles(const Target* target,
   base::FilePath vcxproj_path = build_settings_->GetFullPath(target_file);
   std::string vcxproj_path_str = FilePathToUTF8(vcxproj_path);
 
-  projects_.push_back(std::make_unique<SolutionProject>(
+  auto solution_project = std::make_unique<SolutionProject>(
       project_name, vcxproj_path_str,
       MakeGuid(vcxproj_path_str, kGuidSeedProject),
       FilePathToUTF8(build_settings_->GetFullPath(target->label().dir())),
-      project_config_platform));
+      project_config_platform);
 
   StringOutputBuffer vcxproj_storage;
   std::ostream vcxproj_string_out(&vcxproj_storage);
   SourceFileCompileTypePairs source_types;
-  if (!WriteProjectFileContents(vcxproj_string_out, *projects_.back(), target,
+  if (!WriteProjectFileContents(vcxproj_string_out, *solution_project, target,
                                 ninja_extra_args, ninja_executable,
                                 &source_types, err)) {
-    projects_.pop_back();
     return false;
   }
+  *project = std::move(solution_project);
 
   // Only write the content to the file if it's different. That is
   // both a performance optimization and more importantly, prevents
@@ -571,8 +594,7 @@ bool VisualStudioWriter::WriteProjectFileContents(
                            "$(VSInstallDir)\\VC\\atlmfc\\include;" +
                            "%(AdditionalIncludeDirectories)");
       }
-      CompilerOptions options;
-      ParseCompilerOptions(target, &options);
+      const CompilerOptions& options = GetCompilerOptions(target);
       if (!options.additional_options.empty()) {
         cl_compile->SubElement("AdditionalOptions")
             ->Text(options.additional_options + "%(AdditionalOptions)");
@@ -619,8 +641,7 @@ bool VisualStudioWriter::WriteProjectFileContents(
     std::unique_ptr<XmlElementWriter> link =
         item_definitions->SubElement("Link");
     {
-      LinkerOptions options;
-      ParseLinkerOptions(target, &options);
+      const LinkerOptions& options = GetLinkerOptions(target);
       if (!options.subsystem.empty())
         link->SubElement("SubSystem")->Text(options.subsystem);
     }
@@ -875,15 +896,19 @@ void VisualStudioWriter::ResolveSolutionFolders() {
     }
   }
 
-  // Create also all parent folders up to |root_folder_path_|.
+  // Create also all parent folders up to |root_folder_path_|. Walking up from
+  // a folder stops at the first folder whose parents have already been
+  // created, so that each folder is walked through only once.
   SolutionFolders additional_folders;
+  std::set<const SolutionEntry*> walked_folders;
   for (const std::unique_ptr<SolutionEntry>& solution_folder : folders_) {
     if (solution_folder->path == root_folder_path_)
       continue;
 
     SolutionEntry* folder = solution_folder.get();
     std::string_view parent_path;
-    while ((parent_path = FindParentDir(&folder->path)) != root_folder_path_) {
+    while (walked_folders.insert(folder).second &&
+           (parent_path = FindParentDir(&folder->path)) != root_folder_path_) {
       auto it = processed_paths.find(parent_path);
       if (it != processed_paths.end()) {
         folder = it->second;
@@ -945,3 +970,36 @@ std::pair<std::string, bool> VisualStudioWriter::GetNinjaTarget(
     s = s.substr(2);
   return std::make_pair(s, is_phony);
 }
+
+const CompilerOptions& VisualStudioWriter::GetCompilerOptions(
+    const Target* target) {
+  FlagLists flag_lists;
+  for (ConfigValuesIterator iter(target); !iter.done(); iter.Next()) {
+    AddFlagList(iter.cur().cflags(), &flag_lists);
+    AddFlagList(iter.cur().cflags_c(), &flag_lists);
+    AddFlagList(iter.cur().cflags_cc(), &flag_lists);
+  }
+
+  std::lock_guard<std::mutex> lock(parsed_options_lock_);
+  auto [iter, inserted] = compiler_options_.try_emplace(std::move(flag_lists));
+  if (inserted) {
+    for (const std::vector<std::string>* flags : iter->first)
+      ParseCompilerOptions(*flags, &iter->second);
+  }
+  return iter->second;
+}
+
+const LinkerOptions& VisualStudioWriter::GetLinkerOptions(
+    const Target* target) {
+  FlagLists flag_lists;
+  for (ConfigValuesIterator iter(target); !iter.done(); iter.Next())
+    AddFlagList(iter.cur().ldflags(), &flag_lists);
+
+  std::lock_guard<std::mutex> lock(parsed_options_lock_);
+  auto [iter, inserted] = linker_options_.try_emplace(std::move(flag_lists));
+  if (inserted) {
+    for (const std::vector<std::string>* flags : iter->first)
+      ParseLinkerOptions(*flags, &iter->second);
+  }
+  return iter->second;
+}
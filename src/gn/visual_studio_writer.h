@@ -6,12 +6,15 @@
 #define TOOLS_GN_VISUAL_STUDIO_WRITER_H_
 
 #include <iosfwd>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "base/gtest_prod_util.h"
 #include "gn/path_output.h"
+#include "gn/visual_studio_utils.h"
 
 namespace base {
 class FilePath;
@@ -57,6 +60,7 @@ class VisualStudioWriter {
                            ResolveSolutionFolders_AbsPath);
   FRIEND_TEST_ALL_PREFIXES(VisualStudioWriterTest, NoDotSlash);
   FRIEND_TEST_ALL_PREFIXES(VisualStudioWriterTest, NinjaExecutable);
+  FRIEND_TEST_ALL_PREFIXES(VisualStudioWriterTest, ParsedOptionsCache);
 
   // Solution project or folder.
   struct SolutionEntry {
@@ -103,15 +107,21 @@ class VisualStudioWriter {
   using SolutionFolders = std::vector<std::unique_ptr<SolutionEntry>>;
   using SourceFileCompileTypePairs = std::vector<SourceFileCompileTypePair>;
 
+  // The non-empty lists of flags of a target, in the order they apply.
+  using FlagLists = std::vector<const std::vector<std::string>*>;
+
   VisualStudioWriter(const BuildSettings* build_settings,
                      const char* config_platform,
                      Version version,
                      const std::string& win_kit);
   ~VisualStudioWriter();
 
+  // Writes the project files of |target| and sets |project| to its solution
+  // project. Can be called for different targets in parallel.
   bool WriteProjectFiles(const Target* target,
                          const std::string& ninja_extra_args,
                          const std::string& ninja_executable,
+                         std::unique_ptr<SolutionProject>* project,
                          Err* err);
   bool WriteProjectFileContents(std::ostream& out,
                                 const SolutionProject& solution_project,
@@ -134,6 +144,12 @@ class VisualStudioWriter {
   // Returns the ninja target string and whether the target is phony.
   std::pair<std::string, bool> GetNinjaTarget(const Target* target);
 
+  // Returns the options parsed from the cflags or ldflags of |target|. Most
+  // targets get their flags from the same configs, so the options are parsed
+  // once per distinct FlagLists.
+  const CompilerOptions& GetCompilerOptions(const Target* target);
+  const LinkerOptions& GetLinkerOptions(const Target* target);
+
   const BuildSettings* build_settings_;
 
   // Toolset version.
@@ -167,6 +183,13 @@ class VisualStudioWriter {
   // Windows 10 SDK version string (e.g. 10.0.14393.0)
   std::string windows_sdk_version_;
 
+  // Options parsed by GetCompilerOptions() and GetLinkerOptions(). The flags
+  // they are parsed from are owned by the targets and configs, which outlive
+  // the writer.
+  std::mutex parsed_options_lock_;
+  std::map<FlagLists, CompilerOptions> compiler_options_;
+  std::map<FlagLists, LinkerOptions> linker_options_;
+
   VisualStudioWriter(const VisualStudioWriter&) = delete;
   VisualStudioWriter& operator=(const VisualStudioWriter&) = delete;
 };
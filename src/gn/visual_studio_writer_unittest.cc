@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "base/strings/string_util.h"
+#include "gn/config.h"
 #include "gn/test_with_scope.h"
 #include "gn/visual_studio_utils.h"
 #include "util/test/test.h"
@@ -244,3 +245,48 @@ TEST_F(VisualStudioWriterTest, NinjaExecutable) {
   ASSERT_NE(file_contents_with_flag.str().find("call ninja_wrapper.exe"),
             std::string::npos);
 }
+
+TEST_F(VisualStudioWriterTest, ParsedOptionsCache) {
+  VisualStudioWriter writer(setup_.build_settings(), "Win32",
+                            VisualStudioWriter::Version::Vs2015,
+                            "10.0.17134.0");
+  Err err;
+
+  Config config(setup_.settings(), Label(SourceDir("//foo/"), "config"));
+  config.visibility().SetPublic();
+  config.own_values().cflags().push_back("/O2");
+  config.own_values().ldflags().push_back("/SUBSYSTEM:CONSOLE");
+  ASSERT_TRUE(config.OnResolved(&err));
+
+  // Two targets with the same configs share their parsed options.
+  TestTarget a(setup_, "//foo:a", Target::EXECUTABLE);
+  a.configs().push_back(LabelConfigPair(&config));
+  ASSERT_TRUE(a.OnResolved(&err));
+
+  TestTarget b(setup_, "//foo:b", Target::EXECUTABLE);
+  b.configs().push_back(LabelConfigPair(&config));
+  ASSERT_TRUE(b.OnResolved(&err));
+
+  // A target with flags of its own doesn't.
+  TestTarget c(setup_, "//foo:c", Target::EXECUTABLE);
+  c.config_values().cflags().push_back("/WX");
+  c.configs().push_back(LabelConfigPair(&config));
+  ASSERT_TRUE(c.OnResolved(&err));
+
+  const CompilerOptions& a_options = writer.GetCompilerOptions(&a);
+  EXPECT_EQ("MaxSpeed", a_options.optimization);
+  EXPECT_EQ("", a_options.treat_warning_as_error);
+  EXPECT_EQ(&a_options, &writer.GetCompilerOptions(&b));
+
+  const CompilerOptions& c_options = writer.GetCompilerOptions(&c);
+  EXPECT_NE(&a_options, &c_options);
+  EXPECT_EQ("MaxSpeed", c_options.optimization);
+  EXPECT_EQ("true", c_options.treat_warning_as_error);
+  EXPECT_EQ(2u, writer.compiler_options_.size());
+
+  const LinkerOptions& a_linker_options = writer.GetLinkerOptions(&a);
+  EXPECT_EQ("CONSOLE", a_linker_options.subsystem);
+  EXPECT_EQ(&a_linker_options, &writer.GetLinkerOptions(&b));
+  EXPECT_EQ(&a_linker_options, &writer.GetLinkerOptions(&c));
+  EXPECT_EQ(1u, writer.linker_options_.size());
+}
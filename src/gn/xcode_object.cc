@@ -4,15 +4,19 @@
 
 #include "gn/xcode_object.h"
 
-#include <iomanip>
+#include <algorithm>
 #include <iterator>
 #include <memory>
 #include <sstream>
+#include <string_view>
 #include <utility>
 
 #include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "gn/filesystem_utils.h"
+#include "gn/string_output_buffer.h"
 
 // Helper methods -------------------------------------------------------------
 
@@ -34,10 +38,10 @@ bool CharNeedEscaping(char c) {
   return true;
 }
 
-bool StringNeedEscaping(const std::string& string) {
+bool StringNeedEscaping(std::string_view string) {
   if (string.empty())
     return true;
-  if (string.find("___") != std::string::npos)
+  if (string.find("___") != std::string_view::npos)
     return true;
 
   for (char c : string) {
@@ -47,47 +51,53 @@ bool StringNeedEscaping(const std::string& string) {
   return false;
 }
 
-std::string EncodeString(const std::string& string) {
-  if (!StringNeedEscaping(string))
-    return string;
+void PrintIndent(StringOutputBuffer& out, unsigned level) {
+  for (unsigned i = 0; i < level; i++)
+    out.Append('\t');
+}
 
-  std::stringstream buffer;
-  buffer << '"';
+void PrintEncodedString(StringOutputBuffer& out, std::string_view string) {
+  if (!StringNeedEscaping(string)) {
+    out << string;
+    return;
+  }
+
+  out.Append('"');
   for (char c : string) {
     if (c <= 31) {
       switch (c) {
         case '\a':
-          buffer << "\\a";
+          out << "\\a";
           break;
         case '\b':
-          buffer << "\\b";
+          out << "\\b";
           break;
         case '\t':
-          buffer << "\\t";
+          out << "\\t";
           break;
         case '\n':
         case '\r':
-          buffer << "\\n";
+          out << "\\n";
           break;
         case '\v':
-          buffer << "\\v";
+          out << "\\v";
           break;
         case '\f':
-          buffer << "\\f";
+          out << "\\f";
           break;
         default:
-          buffer << std::hex << std::setw(4) << std::left << "\\U"
-                 << static_cast<unsigned>(c);
+          // "\U" left-aligned in a field of 4 characters, as written by the
+          // std::ostream formatting used previously.
+          out << base::StringPrintf("\\U  %x", static_cast<unsigned>(c));
           break;
       }
     } else {
       if (c == '"' || c == '\\')
-        buffer << '\\';
-      buffer << c;
+        out.Append('\\');
+      out.Append(c);
     }
   }
-  buffer << '"';
-  return buffer.str();
+  out.Append('"');
 }
 
 struct SourceTypeForExt {
@@ -171,63 +181,67 @@ struct NoReference {
   explicit NoReference(const PBXObject* value) : value(value) {}
 };
 
-void PrintValue(std::ostream& out, IndentRules rules, unsigned value) {
-  out << value;
+void PrintValue(StringOutputBuffer& out, IndentRules rules, unsigned value) {
+  out << base::NumberToString(value);
 }
 
-void PrintValue(std::ostream& out, IndentRules rules, const char* value) {
-  out << EncodeString(value);
+void PrintValue(StringOutputBuffer& out, IndentRules rules, const char* value) {
+  PrintEncodedString(out, value);
 }
 
-void PrintValue(std::ostream& out,
+void PrintValue(StringOutputBuffer& out,
                 IndentRules rules,
                 const std::string& value) {
-  out << EncodeString(value);
+  PrintEncodedString(out, value);
 }
 
-void PrintValue(std::ostream& out, IndentRules rules, const NoReference& obj) {
+void PrintValue(StringOutputBuffer& out,
+                IndentRules rules,
+                const NoReference& obj) {
   out << obj.value->id();
 }
 
-void PrintValue(std::ostream& out, IndentRules rules, const PBXObject* value) {
+void PrintValue(StringOutputBuffer& out,
+                IndentRules rules,
+                const PBXObject* value) {
   out << value->Reference();
 }
 
 template <typename ObjectClass>
-void PrintValue(std::ostream& out,
+void PrintValue(StringOutputBuffer& out,
                 IndentRules rules,
                 const std::unique_ptr<ObjectClass>& value) {
   PrintValue(out, rules, value.get());
 }
 
 template <typename ValueType>
-void PrintValue(std::ostream& out,
+void PrintValue(StringOutputBuffer& out,
                 IndentRules rules,
                 const std::vector<ValueType>& values) {
   IndentRules sub_rule{rules.one_line, rules.level + 1};
   out << "(" << (rules.one_line ? " " : "\n");
   for (const auto& value : values) {
     if (!sub_rule.one_line)
-      out << std::string(sub_rule.level, '\t');
+      PrintIndent(out, sub_rule.level);
 
     PrintValue(out, sub_rule, value);
     out << "," << (rules.one_line ? " " : "\n");
   }
 
   if (!rules.one_line && rules.level)
-    out << std::string(rules.level, '\t');
+    PrintIndent(out, rules.level);
   out << ")";
 }
 
 template <typename ValueType>
-void PrintValue(std::ostream& out,
+void PrintValue(StringOutputBuffer& out,
                 IndentRules rules,
                 const std::map<std::string, ValueType>& values) {
   IndentRules sub_rule{rules.one_line, rules.level + 1};
   out << "{" << (rules.one_line ? " " : "\n");
   for (const auto& pair : values) {
     if (!sub_rule.one_line)
-      out << std::string(sub_rule.level, '\t');
+      PrintIndent(out, sub_rule.level);
 
     out << pair.first << " = ";
     PrintValue(out, sub_rule, pair.second);
@@ -235,17 +249,17 @@ void PrintValue(std::ostream& out,
   }
 
   if (!rules.one_line && rules.level)
-    out << std::string(rules.level, '\t');
+    PrintIndent(out, rules.level);
   out << "}";
 }
 
 template <typename ValueType>
-void PrintProperty(std::ostream& out,
+void PrintProperty(StringOutputBuffer& out,
                    IndentRules rules,
                    const char* name,
                    ValueType&& value) {
   if (!rules.one_line && rules.level)
-    out << std::string(rules.level, '\t');
+    PrintIndent(out, rules.level);
 
   out << name << " = ";
   PrintValue(out, rules, std::forward<ValueType>(value));
@@ -277,6 +291,24 @@ struct PBXGroupComparator {
     return static_cast<PBXGroup*>(ptr.get())->SortLast();
   }
 };
+
+// Returns the first of |children|, sorted with PBXGroupComparator, that does
+// not sort before an object of class |cls| named |name| (which doesn't sort
+// last). This allows finding children by binary search.
+std::vector<std::unique_ptr<PBXObject>>::const_iterator LowerBoundChild(
+    const std::vector<std::unique_ptr<PBXObject>>& children,
+    PBXObjectClass cls,
+    std::string_view name) {
+  return std::lower_bound(
+      children.begin(), children.end(), name,
+      [cls](const std::unique_ptr<PBXObject>& child, std::string_view name) {
+        if (PBXGroupComparator().SortLast(child))
+          return false;
+        if (child->Class() != cls)
+          return cls < child->Class();
+        return child->Name() < name;
+      });
+}
 }  // namespace
 
 // PBXObjectClass -------------------------------------------------------------
@@ -443,7 +475,7 @@ PBXObjectClass PBXAggregateTarget::Class() const {
   return PBXAggregateTargetClass;
 }
 
-void PBXAggregateTarget::Print(std::ostream& out, unsigned indent) const {
+void PBXAggregateTarget::Print(StringOutputBuffer& out, unsigned indent) const {
   const std::string indent_str(indent, '\t');
   const IndentRules rules = {false, indent + 1};
   out << indent_str << Reference() << " = {\n";
@@ -475,7 +507,7 @@ std::string PBXBuildFile::Name() const {
   return file_reference_->Name() + " in " + build_phase_->Name();
 }
 
-void PBXBuildFile::Print(std::ostream& out, unsigned indent) const {
+void PBXBuildFile::Print(StringOutputBuffer& out, unsigned indent) const {
   const std::string indent_str(indent, '\t');
   const IndentRules rules = {true, 0};
   out << indent_str << Reference() << " = {";
@@ -499,7 +531,8 @@ std::string PBXContainerItemProxy::Name() const {
   return "PBXContainerItemProxy";
 }
 
-void PBXContainerItemProxy::Print(std::ostream& out, unsigned indent) const {
+void PBXContainerItemProxy::Print(StringOutputBuffer& out,
+                                  unsigned indent) const {
   const std::string indent_str(indent, '\t');
   const IndentRules rules = {false, indent + 1};
   out << indent_str << Reference() << " = {\n";
@@ -532,7 +565,7 @@ std::string PBXFileReference::Comment() const {
   return !name_.empty() ? name_ : path_;
 }
 
-void PBXFileReference::Print(std::ostream& out, unsigned indent) const {
+void PBXFileReference::Print(StringOutputBuffer& out, unsigned indent) const {
   const std::string indent_str(indent, '\t');
   const IndentRules rules = {true, 0};
   out << indent_str << Reference() << " = {";
@@ -572,7 +605,8 @@ std::string PBXFrameworksBuildPhase::Name() const {
   return "Frameworks";
 }
 
-void PBXFrameworksBuildPhase::Print(std::ostream& out, unsigned indent) const {
+void PBXFrameworksBuildPhase::Print(StringOutputBuffer& out,
+                                    unsigned indent) const {
   const std::string indent_str(indent, '\t');
   const IndentRules rules = {false, indent + 1};
   out << indent_str << Reference() << " = {\n";
@@ -598,16 +632,18 @@ PBXFileReference* PBXGroup::AddSourceFile(const std::string& navigator_path,
   std::string::size_type sep = navigator_path.find("/");
   if (sep == std::string::npos) {
     // Prevent same file reference being created and added multiple times.
-    for (const auto& child : children_) {
-      if (child->Class() != PBXFileReferenceClass)
-        continue;
+    for (auto iter =
+             LowerBoundChild(children_, PBXFileReferenceClass, navigator_path);
+         iter != children_.end(); ++iter) {
+      const auto& child = *iter;
+      if (child->Class() != PBXFileReferenceClass ||
+          child->Name() != navigator_path)
+        break;
 
       PBXFileReference* child_as_file_reference =
           static_cast<PBXFileReference*>(child.get());
-      if (child_as_file_reference->Name() == navigator_path &&
-          child_as_file_reference->path() == navigator_path) {
+      if (child_as_file_reference->path() == navigator_path)
         return child_as_file_reference;
-      }
     }
 
     return CreateChild<PBXFileReference>(navigator_path, navigator_path,
@@ -616,9 +652,11 @@ PBXFileReference* PBXGroup::AddSourceFile(const std::string& navigator_path,
 
   PBXGroup* group = nullptr;
   std::string_view component(navigator_path.data(), sep);
-  for (const auto& child : children_) {
-    if (child->Class() != PBXGroupClass)
-      continue;
+  for (auto iter = LowerBoundChild(children_, PBXGroupClass, component);
+       iter != children_.end(); ++iter) {
+    const auto& child = *iter;
+    if (child->Class() != PBXGroupClass || child->Name() != component)
+      break;
 
     PBXGroup* child_as_group = static_cast<PBXGroup*>(child.get());
     if (child_as_group->name_ == component) {
@@ -627,6 +665,21 @@ PBXFileReference* PBXGroup::AddSourceFile(const std::string& navigator_path,
     }
   }
 
+  // The groups sorting last come after the ones searched above.
+  if (!group) {
+    for (auto iter = children_.rbegin(); iter != children_.rend(); ++iter) {
+      const auto& child = *iter;
+      if (!PBXGroupComparator().SortLast(child))
+        break;
+
+      PBXGroup* child_as_group = static_cast<PBXGroup*>(child.get());
+      if (child_as_group->name_ == component) {
+        group = child_as_group;
+        break;
+      }
+    }
+  }
+
   if (!group) {
     group =
         CreateChild<PBXGroup>(std::string(component), std::string(component));
@@ -663,7 +716,7 @@ void PBXGroup::Visit(PBXObjectVisitorConst& visitor) const {
   }
 }
 
-void PBXGroup::Print(std::ostream& out, unsigned indent) const {
+void PBXGroup::Print(StringOutputBuffer& out, unsigned indent) const {
   const std::string indent_str(indent, '\t');
   const IndentRules rules = {false, indent + 1};
   out << indent_str << Reference() << " = {\n";
@@ -755,7 +808,7 @@ PBXObjectClass PBXNativeTarget::Class() const {
   return PBXNativeTargetClass;
 }
 
-void PBXNativeTarget::Print(std::ostream& out, unsigned indent) const {
+void PBXNativeTarget::Print(StringOutputBuffer& out, unsigned indent) const {
   const std::string indent_str(indent, '\t');
   const IndentRules rules = {false, indent + 1};
   out << indent_str << Reference() << " = {\n";
@@ -924,7 +977,7 @@ void PBXProject::Visit(PBXObjectVisitorConst& visitor) const {
     target->Visit(visitor);
   }
 }
-void PBXProject::Print(std::ostream& out, unsigned indent) const {
+void PBXProject::Print(StringOutputBuffer& out, unsigned indent) const {
   const std::string indent_str(indent, '\t');
   const IndentRules rules = {false, indent + 1};
   out << indent_str << Reference() << " = {\n";
@@ -958,7 +1011,8 @@ std::string PBXResourcesBuildPhase::Name() const {
   return "Resources";
 }
 
-void PBXResourcesBuildPhase::Print(std::ostream& out, unsigned indent) const {
+void PBXResourcesBuildPhase::Print(StringOutputBuffer& out,
+                                   unsigned indent) const {
   const std::string indent_str(indent, '\t');
   const IndentRules rules = {false, indent + 1};
   out << indent_str << Reference() << " = {\n";
@@ -987,7 +1041,8 @@ std::string PBXShellScriptBuildPhase::Name() const {
   return name_;
 }
 
-void PBXShellScriptBuildPhase::Print(std::ostream& out, unsigned indent) const {
+void PBXShellScriptBuildPhase::Print(StringOutputBuffer& out,
+                                     unsigned indent) const {
   const std::string indent_str(indent, '\t');
   const IndentRules rules = {false, indent + 1};
   out << indent_str << Reference() << " = {\n";
@@ -1019,7 +1074,8 @@ std::string PBXSourcesBuildPhase::Name() const {
   return "Sources";
 }
 
-void PBXSourcesBuildPhase::Print(std::ostream& out, unsigned indent) const {
+void PBXSourcesBuildPhase::Print(StringOutputBuffer& out,
+                                 unsigned indent) const {
   const std::string indent_str(indent, '\t');
   const IndentRules rules = {false, indent + 1};
   out << indent_str << Reference() << " = {\n";
@@ -1055,7 +1111,8 @@ void PBXTargetDependency::Visit(PBXObjectVisitorConst& visitor) const {
   container_item_proxy_->Visit(visitor);
 }
 
-void PBXTargetDependency::Print(std::ostream& out, unsigned indent) const {
+void PBXTargetDependency::Print(StringOutputBuffer& out,
+                                unsigned indent) const {
   const std::string indent_str(indent, '\t');
   const IndentRules rules = {false, indent + 1};
   out << indent_str << Reference() << " = {\n";
@@ -1081,7 +1138,8 @@ std::string XCBuildConfiguration::Name() const {
   return name_;
 }
 
-void XCBuildConfiguration::Print(std::ostream& out, unsigned indent) const {
+void XCBuildConfiguration::Print(StringOutputBuffer& out,
+                                 unsigned indent) const {
   const std::string indent_str(indent, '\t');
   const IndentRules rules = {false, indent + 1};
   out << indent_str << Reference() << " = {\n";
@@ -1133,7 +1191,8 @@ void XCConfigurationList::Visit(PBXObjectVisitorConst& visitor) const {
   }
 }
 
-void XCConfigurationList::Print(std::ostream& out, unsigned indent) const {
+void XCConfigurationList::Print(StringOutputBuffer& out,
+                                unsigned indent) const {
   const std::string indent_str(indent, '\t');
   const IndentRules rules = {false, indent + 1};
   out << indent_str << Reference() << " = {\n";
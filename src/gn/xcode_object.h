@@ -5,12 +5,13 @@
 #ifndef TOOLS_GN_XCODE_OBJECT_H_
 #define TOOLS_GN_XCODE_OBJECT_H_
 
-#include <iosfwd>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
+class StringOutputBuffer;
+
 // Helper classes to generate Xcode project files.
 //
 // This code is based on gyp xcodeproj_file.py generator. It does not support
@@ -98,7 +99,7 @@ class PBXObject {
   PBXObject();
   virtual ~PBXObject();
 
-  const std::string id() const { return id_; }
+  const std::string& id() const { return id_; }
   void SetId(const std::string& id);
 
   std::string Reference() const;
@@ -108,7 +109,7 @@ class PBXObject {
   virtual std::string Comment() const;
   virtual void Visit(PBXObjectVisitor& visitor);
   virtual void Visit(PBXObjectVisitorConst& visitor) const;
-  virtual void Print(std::ostream& out, unsigned indent) const = 0;
+  virtual void Print(StringOutputBuffer& out, unsigned indent) const = 0;
 
  private:
   std::string id_;
@@ -180,7 +181,7 @@ class PBXAggregateTarget : public PBXTarget {
 
   // PBXObject implementation.
   PBXObjectClass Class() const override;
-  void Print(std::ostream& out, unsigned indent) const override;
+  void Print(StringOutputBuffer& out, unsigned indent) const override;
 
  private:
   PBXAggregateTarget(const PBXAggregateTarget&) = delete;
@@ -198,7 +199,7 @@ class PBXBuildFile : public PBXObject {
   // PBXObject implementation.
   PBXObjectClass Class() const override;
   std::string Name() const override;
-  void Print(std::ostream& out, unsigned indent) const override;
+  void Print(StringOutputBuffer& out, unsigned indent) const override;
 
  private:
   const PBXFileReference* file_reference_ = nullptr;
@@ -217,7 +218,7 @@ class PBXContainerItemProxy : public PBXObject {
   // PBXObject implementation.
   PBXObjectClass Class() const override;
   std::string Name() const override;
-  void Print(std::ostream& out, unsigned indent) const override;
+  void Print(StringOutputBuffer& out, unsigned indent) const override;
 
  private:
   const PBXProject* project_ = nullptr;
@@ -240,7 +241,7 @@ class PBXFileReference : public PBXObject {
   PBXObjectClass Class() const override;
   std::string Name() const override;
   std::string Comment() const override;
-  void Print(std::ostream& out, unsigned indent) const override;
+  void Print(StringOutputBuffer& out, unsigned indent) const override;
 
   const std::string& path() const { return path_; }
 
@@ -263,7 +264,7 @@ class PBXFrameworksBuildPhase : public PBXBuildPhase {
   // PBXObject implementation.
   PBXObjectClass Class() const override;
   std::string Name() const override;
-  void Print(std::ostream& out, unsigned indent) const override;
+  void Print(StringOutputBuffer& out, unsigned indent) const override;
 
  private:
   PBXFrameworksBuildPhase(const PBXFrameworksBuildPhase&) = delete;
@@ -295,7 +296,7 @@ class PBXGroup : public PBXObject {
   std::string Name() const override;
   void Visit(PBXObjectVisitor& visitor) override;
   void Visit(PBXObjectVisitorConst& visitor) const override;
-  void Print(std::ostream& out, unsigned indent) const override;
+  void Print(StringOutputBuffer& out, unsigned indent) const override;
 
   // Returns whether the current PBXGroup should sort last when sorting
   // children of a PBXGroup. This should only be used for the "Products"
@@ -353,7 +354,7 @@ class PBXNativeTarget : public PBXTarget {
 
   // PBXObject implementation.
   PBXObjectClass Class() const override;
-  void Print(std::ostream& out, unsigned indent) const override;
+  void Print(StringOutputBuffer& out, unsigned indent) const override;
 
  private:
   const PBXFileReference* product_reference_ = nullptr;
@@ -402,7 +403,7 @@ class PBXProject : public PBXObject {
   std::string Comment() const override;
   void Visit(PBXObjectVisitor& visitor) override;
   void Visit(PBXObjectVisitorConst& visitor) const override;
-  void Print(std::ostream& out, unsigned indent) const override;
+  void Print(StringOutputBuffer& out, unsigned indent) const override;
 
  private:
   PBXAttributes attributes_;
@@ -431,7 +432,7 @@ class PBXResourcesBuildPhase : public PBXBuildPhase {
   // PBXObject implementation.
   PBXObjectClass Class() const override;
   std::string Name() const override;
-  void Print(std::ostream& out, unsigned indent) const override;
+  void Print(StringOutputBuffer& out, unsigned indent) const override;
 
  private:
   PBXResourcesBuildPhase(const PBXResourcesBuildPhase&) = delete;
@@ -449,7 +450,7 @@ class PBXShellScriptBuildPhase : public PBXBuildPhase {
   // PBXObject implementation.
   PBXObjectClass Class() const override;
   std::string Name() const override;
-  void Print(std::ostream& out, unsigned indent) const override;
+  void Print(StringOutputBuffer& out, unsigned indent) const override;
 
  private:
   std::string name_;
@@ -469,7 +470,7 @@ class PBXSourcesBuildPhase : public PBXBuildPhase {
   // PBXObject implementation.
   PBXObjectClass Class() const override;
   std::string Name() const override;
-  void Print(std::ostream& out, unsigned indent) const override;
+  void Print(StringOutputBuffer& out, unsigned indent) const override;
 
  private:
   PBXSourcesBuildPhase(const PBXSourcesBuildPhase&) = delete;
@@ -489,7 +490,7 @@ class PBXTargetDependency : public PBXObject {
   std::string Name() const override;
   void Visit(PBXObjectVisitor& visitor) override;
   void Visit(PBXObjectVisitorConst& visitor) const override;
-  void Print(std::ostream& out, unsigned indent) const override;
+  void Print(StringOutputBuffer& out, unsigned indent) const override;
 
  private:
   const PBXTarget* target_ = nullptr;
@@ -510,7 +511,7 @@ class XCBuildConfiguration : public PBXObject {
   // PBXObject implementation.
   PBXObjectClass Class() const override;
   std::string Name() const override;
-  void Print(std::ostream& out, unsigned indent) const override;
+  void Print(StringOutputBuffer& out, unsigned indent) const override;
 
  private:
   PBXAttributes attributes_;
@@ -534,7 +535,7 @@ class XCConfigurationList : public PBXObject {
   std::string Name() const override;
   void Visit(PBXObjectVisitor& visitor) override;
   void Visit(PBXObjectVisitorConst& visitor) const override;
-  void Print(std::ostream& out, unsigned indent) const override;
+  void Print(StringOutputBuffer& out, unsigned indent) const override;
 
  private:
   std::vector<std::unique_ptr<XCBuildConfiguration>> configurations_;
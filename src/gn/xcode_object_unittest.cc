@@ -4,6 +4,7 @@
 
 #include "gn/xcode_object.h"
 
+#include "gn/string_output_buffer.h"
 #include "util/test/test.h"
 
 namespace {
@@ -433,3 +434,37 @@ TEST(XcodeObject, XCConfigurationListName) {
   EXPECT_EQ("Build configuration list for PBXNativeTarget \"target_name\"",
             xc_configuration_list->Name());
 }
+
+// Tests that adding a source file twice reuses its PBXFileReference and the
+// PBXGroup of its directory, even with many other children in the groups.
+TEST(XcodeObject, PBXGroupAddSourceFile) {
+  PBXGroup pbx_group(std::string(), "root");
+  PBXFileReference* file =
+      pbx_group.AddSourceFile("dir/file.cc", "dir/file.cc");
+  for (int i = 0; i < 20; i++) {
+    std::string name = "file" + std::to_string(i) + ".cc";
+    pbx_group.AddSourceFile(name, name);
+    pbx_group.AddSourceFile("dir" + std::to_string(i) + "/" + name, name);
+    pbx_group.AddSourceFile("dir/" + name, name);
+  }
+
+  EXPECT_EQ(file, pbx_group.AddSourceFile("dir/file.cc", "dir/file.cc"));
+  EXPECT_EQ(pbx_group.AddSourceFile("file3.cc", "file3.cc"),
+            pbx_group.AddSourceFile("file3.cc", "file3.cc"));
+  EXPECT_NE(file, pbx_group.AddSourceFile("dir/file.h", "dir/file.h"));
+}
+
+TEST(XcodeObject, PBXFileReferencePrint) {
+  PBXFileReference pbx_file_reference("some \"name\"", "dir/a\tb\x01.cc",
+                                      std::string());
+  pbx_file_reference.SetId("0123456789ABCDEF01234567");
+
+  StringOutputBuffer out;
+  pbx_file_reference.Print(out, 2);
+  EXPECT_EQ(
+      "\t\t0123456789ABCDEF01234567 /* some \"name\" */ = {"
+      "isa = PBXFileReference; lastKnownFileType = text; "
+      "name = \"some \\\"name\\\"\"; path = \"dir/a\\tb\\U  1.cc\"; "
+      "sourceTree = \"<group>\"; };\n",
+      out.str());
+}
@@ -4,6 +4,8 @@
 
 #include "gn/xcode_writer.h"
 
+#include <algorithm>
+#include <functional>
 #include <iomanip>
 #include <iterator>
 #include <map>
@@ -40,6 +42,7 @@
 #include "gn/value.h"
 #include "gn/variables.h"
 #include "gn/xcode_object.h"
+#include "util/worker_pool.h"
 
 namespace {
 
@@ -70,6 +73,26 @@ SafeEnvironmentVariableInfo kSafeEnvironmentVariables[] = {
     {"ICECC_VERSION", true},
     {"ICECC_CLANG_REMOTE_CPP", true}};
 
+// Number of targets, source files or PBXObjects processed by each task when
+// generating the project in parallel.
+constexpr size_t kItemsPerChunk = 256;
+
+// Number of chunks of PBXObjects printed before appending them to the output,
+// which bounds the memory used to hold their text.
+constexpr size_t kChunksPerWindow = 64;
+
+// Calls `work` in parallel for consecutive [begin, end) ranges of at most
+// `chunk_size` items covering [0, count).
+void ParallelForChunks(size_t count,
+                       size_t chunk_size,
+                       const std::function<void(size_t, size_t)>& work) {
+  const size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+  WorkerPool::GetShared().ParallelFor(chunk_count, [&](size_t i) {
+    const size_t begin = i * chunk_size;
+    work(begin, std::min(begin + chunk_size, count));
+  });
+}
+
 TargetOsType GetTargetOs(const Args& args) {
   const Value* target_os_value = args.GetArgOverride(variables::kTargetOs);
   if (target_os_value) {
@@ -341,39 +364,87 @@ CollectPBXObjectsPerClass(const PBXProject* project) {
   return visitor.objects_per_class();
 }
 
-// Helper class to assign unique ids to all PBXObject.
-class RecursivelyAssignIdsHelper : public PBXObjectVisitor {
+// Helper class to collect all PBXObject in the order they are visited.
+class CollectPBXObjectsHelper : public PBXObjectVisitor {
  public:
-  RecursivelyAssignIdsHelper(const std::string& seed)
-      : seed_(seed), counter_(0) {}
+  CollectPBXObjectsHelper() = default;
 
   void Visit(PBXObject* object) override {
-    std::stringstream buffer;
-    buffer << seed_ << " " << object->Name() << " " << counter_;
-    std::string hash = base::SHA1HashString(buffer.str());
-    DCHECK_EQ(hash.size() % 4, 0u);
-
-    uint32_t id[3] = {0, 0, 0};
-    const uint32_t* ptr = reinterpret_cast<const uint32_t*>(hash.data());
-    for (size_t i = 0; i < hash.size() / 4; i++)
-      id[i % 3] ^= ptr[i];
-
-    object->SetId(base::HexEncode(id, sizeof(id)));
-    ++counter_;
+    DCHECK(object);
+    objects_.push_back(object);
   }
 
+  const std::vector<PBXObject*>& objects() const { return objects_; }
+
  private:
-  std::string seed_;
-  int64_t counter_;
+  std::vector<PBXObject*> objects_;
 
-  RecursivelyAssignIdsHelper(const RecursivelyAssignIdsHelper&) = delete;
-  RecursivelyAssignIdsHelper& operator=(const RecursivelyAssignIdsHelper&) =
-      delete;
+  CollectPBXObjectsHelper(const CollectPBXObjectsHelper&) = delete;
+  CollectPBXObjectsHelper& operator=(const CollectPBXObjectsHelper&) = delete;
 };
 
+// Returns the id of `object`, visited in position `index` when assigning ids
+// to the objects of the project using `seed`.
+std::string ComputeObjectId(const std::string& seed,
+                            const PBXObject* object,
+                            int64_t index) {
+  std::string hash = base::SHA1HashString(
+      seed + " " + object->Name() + " " + base::NumberToString(index));
+  DCHECK_EQ(hash.size() % 4, 0u);
+
+  uint32_t id[3] = {0, 0, 0};
+  const uint32_t* ptr = reinterpret_cast<const uint32_t*>(hash.data());
+  for (size_t i = 0; i < hash.size() / 4; i++)
+    id[i % 3] ^= ptr[i];
+
+  return base::HexEncode(id, sizeof(id));
+}
+
+// Assigns unique ids to all PBXObject. The id of an object only depends on
+// its name and its position in the visit order, so they are computed in
+// parallel once all the objects have been collected.
 void RecursivelyAssignIds(PBXProject* project) {
-  RecursivelyAssignIdsHelper visitor(project->Name());
+  CollectPBXObjectsHelper visitor;
   project->Visit(visitor);
+
+  const std::string& seed = project->Name();
+  const std::vector<PBXObject*>& objects = visitor.objects();
+  ParallelForChunks(objects.size(), kItemsPerChunk,
+                    [&](size_t begin, size_t end) {
+                      for (size_t i = begin; i < end; i++) {
+                        objects[i]->SetId(ComputeObjectId(
+                            seed, objects[i], static_cast<int64_t>(i)));
+                      }
+                    });
+}
+
+// Prints `objects` to `out`, in order. Printing the objects is done in
+// parallel, by windows of chunks of objects so that the text of at most one
+// window is held in memory in addition to `out`.
+void PrintObjects(const std::vector<const PBXObject*>& objects,
+                  StringOutputBuffer& out) {
+  const size_t chunk_count =
+      (objects.size() + kItemsPerChunk - 1) / kItemsPerChunk;
+  for (size_t window_begin = 0; window_begin < chunk_count;
+       window_begin += kChunksPerWindow) {
+    const size_t window_size =
+        std::min(kChunksPerWindow, chunk_count - window_begin);
+    const size_t first = window_begin * kItemsPerChunk;
+    const size_t count =
+        std::min(window_size * kItemsPerChunk, objects.size() - first);
+
+    std::vector<std::unique_ptr<StringOutputBuffer>> printed(window_size);
+    ParallelForChunks(count, kItemsPerChunk,
+                      [&](size_t begin, size_t end) {
+                        auto buffer = std::make_unique<StringOutputBuffer>();
+                        for (size_t i = begin; i < end; i++)
+                          objects[first + i]->Print(*buffer, 2);
+                        printed[begin / kItemsPerChunk] = std::move(buffer);
+                      });
+
+    for (const auto& buffer : printed)
+      out << buffer->str();
+  }
 }
 
 // Returns a list of configuration names from the options passed to the
@@ -448,6 +519,18 @@ PBXAttributes ProjectAttributesFromBuildSettings(
   return attributes;
 }
 
+// Arguments of PBXProject::AddNativeTarget() for a target. They are computed
+// for all the targets before adding them to the project.
+struct NativeTargetArgs {
+  std::string name;
+  std::string type;
+  std::string output_name;
+  std::string output_type;
+  std::string output_dir;
+  std::string shell_script;
+  PBXAttributes extra_attributes;
+};
+
 // Helper class used to collect the source files that will be added to
 // and PBXProject.
 class WorkspaceSources {
@@ -460,13 +543,23 @@ class WorkspaceSources {
   // for files in an assets catalog, only the catalog itself will be added.
   void AddSourceFile(const SourceFile& source);
 
+  // Records the sources of `target` (including its inputs, public headers,
+  // ...) as part of the project.
+  void AddTargetSources(const Target* target);
+
+  // Records the sources recorded by `other`.
+  void AddSources(const WorkspaceSources& other);
+
   // Insert all the recorded source into `project`.
   void AddToProject(PBXProject& project) const;
 
  private:
   const SourceDir build_dir_;
   const std::string root_dir_;
-  SourceFileSet source_files_;
+
+  // May contain duplicates, which are removed by AddToProject(). This is
+  // cheaper than keeping a set since most sources are listed only once.
+  std::vector<SourceFile> source_files_;
 };
 
 WorkspaceSources::WorkspaceSources(const BuildSettings* build_settings)
@@ -486,23 +579,59 @@ void WorkspaceSources::AddSourceFile(const SourceFile& source) {
 
   SourceFile assets_catalog_dir = BundleData::GetAssetsCatalogDirectory(source);
   if (!assets_catalog_dir.is_null()) {
-    source_files_.insert(assets_catalog_dir);
+    source_files_.push_back(assets_catalog_dir);
   } else {
-    source_files_.insert(source);
+    source_files_.push_back(source);
   }
 }
 
+void WorkspaceSources::AddTargetSources(const Target* target) {
+  for (const SourceFile& source : target->sources()) {
+    AddSourceFile(source);
+  }
+
+  for (const SourceFile& source : target->config_values().inputs()) {
+    AddSourceFile(source);
+  }
+
+  for (const SourceFile& source : target->public_headers()) {
+    AddSourceFile(source);
+  }
+
+  const SourceFile& bridge_header = target->swift_values().bridge_header();
+  if (!bridge_header.is_null()) {
+    AddSourceFile(bridge_header);
+  }
+
+  if (target->output_type() == Target::ACTION ||
+      target->output_type() == Target::ACTION_FOREACH) {
+    AddSourceFile(target->action_values().script());
+  }
+}
+
+void WorkspaceSources::AddSources(const WorkspaceSources& other) {
+  source_files_.insert(source_files_.end(), other.source_files_.begin(),
+                       other.source_files_.end());
+}
+
 void WorkspaceSources::AddToProject(PBXProject& project) const {
   // Sort the files to ensure a deterministic generation of the project file.
-  std::vector<SourceFile> sources(source_files_.begin(), source_files_.end());
+  std::vector<SourceFile> sources(source_files_);
   std::sort(sources.begin(), sources.end());
+  sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
 
   const SourceDir source_dir("//");
-  for (const SourceFile& source : sources) {
-    const std::string source_path =
-        RebasePath(source.value(), source_dir, root_dir_);
+  std::vector<std::string> source_paths(sources.size());
+  ParallelForChunks(sources.size(), kItemsPerChunk,
+                    [&](size_t begin, size_t end) {
+                      for (size_t i = begin; i < end; i++) {
+                        source_paths[i] = RebasePath(sources[i].value(),
+                                                     source_dir, root_dir_);
+                      }
+                    });
+
+  for (const std::string& source_path : source_paths)
     project.AddSourceFileToIndexingTarget(source_path, source_path);
-  }
 }
 
 }  // namespace
@@ -632,15 +761,17 @@ class XcodeProject {
       const Builder& builder,
       Err* err) const;
 
-  // Adds a target of type EXECUTABLE to the project.
-  PBXNativeTarget* AddBinaryTarget(const Target* target,
-                                   base::Environment* env,
-                                   Err* err);
+  // Computes the arguments to add a target of type EXECUTABLE to the project.
+  bool GetBinaryTargetArgs(const Target* target,
+                           base::Environment* env,
+                           NativeTargetArgs* args,
+                           Err* err) const;
 
-  // Adds a target of type CREATE_BUNDLE to the project.
-  PBXNativeTarget* AddBundleTarget(const Target* target,
-                                   base::Environment* env,
-                                   Err* err);
+  // Computes the arguments to add a target of type CREATE_BUNDLE to the
+  // project.
+  void GetBundleTargetArgs(const Target* target,
+                           base::Environment* env,
+                           NativeTargetArgs* args) const;
 
   // Adds the XCTest source files for all test xctest or xcuitest module target
   // to allow Xcode to index the list of tests (thus allowing to run individual
@@ -657,10 +788,10 @@ class XcodeProject {
 
   // Tweak `output_dir` to be relative to the configuration specific output
   // directory (see --xcode-config-build-dir=... flag).
-  std::string GetConfigOutputDir(std::string_view output_dir);
+  std::string GetConfigOutputDir(std::string_view output_dir) const;
 
   // Generates the content of the .xcodeproj file into |out|.
-  void WriteFileContent(std::ostream& out) const;
+  void WriteFileContent(StringOutputBuffer& out) const;
 
   // Returns whether the file should be added to the project.
   bool ShouldIncludeFileInProject(const SourceFile& source) const;
@@ -694,30 +825,23 @@ bool XcodeProject::ShouldIncludeFileInProject(const SourceFile& source) const {
 bool XcodeProject::AddSourcesFromBuilder(const Builder& builder, Err* err) {
   WorkspaceSources sources(build_settings_);
 
-  // Add sources from all targets.
-  for (const Target* target : builder.GetAllResolvedTargets()) {
-    for (const SourceFile& source : target->sources()) {
-      sources.AddSourceFile(source);
-    }
-
-    for (const SourceFile& source : target->config_values().inputs()) {
-      sources.AddSourceFile(source);
-    }
-
-    for (const SourceFile& source : target->public_headers()) {
-      sources.AddSourceFile(source);
-    }
-
-    const SourceFile& bridge_header = target->swift_values().bridge_header();
-    if (!bridge_header.is_null()) {
-      sources.AddSourceFile(bridge_header);
-    }
-
-    if (target->output_type() == Target::ACTION ||
-        target->output_type() == Target::ACTION_FOREACH) {
-      sources.AddSourceFile(target->action_values().script());
-    }
-  }
+  // Add sources from all targets. Each chunk of targets collects its sources
+  // separately, in parallel.
+  const std::vector<const Target*> all_targets =
+      builder.GetAllResolvedTargets();
+  std::vector<std::unique_ptr<WorkspaceSources>> target_sources(
+      (all_targets.size() + kItemsPerChunk - 1) / kItemsPerChunk);
+  ParallelForChunks(all_targets.size(), kItemsPerChunk,
+                    [&](size_t begin, size_t end) {
+                      auto chunk_sources =
+                          std::make_unique<WorkspaceSources>(build_settings_);
+                      for (size_t i = begin; i < end; i++)
+                        chunk_sources->AddTargetSources(all_targets[i]);
+                      target_sources[begin / kItemsPerChunk] =
+                          std::move(chunk_sources);
+                    });
+  for (const auto& chunk_sources : target_sources)
+    sources.AddSources(*chunk_sources);
 
   // Add BUILD.gn and *.gni for targets, configs and toolchains.
   for (const Item* item : builder.GetAllResolvedItems()) {
@@ -781,24 +905,18 @@ bool XcodeProject::AddTargetsFromBuilder(const Builder& builder, Err* err) {
   if (!targets)
     return false;
 
-  std::map<const Target*, PBXNativeTarget*> bundle_targets;
-
   const TargetOsType target_os = GetTargetOs(build_settings_->build_args());
 
+  std::vector<const Target*> native_targets;
   for (const Target* target : *targets) {
-    PBXNativeTarget* native_target = nullptr;
     switch (target->output_type()) {
       case Target::EXECUTABLE:
         if (target_os == WRITER_TARGET_OS_IOS)
           continue;
 
-        native_target = AddBinaryTarget(target, env.get(), err);
-        if (!native_target)
-          return false;
-
         break;
 
-      case Target::CREATE_BUNDLE: {
+      case Target::CREATE_BUNDLE:
         if (target->bundle_data().product_type().empty())
           continue;
 
@@ -808,17 +926,45 @@ bool XcodeProject::AddTargetsFromBuilder(const Builder& builder, Err* err) {
         if (IsXCUITestRunnerTarget(target))
           continue;
 
-        native_target = AddBundleTarget(target, env.get(), err);
-        if (!native_target)
-          return false;
-
-        bundle_targets.insert(std::make_pair(target, native_target));
         break;
-      }
 
       default:
-        break;
+        continue;
     }
+    native_targets.push_back(target);
+  }
+
+  // The arguments of each native target are computed independently, in
+  // parallel, then the targets are added in order.
+  std::vector<NativeTargetArgs> native_target_args(native_targets.size());
+  std::vector<Err> errors(native_targets.size());
+  ParallelForChunks(
+      native_targets.size(), kItemsPerChunk,
+      [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+          const Target* target = native_targets[i];
+          if (target->output_type() == Target::EXECUTABLE) {
+            GetBinaryTargetArgs(target, env.get(), &native_target_args[i],
+                                &errors[i]);
+          } else {
+            GetBundleTargetArgs(target, env.get(), &native_target_args[i]);
+          }
+        }
+      });
+
+  std::map<const Target*, PBXNativeTarget*> bundle_targets;
+  for (size_t i = 0; i < native_targets.size(); i++) {
+    if (errors[i].has_error()) {
+      *err = errors[i];
+      return false;
+    }
+
+    const NativeTargetArgs& args = native_target_args[i];
+    PBXNativeTarget* native_target = project_.AddNativeTarget(
+        args.name, args.type, args.output_name, args.output_type,
+        args.output_dir, args.shell_script, args.extra_attributes);
+    if (native_targets[i]->output_type() == Target::CREATE_BUNDLE)
+      bundle_targets.insert(std::make_pair(native_targets[i], native_target));
   }
 
   if (!AddCXTestSourceFilesForTestModuleTargets(bundle_targets, err))
@@ -917,8 +1063,7 @@ bool XcodeProject::WriteFile(Err* err) const {
     return false;
 
   StringOutputBuffer storage;
-  std::ostream pbxproj_string_out(&storage);
-  WriteFileContent(pbxproj_string_out);
+  WriteFileContent(storage);
 
   if (!storage.WriteToFileIfChanged(build_settings_->GetFullPath(pbxproj_file),
                                     err)) {
@@ -980,9 +1125,10 @@ std::optional<std::vector<const Target*>> XcodeProject::GetTargetsFromBuilder(
   return sorted_targets;
 }
 
-PBXNativeTarget* XcodeProject::AddBinaryTarget(const Target* target,
-                                               base::Environment* env,
-                                               Err* err) {
+bool XcodeProject::GetBinaryTargetArgs(const Target* target,
+                                       base::Environment* env,
+                                       NativeTargetArgs* args,
+                                       Err* err) const {
   DCHECK_EQ(target->output_type(), Target::EXECUTABLE);
 
   std::string output_dir = target->output_dir().value();
@@ -996,7 +1142,7 @@ PBXNativeTarget* XcodeProject::AddBinaryTarget(const Target* target,
                      " used by target " +
                      target->label().GetUserVisibleName(false) +
                      " doesn't define a \"" + tool_name + "\" tool.");
-      return nullptr;
+      return false;
     }
     output_dir = SubstitutionWriter::ApplyPatternToLinkerAsOutputFile(
                      target, tool, tool->default_output_dir())
@@ -1005,18 +1151,21 @@ PBXNativeTarget* XcodeProject::AddBinaryTarget(const Target* target,
     output_dir = RebasePath(output_dir, build_settings_->build_dir());
   }
 
-  return project_.AddNativeTarget(
-      target->label().name(), "compiled.mach-o.executable",
-      target->output_name().empty() ? target->label().name()
-                                    : target->output_name(),
-      "com.apple.product-type.tool", GetConfigOutputDir(output_dir),
+  args->name = target->label().name();
+  args->type = "compiled.mach-o.executable";
+  args->output_name = target->output_name().empty() ? target->label().name()
+                                                    : target->output_name();
+  args->output_type = "com.apple.product-type.tool";
+  args->output_dir = GetConfigOutputDir(output_dir);
+  args->shell_script =
       GetBuildScript(target->label(), options_.ninja_executable,
-                     GetConfigOutputDir("."), env));
+                     GetConfigOutputDir("."), env);
+  return true;
 }
 
-PBXNativeTarget* XcodeProject::AddBundleTarget(const Target* target,
-                                               base::Environment* env,
-                                               Err* err) {
+void XcodeProject::GetBundleTargetArgs(const Target* target,
+                                       base::Environment* env,
+                                       NativeTargetArgs* args) const {
   DCHECK_EQ(target->output_type(), Target::CREATE_BUNDLE);
 
   std::string pbxtarget_name = target->label().name();
@@ -1040,15 +1189,18 @@ PBXNativeTarget* XcodeProject::AddBundleTarget(const Target* target,
       RebasePath(target->bundle_data().GetBundleDir(target->settings()).value(),
                  build_settings_->build_dir());
 
-  return project_.AddNativeTarget(
-      pbxtarget_name, std::string(), target_output_name,
-      target->bundle_data().product_type(), GetConfigOutputDir(output_dir),
+  args->name = pbxtarget_name;
+  args->output_name = target_output_name;
+  args->output_type = target->bundle_data().product_type();
+  args->output_dir = GetConfigOutputDir(output_dir);
+  args->shell_script =
       GetBuildScript(target->label(), options_.ninja_executable,
-                     GetConfigOutputDir("."), env),
-      xcode_extra_attributes);
+                     GetConfigOutputDir("."), env);
+  args->extra_attributes = std::move(xcode_extra_attributes);
 }
 
-std::string XcodeProject::GetConfigOutputDir(std::string_view output_dir) {
+std::string XcodeProject::GetConfigOutputDir(
+    std::string_view output_dir) const {
   if (options_.configuration_build_dir.empty())
     return std::string(output_dir);
 
@@ -1062,7 +1214,7 @@ std::string XcodeProject::GetConfigOutputDir(std::string_view output_dir) {
                     build_settings_->root_path_utf8());
 }
 
-void XcodeProject::WriteFileContent(std::ostream& out) const {
+void XcodeProject::WriteFileContent(StringOutputBuffer& out) const {
   out << "// !$*UTF8*$!\n"
       << "{\n"
       << "\tarchiveVersion = 1;\n"
@@ -1077,9 +1229,7 @@ void XcodeProject::WriteFileContent(std::ostream& out) const {
               [](const PBXObject* a, const PBXObject* b) {
                 return a->id() < b->id();
               });
-    for (auto* object : pair.second) {
-      object->Print(out, 2);
-    }
+    PrintObjects(pair.second, out);
     out << "/* End " << ToString(pair.first) << " section */\n";
   }
 
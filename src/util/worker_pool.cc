@@ -7,6 +7,7 @@
 #include "base/command_line.h"
 #include "base/strings/string_number_conversions.h"
 #include "gn/switches.h"
+#include "util/build_config.h"
 #include "util/sys_info.h"
 
 namespace {
@@ -41,12 +42,25 @@ int GetThreadCount() {
   return std::max(num_cores - 1, 8);
 }
 
+// The pool whose Worker() the current thread is running, if any.
+#if !defined(OS_ZOS)
+thread_local WorkerPool* g_current_pool = nullptr;
+#else
+// TODO(gabylb) - zos: thread_local not yet supported, use zoslib's impl'n:
+__tlssim<WorkerPool*> __g_current_pool_impl(nullptr);
+#define g_current_pool (*__g_current_pool_impl.access())
+#endif
+
 }  // namespace
 
 WorkerPool::WorkerPool() : WorkerPool(GetThreadCount()) {}
 
-WorkerPool::WorkerPool(size_t thread_count) : should_stop_processing_(false) {
-  threads_.reserve(thread_count);
+WorkerPool::WorkerPool(size_t thread_count)
+    : thread_count_(thread_count),
+      running_thread_count_(thread_count),
+      should_stop_processing_(false) {
+  // Leave room for the extra threads of ScopedBlockingWait.
+  threads_.reserve(thread_count * 2);
   for (size_t i = 0; i < thread_count; ++i)
     threads_.emplace_back([this]() { Worker(); });
 }
@@ -58,12 +72,28 @@ WorkerPool::~WorkerPool() {
   }
 
   pool_notifier_.notify_all();
+  parked_notifier_.notify_all();
 
-  for (auto& task_thread : threads_) {
-    task_thread.join();
+  // Tasks still running may add threads until they see the pool stopping.
+  for (size_t i = 0;; ++i) {
+    std::thread* task_thread;
+    {
+      std::unique_lock<std::mutex> queue_lock(queue_mutex_);
+      if (i == threads_.size())
+        break;
+      task_thread = &threads_[i];
+    }
+    task_thread->join();
   }
 }
 
+// static
+WorkerPool& WorkerPool::GetShared() {
+  // Never destroyed: its threads are left waiting for tasks at exit.
+  static WorkerPool* shared_pool = new WorkerPool;
+  return *shared_pool;
+}
+
 void WorkerPool::PostTask(std::function<void()> work) {
   {
     std::unique_lock<std::mutex> queue_lock(queue_mutex_);
@@ -74,13 +104,91 @@ void WorkerPool::PostTask(std::function<void()> work) {
   pool_notifier_.notify_one();
 }
 
+void WorkerPool::ParallelFor(size_t count,
+                             const std::function<void(size_t)>& work) {
+  if (g_current_pool == this) {
+    for (size_t i = 0; i < count; ++i)
+      work(i);
+    return;
+  }
+
+  std::mutex done_mutex;
+  std::condition_variable done_cv;
+  size_t remaining = count;
+
+  for (size_t i = 0; i < count; ++i) {
+    PostTask([&work, &done_mutex, &done_cv, &remaining, i]() {
+      work(i);
+      // Notify while holding the lock so that the waiting thread can't
+      // destroy |done_cv| before this returns.
+      std::lock_guard<std::mutex> lock(done_mutex);
+      if (--remaining == 0)
+        done_cv.notify_one();
+    });
+  }
+
+  std::unique_lock<std::mutex> lock(done_mutex);
+  done_cv.wait(lock, [&remaining]() { return remaining == 0; });
+}
+
+WorkerPool::ScopedBlockingWait::ScopedBlockingWait()
+    : pool_(g_current_pool) {
+  if (pool_)
+    pool_->BeginBlockingWait();
+}
+
+WorkerPool::ScopedBlockingWait::~ScopedBlockingWait() {
+  if (pool_)
+    pool_->EndBlockingWait();
+}
+
+void WorkerPool::BeginBlockingWait() {
+  std::unique_lock<std::mutex> queue_lock(queue_mutex_);
+  running_thread_count_--;
+  if (should_stop_processing_ || running_thread_count_ >= thread_count_)
+    return;
+
+  // Take the place of the waiting thread with a parked thread, or a new one.
+  if (parked_thread_count_ > pending_unpark_count_) {
+    pending_unpark_count_++;
+    running_thread_count_++;
+    parked_notifier_.notify_one();
+  } else if (threads_.size() < threads_.capacity()) {
+    running_thread_count_++;
+    threads_.emplace_back([this]() { Worker(); });
+  }
+}
+
+void WorkerPool::EndBlockingWait() {
+  std::unique_lock<std::mutex> queue_lock(queue_mutex_);
+  // The thread that ended up above the count parks before its next task.
+  running_thread_count_++;
+}
+
 void WorkerPool::Worker() {
+  g_current_pool = this;
   for (;;) {
     std::function<void()> task;
 
     {
       std::unique_lock<std::mutex> queue_lock(queue_mutex_);
 
+      if (running_thread_count_ > thread_count_ && !should_stop_processing_) {
+        running_thread_count_--;
+        parked_thread_count_++;
+        // This thread may have been woken up for a task it won't run.
+        if (!task_queue_.empty())
+          pool_notifier_.notify_one();
+        parked_notifier_.wait(queue_lock, [this]() {
+          return pending_unpark_count_ > 0 || should_stop_processing_;
+        });
+        parked_thread_count_--;
+        if (pending_unpark_count_ > 0)
+          pending_unpark_count_--;
+        else
+          running_thread_count_++;  // Stopping.
+      }
+
       pool_notifier_.wait(queue_lock, [this]() {
         return (!task_queue_.empty()) || should_stop_processing_;
       });
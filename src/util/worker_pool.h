@@ -19,12 +19,65 @@ class WorkerPool {
   WorkerPool(size_t thread_count);
   ~WorkerPool();
 
+  // Returns the pool shared by the whole process, created on first use with
+  // the default number of threads. The scheduler runs its work on it, and
+  // the parallel loops of the writers and commands use it rather than
+  // starting threads of their own.
+  static WorkerPool& GetShared();
+
   void PostTask(std::function<void()> work);
 
+  // Runs |work| once for each index in [0, count) on the pool's threads and
+  // blocks until every invocation has returned. When called from one of this
+  // pool's own threads, |work| runs serially on that thread instead, since
+  // waiting for the other threads could deadlock.
+  void ParallelFor(size_t count, const std::function<void(size_t)>& work);
+
+  // Declares that the current thread is about to wait for something other
+  // than the CPU, such as a child process, for the lifetime of the object.
+  // If the thread is one of a pool's threads, the pool lets an extra thread
+  // run tasks meanwhile, so that as many threads as it was created with keep
+  // running tasks. Once the wait ends, a thread parks before taking its next
+  // task until the number of threads running tasks is back to that count.
+  // Parked threads are reused by later waits, and the pool starts at most as
+  // many extra threads as it was created with.
+  class ScopedBlockingWait {
+   public:
+    ScopedBlockingWait();
+    ~ScopedBlockingWait();
+
+   private:
+    // Null if the current thread isn't a pool thread.
+    WorkerPool* pool_;
+
+    ScopedBlockingWait(const ScopedBlockingWait&) = delete;
+    ScopedBlockingWait& operator=(const ScopedBlockingWait&) = delete;
+  };
+
  private:
   void Worker();
 
+  void BeginBlockingWait();
+  void EndBlockingWait();
+
+  // Number of threads that should be running tasks.
+  const size_t thread_count_;
+
+  // The following are protected by |queue_mutex_|.
+
+  // It never grows beyond its initial capacity, so that the destructor can
+  // join the threads while others are added.
   std::vector<std::thread> threads_;
+
+  // Threads which are neither in a blocking wait nor parked.
+  size_t running_thread_count_;
+
+  // Threads parked because too many threads were running, and how many of
+  // them were asked to run again but haven't woken up yet.
+  size_t parked_thread_count_ = 0;
+  size_t pending_unpark_count_ = 0;
+  std::condition_variable_any parked_notifier_;
+
   std::queue<std::function<void()>> task_queue_;
   std::mutex queue_mutex_;
   std::condition_variable_any pool_notifier_;
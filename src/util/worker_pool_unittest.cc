@@ -0,0 +1,124 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "util/worker_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "util/test/test.h"
+
+TEST(WorkerPool, ParallelFor) {
+  WorkerPool pool(4);
+
+  // Every index is visited exactly once and all writes are visible once
+  // ParallelFor returns.
+  std::vector<int> visited(1000, 0);
+  std::atomic<int> calls = 0;
+  pool.ParallelFor(visited.size(), [&visited, &calls](size_t i) {
+    visited[i]++;
+    calls++;
+  });
+  EXPECT_EQ(1000, calls);
+  for (int count : visited)
+    EXPECT_EQ(1, count);
+
+  // An empty range returns immediately without running anything.
+  calls = 0;
+  pool.ParallelFor(0, [&calls](size_t) { calls++; });
+  EXPECT_EQ(0, calls);
+}
+
+TEST(WorkerPool, NestedParallelFor) {
+  WorkerPool pool(1);
+
+  // The inner loop runs on the pool's only thread instead of waiting for it.
+  std::atomic<int> calls = 0;
+  pool.ParallelFor(2, [&pool, &calls](size_t) {
+    pool.ParallelFor(3, [&calls](size_t) { calls++; });
+  });
+  EXPECT_EQ(6, calls);
+}
+
+TEST(WorkerPool, GetShared) {
+  EXPECT_EQ(&WorkerPool::GetShared(), &WorkerPool::GetShared());
+
+  std::atomic<int> calls = 0;
+  WorkerPool::GetShared().ParallelFor(10, [&calls](size_t) { calls++; });
+  EXPECT_EQ(10, calls);
+}
+
+TEST(WorkerPool, ScopedBlockingWait) {
+  WorkerPool pool(1);
+
+  // The only thread of the pool waits for a task posted after it. That task
+  // can only run on the extra thread started for the wait.
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool second_done = false;
+  bool first_done = false;
+  pool.PostTask([&]() {
+    WorkerPool::ScopedBlockingWait blocking_wait;
+    pool.PostTask([&]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      second_done = true;
+      cv.notify_all();
+    });
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() { return second_done; });
+    first_done = true;
+    cv.notify_all();
+  });
+
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&]() { return first_done; });
+
+  // Waiting outside of a pool thread does nothing.
+  WorkerPool::ScopedBlockingWait blocking_wait;
+}
+
+TEST(WorkerPool, ScopedBlockingWaitEnds) {
+  WorkerPool pool(1);
+
+  // Blocks a pool thread until another task runs, twice, so that the second
+  // wait reuses the thread started by the first.
+  for (int i = 0; i < 2; ++i) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool second_done = false;
+    bool first_done = false;
+    pool.PostTask([&]() {
+      WorkerPool::ScopedBlockingWait blocking_wait;
+      pool.PostTask([&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        second_done = true;
+        cv.notify_all();
+      });
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&]() { return second_done; });
+      first_done = true;
+      cv.notify_all();
+    });
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() { return first_done; });
+  }
+
+  // Once the waits are over, only one task runs at a time again.
+  std::atomic<int> running = 0;
+  std::atomic<int> max_running = 0;
+  pool.ParallelFor(20, [&running, &max_running](size_t) {
+    int now = ++running;
+    int max = max_running;
+    while (now > max && !max_running.compare_exchange_weak(max, now)) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    running--;
+  });
+  EXPECT_EQ(1, max_running);
+}